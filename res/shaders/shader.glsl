@@ -1,15 +1,51 @@
 #shader vertex
 #version 330 core
 
-layout(location = 0) in vec4 position;
+layout(location = 0) in vec2 position;
 layout(location = 1) in vec4 a_color;
 
 out vec4 v_color;
-uniform mat4 u_MVP;
+
+//per-frame constants shared by every program (FrameConstants.h), bound to FRAME_CONSTANTS_BINDING
+layout(std140) uniform FrameConstants{
+   mat4 u_MVP;
+   //x = seconds, y = frame delta, z = interpolation alpha, w = frame
+   vec4 u_Time;
+   //x/y = left/right peak level, z/w = left/right meter fill
+   vec4 u_Levels;
+   vec4 u_BackgroundColor;
+   vec4 u_TextColor;
+   vec4 u_ButtonColor;
+   vec4 u_PlayButtonColor;
+   //x = theme index of the bar palettes
+   vec4 u_Theme;
+   //design units to pixels per layout anchor: xy = scale, zw = offset
+   vec4 u_Anchors[3];
+};
+
+//LayoutAnchor of the drawn geometry, 0 (graphs) unless the program sets it
+uniform int u_Anchor;
+
+//baked theme palettes (ColorThemes::PackPalettes): entry = phase, row = 2 * theme + palette, on PALETTE_TEXTURE_UNIT
+uniform sampler2D u_Palettes;
 
 void main(){
-   v_color = a_color;
-   gl_Position = u_MVP * position;
+   //zero alpha marks a palette color (Vertex.h): r/g = phase, b = palette + 2 * (theme + 1)
+   if(a_color.a == 0.0){
+      vec3 bytes = floor(a_color.rgb * 255.0 + 0.5);
+      float phase = bytes.r + 256.0 * bytes.g;
+      int palette = int(mod(bytes.b, 2.0));
+      int theme = int(bytes.b) / 2 - 1;
+      if(theme < 0) theme = int(u_Theme.x);
+      v_color = texelFetch(u_Palettes, ivec2(int(phase), 2 * theme + palette), 0);
+   }
+   else{
+      v_color = a_color;
+   }
+   //positions are authored in design units, resizing only changes the anchor transform
+   vec4 anchor = u_Anchors[u_Anchor];
+   //z and w are constant for every vertex, so only xy is uploaded
+   gl_Position = u_MVP * vec4(position * anchor.xy + anchor.zw, 1.0, 1.0);
 }
 
 #shader fragment
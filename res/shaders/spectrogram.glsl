@@ -0,0 +1,52 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 position;
+//rg = texture coordinates of the quad corner, ba unused
+layout(location = 1) in vec4 a_color;
+
+out vec2 v_uv;
+
+//per-frame constants shared by every program (FrameConstants.h), bound to FRAME_CONSTANTS_BINDING
+layout(std140) uniform FrameConstants{
+   mat4 u_MVP;
+   vec4 u_Time;
+   vec4 u_Levels;
+   vec4 u_BackgroundColor;
+   vec4 u_TextColor;
+   vec4 u_ButtonColor;
+   vec4 u_PlayButtonColor;
+   vec4 u_Theme;
+   //design units to pixels per layout anchor: xy = scale, zw = offset
+   vec4 u_Anchors[3];
+};
+
+void main(){
+   v_uv = a_color.rg;
+   //the spectrogram sits with the graphs (LAYOUT_ANCHOR_GRAPHS)
+   vec4 anchor = u_Anchors[0];
+   gl_Position = u_MVP * vec4(position * anchor.xy + anchor.zw, 1.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_uv;
+
+//ring of hop rows (Spectrogram.h) on SPECTROGRAM_TEXTURE_UNIT, levels 0-1 per fft bin
+uniform sampler2D u_History;
+//level to color, COLORMAP_SIZE x 1 on COLORMAP_TEXTURE_UNIT
+uniform sampler2D u_Colormap;
+//x = row of the newest hop, y = rows shown, z = rows in the ring, w = lowest shown frequency / Nyquist frequency
+uniform vec4 u_View;
+
+void main(){
+   //time runs left to right with the newest hop at the right edge, rows before 0 wrap to the end of the ring
+   float row = floor(u_View.x - (1.0 - v_uv.x) * (u_View.y - 1.0) + 0.5);
+   //frequency upwards on a log scale, the bins are linear in frequency up to Nyquist
+   float bin = u_View.w * pow(1.0 / u_View.w, v_uv.y);
+   float level = texture(u_History, vec2(bin, (row + 0.5) / u_View.z)).r;
+   color = texture(u_Colormap, vec2(level, 0.5));
+}
@@ -0,0 +1,128 @@
+#include "AnalysisEngine.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "AuxComputations.h"
+#include "BarGraph.h"
+
+float smoothMeterLevel(float prevLevel, float dB){
+    return AuxComputations::expSmooth(prevLevel, std::min(std::max((dB + 60.0f) / 60.0f, 0.01f), 1.0f), 0.93f);
+}
+
+AnalysisEngine::AnalysisEngine()
+    : m_HopSamples(ANALYSIS_HOP_SAMPLES, 0.0f), m_HopFill(0), m_Pool(nullptr), m_TaskWindow(nullptr), m_SpectraPending(0){
+    reset();
+}
+
+AnalysisEngine::~AnalysisEngine(){
+
+}
+
+void AnalysisEngine::reset(const float* leftFreqHeights, const float* rightFreqHeights){
+    m_HopFill = 0;
+    m_PrevLeftLevel = 0.0f;
+    m_PrevRightLevel = 0.0f;
+    //meters start full and fall to the signal level, like the freshly drawn meter
+    m_PrevLeftMeter = 1.0f;
+    m_PrevRightMeter = 1.0f;
+    std::memset(&m_Result, 0, sizeof(m_Result));
+    //the drawn bars are where the smoothing continues from
+    if(leftFreqHeights != nullptr && rightFreqHeights != nullptr){
+        std::memcpy(m_Result.leftFreqHeights, leftFreqHeights, sizeof(m_Result.leftFreqHeights));
+        std::memcpy(m_Result.rightFreqHeights, rightFreqHeights, sizeof(m_Result.rightFreqHeights));
+    }
+    m_Result.leftMeter = 1.0f;
+    m_Result.rightMeter = 1.0f;
+}
+
+void AnalysisEngine::setThreadPool(ThreadPool* pool){
+    m_Pool = pool;
+}
+
+void AnalysisEngine::RunHopStage(void* context, size_t index){
+    AnalysisEngine* engine = (AnalysisEngine*) context;
+    if(index == 0){
+        engine->m_Analyzer.computePeak(engine->m_TaskWindow, ANALYSIS_WINDOW_SAMPLES, engine->m_Hop);
+        return;
+    }
+    engine->m_Analyzer.computeSpectrum(engine->m_TaskWindow, ANALYSIS_WINDOW_SAMPLES, (int)index - 1);
+    //both spectra are needed by every bar range
+    if(engine->m_SpectraPending.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        engine->m_Pool->run(engine->m_Group, RunTargetRange, engine, ANALYSIS_TARGET_TASKS);
+    }
+}
+
+void AnalysisEngine::RunTargetRange(void* context, size_t index){
+    AnalysisEngine* engine = (AnalysisEngine*) context;
+    engine->m_Analyzer.computeTargets(engine->m_Hop, (int)(index * NUM_GRAPH_SAMPLES / ANALYSIS_TARGET_TASKS), 
+        (int)((index + 1) * NUM_GRAPH_SAMPLES / ANALYSIS_TARGET_TASKS));
+    //the spectrogram row needs both spectra as well, each range task takes the same share of its bins
+    engine->m_Analyzer.computeSpectrogram(engine->m_Hop, (int)(index * SPECTROGRAM_BINS / ANALYSIS_TARGET_TASKS), 
+        (int)((index + 1) * SPECTROGRAM_BINS / ANALYSIS_TARGET_TASKS));
+}
+
+void AnalysisEngine::analyzeHop(const float* hopSamples){
+    //only the most recent part of each hop is analyzed
+    const float* window = hopSamples + ANALYSIS_HOP_SAMPLES - ANALYSIS_WINDOW_SAMPLES;
+    if(m_Pool == nullptr){
+        m_Analyzer.compute(window, ANALYSIS_WINDOW_SAMPLES, m_Hop);
+    }
+    else{
+        m_TaskWindow = window;
+        m_SpectraPending.store(2, std::memory_order_relaxed);
+        m_Pool->run(m_Group, RunHopStage, this, 3);
+        m_Pool->wait(m_Group);
+    }
+    //smoothing depends on the previous hop, it stays on the calling thread
+    apply(m_Hop);
+}
+
+const FrameResult& AnalysisEngine::process(const float* samples, size_t frames){
+    size_t hops = 0;
+    size_t remaining = 2 * frames;
+    while(remaining > 0){
+        if(m_HopFill == 0 && remaining >= ANALYSIS_HOP_SAMPLES){
+            //whole hop available in the input, analyze it in place
+            analyzeHop(samples);
+            samples += ANALYSIS_HOP_SAMPLES;
+            remaining -= ANALYSIS_HOP_SAMPLES;
+            hops++;
+            continue;
+        }
+        const size_t count = std::min(remaining, ANALYSIS_HOP_SAMPLES - m_HopFill);
+        std::memcpy(m_HopSamples.data() + m_HopFill, samples, count * sizeof(float));
+        m_HopFill += count;
+        samples += count;
+        remaining -= count;
+        if(m_HopFill == ANALYSIS_HOP_SAMPLES){
+            analyzeHop(m_HopSamples.data());
+            m_HopFill = 0;
+            hops++;
+        }
+    }
+    m_Result.hops = hops;
+    return m_Result;
+}
+
+const FrameResult& AnalysisEngine::apply(const HopAnalysis& hop){
+    m_Result.leftLevel = AuxComputations::expSmooth(m_PrevLeftLevel, hop.leftPeak, 0.3f);
+    m_Result.rightLevel = AuxComputations::expSmooth(m_PrevRightLevel, hop.rightPeak, 0.3f);
+    m_PrevLeftLevel = m_Result.leftLevel;
+    m_PrevRightLevel = m_Result.rightLevel;
+
+    AuxComputations::computeDecibelLevels(m_Result.leftLevel, m_Result.rightLevel, m_Result.leftDB, m_Result.rightDB);
+    m_Result.leftMeter = smoothMeterLevel(m_PrevLeftMeter, m_Result.leftDB);
+    m_Result.rightMeter = smoothMeterLevel(m_PrevRightMeter, m_Result.rightDB);
+    m_PrevLeftMeter = m_Result.leftMeter;
+    m_PrevRightMeter = m_Result.rightMeter;
+
+    //frequency bars are smoothed from the drawn bars towards this hop's spectrum (one FFT per hop)
+    smoothBarHeights(NUM_GRAPH_SAMPLES, hop.leftFreqTargets, hop.rightFreqTargets, 0.85f, 2.0f, 
+        m_Result.leftFreqHeights, m_Result.rightFreqHeights);
+    std::memcpy(m_Result.spectrum, hop.spectrum, sizeof(m_Result.spectrum));
+
+    m_Result.hops = 1;
+    m_Result.hopIndex++;
+    return m_Result;
+}
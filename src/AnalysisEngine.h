@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "VisualizerConfig.h"
+#include "HopAnalyzer.h"
+#include "ThreadPool.h"
+
+//bar ranges the frequency targets are split into when a hop runs as a task graph
+#define ANALYSIS_TARGET_TASKS 8
+
+//everything the graphs show after one analysis hop, already smoothed
+typedef struct{
+    //hops completed by the last process() call, the other fields describe the last of them
+    size_t hops;
+    //hops completed since construction or reset()
+    unsigned long long hopIndex;
+    //smoothed peak amplitude (0-1), one amplitude graph bar per hop
+    float leftLevel;
+    float rightLevel;
+    //level of the smoothed peaks in dBFS
+    float leftDB;
+    float rightDB;
+    //smoothed decibel meter fill (0.01-1)
+    float leftMeter;
+    float rightMeter;
+    //drawn frequency bar extents above/below the center line
+    float leftFreqHeights[NUM_GRAPH_SAMPLES];
+    float rightFreqHeights[NUM_GRAPH_SAMPLES];
+    //spectrogram row of the last hop (HopAnalysis::spectrum), not smoothed
+    float spectrum[SPECTROGRAM_BINS];
+} FrameResult;
+
+//maps a dBFS value to the meter range and smooths it against the previous meter fill
+float smoothMeterLevel(float prevLevel, float dB);
+
+//complete analysis of one stereo stream: hop framing, peak, FFT and the smoothing that feeds the graphs
+//has no window, GL or audio device dependency, so any number of instances can run side by side
+//construct on the main thread (fftw planning is not thread-safe); an instance is used by one thread at a time
+//all buffers are allocated in the constructor, process() and apply() never allocate
+class AnalysisEngine{
+    private:
+        HopAnalyzer m_Analyzer;
+        HopAnalysis m_Hop;
+        //interleaved samples of a partially received hop
+        std::vector<float> m_HopSamples;
+        size_t m_HopFill;
+
+        float m_PrevLeftLevel;
+        float m_PrevRightLevel;
+        float m_PrevLeftMeter;
+        float m_PrevRightMeter;
+        FrameResult m_Result;
+
+        //task graph: peak, left spectrum and right spectrum in parallel, the last spectrum to finish
+        //starts the frequency target ranges; nullptr runs every stage on the calling thread
+        ThreadPool* m_Pool;
+        TaskGroup m_Group;
+        const float* m_TaskWindow;
+        std::atomic<int> m_SpectraPending;
+
+        void analyzeHop(const float* hopSamples);
+        static void RunHopStage(void* context, size_t index);
+        static void RunTargetRange(void* context, size_t index);
+
+    public:
+        AnalysisEngine();
+        ~AnalysisEngine();
+
+        //consumes frames of interleaved stereo audio (AUDIO_SAMPLE_RATE), analyzing every completed hop of 
+        //ANALYSIS_HOP_SAMPLES; partial hops are kept for the next call
+        //the result describes the last completed hop (result.hops == 0 if none completed), callers that
+        //need every hop (e.g. the amplitude graph) should pass at most one hop per call
+        const FrameResult& process(const float* samples, size_t frames);
+        //smooths a hop analyzed elsewhere (e.g. by a worker thread), hops must be applied in playback order
+        const FrameResult& apply(const HopAnalysis& hop);
+        //runs the analysis of every hop as a task graph on pool (nullptr = single-threaded)
+        //the calling thread helps with the tasks and process() returns once the hop is joined
+        void setThreadPool(ThreadPool* pool);
+        //forgets the smoothing state and any partial hop (e.g. when a new track is loaded)
+        //the frequency bars start from the given extents if set (e.g. the idle shape of a freshly generated graph)
+        void reset(const float* leftFreqHeights = nullptr, const float* rightFreqHeights = nullptr);
+
+        inline const FrameResult& getResult() const { return m_Result; }
+};
@@ -0,0 +1,119 @@
+#include "AnalysisPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "AuxComputations.h"
+#include "Profiler.h"
+#include "Tracer.h"
+
+//how long the analysis thread sleeps when less than a hop is buffered (a hop lasts ~17 ms)
+#define PIPELINE_IDLE_MICROSECONDS 1000
+
+AnalysisPipeline::AnalysisPipeline(AnalysisEngine& engine, size_t maxBacklogHops)
+    : m_Engine(engine), m_MaxBacklogHops(maxBacklogHops), m_Ring(nullptr), m_Running(false),
+    m_Published(0), m_Released(0), m_HopSamples(ANALYSIS_HOP_SAMPLES, 0.0f){
+    m_Pending.hops = 0;
+    m_Pending.droppedHops = 0;
+    m_Pending.backlogSamples = 0;
+}
+
+AnalysisPipeline::~AnalysisPipeline(){
+    stop();
+}
+
+void AnalysisPipeline::start(RingBuffer<float>& ring){
+    stop();
+    m_Ring = &ring;
+    m_Published.store(0, std::memory_order_relaxed);
+    m_Released.store(0, std::memory_order_relaxed);
+    m_Pending.hops = 0;
+    m_Pending.droppedHops = 0;
+    m_Pending.backlogSamples = 0;
+    m_Running.store(true, std::memory_order_release);
+    m_Thread = std::thread(&AnalysisPipeline::run, this);
+}
+
+void AnalysisPipeline::stop(){
+    m_Running.store(false, std::memory_order_release);
+    if(m_Thread.joinable()) m_Thread.join();
+    m_Ring = nullptr;
+}
+
+void AnalysisPipeline::run(){
+    TRACE_THREAD_NAME("analysis pipeline");
+    while(m_Running.load(std::memory_order_acquire)){
+        size_t hopsReady = m_Ring->getSize() / ANALYSIS_HOP_SAMPLES;
+        //the render thread falling behind does not stall analysis, only the audio clock does
+        if(hopsReady > m_MaxBacklogHops){
+            const size_t hopsToDrop = hopsReady - m_MaxBacklogHops;
+            for(size_t i = 0; i < hopsToDrop * ANALYSIS_HOP_SAMPLES; i++){
+                float temp;
+                m_Ring->pop(temp);
+            }
+            m_Pending.droppedHops += hopsToDrop;
+            hopsReady = m_MaxBacklogHops;
+        }
+        for(size_t hop = 0; hop < hopsReady; hop++){
+            TRACE_SCOPE("analysis hop");
+            {
+                PROFILE_SCOPE(PROFILE_RING_DRAIN);
+                const size_t filled = AuxComputations::fillArrayWithSamples(*m_Ring, m_HopSamples, ANALYSIS_HOP_SAMPLES);
+                //m_HopSamples outlives the hop, an underrun must not replay the previous hop's tail
+                std::fill(m_HopSamples.begin() + filled, m_HopSamples.begin() + ANALYSIS_HOP_SAMPLES, 0.0f);
+            }
+            //one hop per call so every hop reaches the amplitude graph
+            addHop(m_Engine.process(m_HopSamples.data(), ANALYSIS_HOP_SAMPLES / 2));
+        }
+        if(hopsReady > 0) m_Pending.backlogSamples = m_Ring->getSize();
+        publish();
+        if(hopsReady == 0){
+            std::this_thread::sleep_for(std::chrono::microseconds(PIPELINE_IDLE_MICROSECONDS));
+        }
+    }
+}
+
+void AnalysisPipeline::addHop(const FrameResult& result){
+    if(result.hops == 0) return;
+    if(m_Pending.hops == PIPELINE_MAX_HOPS){
+        //render thread stalled for a long time, keep the newest levels
+        std::memmove(m_Pending.leftLevels, m_Pending.leftLevels + 1, (PIPELINE_MAX_HOPS - 1) * sizeof(float));
+        std::memmove(m_Pending.rightLevels, m_Pending.rightLevels + 1, (PIPELINE_MAX_HOPS - 1) * sizeof(float));
+        std::memmove(m_Pending.spectra[0], m_Pending.spectra[1], (PIPELINE_MAX_HOPS - 1) * sizeof(m_Pending.spectra[0]));
+        m_Pending.hops--;
+        m_Pending.droppedHops++;
+    }
+    m_Pending.leftLevels[m_Pending.hops] = result.leftLevel;
+    m_Pending.rightLevels[m_Pending.hops] = result.rightLevel;
+    std::memcpy(m_Pending.spectra[m_Pending.hops], result.spectrum, sizeof(result.spectrum));
+    m_Pending.hops++;
+}
+
+void AnalysisPipeline::publish(){
+    if(m_Pending.hops == 0 && m_Pending.droppedHops == 0) return;
+    const unsigned long long published = m_Published.load(std::memory_order_relaxed);
+    //acquire: the render thread is done reading the buffer it gave back
+    if(published - m_Released.load(std::memory_order_acquire) >= 2) return;
+    PipelineFrame& frame = m_Frames[published % 2];
+    frame.hops = m_Pending.hops;
+    std::memcpy(frame.leftLevels, m_Pending.leftLevels, m_Pending.hops * sizeof(float));
+    std::memcpy(frame.rightLevels, m_Pending.rightLevels, m_Pending.hops * sizeof(float));
+    std::memcpy(frame.spectra, m_Pending.spectra, m_Pending.hops * sizeof(m_Pending.spectra[0]));
+    frame.droppedHops = m_Pending.droppedHops;
+    frame.backlogSamples = m_Pending.backlogSamples;
+    frame.result = m_Engine.getResult();
+    m_Published.store(published + 1, std::memory_order_release);
+    m_Pending.hops = 0;
+    m_Pending.droppedHops = 0;
+}
+
+const PipelineFrame* AnalysisPipeline::acquire(){
+    const unsigned long long released = m_Released.load(std::memory_order_relaxed);
+    if(m_Published.load(std::memory_order_acquire) == released) return nullptr;
+    return &m_Frames[released % 2];
+}
+
+void AnalysisPipeline::release(){
+    m_Released.store(m_Released.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AnalysisEngine.h"
+#include "RingBuffer.hpp"
+
+//amplitude levels one pipeline frame can carry, older hops are dropped if the render thread stalls longer
+#define PIPELINE_MAX_HOPS 16
+
+//every hop the analysis thread finished since the previous frame was handed to the render thread
+typedef struct{
+    //hops analyzed for this frame, the levels hold one amplitude graph bar per hop (oldest first)
+    size_t hops;
+    float leftLevels[PIPELINE_MAX_HOPS];
+    float rightLevels[PIPELINE_MAX_HOPS];
+    //spectrogram row of each hop (oldest first)
+    float spectra[PIPELINE_MAX_HOPS][SPECTROGRAM_BINS];
+    //hops skipped to bound latency (or whose levels no longer fit) since the previous frame
+    size_t droppedHops;
+    //interleaved samples left in the audio buffer after the last hop
+    size_t backlogSamples;
+    //meters and frequency bars after the last hop
+    FrameResult result;
+} PipelineFrame;
+
+//runs an AnalysisEngine on its own thread so analysis of the next frame overlaps drawing of the current one
+//frames are handed over through two buffers without locks: the analysis thread fills one while the render
+//thread reads the other; hops that finish while both buffers are taken are collected into the next frame
+//throughput approaches max(analysis, render) at the cost of one frame of latency
+class AnalysisPipeline{
+    private:
+        AnalysisEngine& m_Engine;
+        size_t m_MaxBacklogHops;
+        RingBuffer<float>* m_Ring;
+        std::thread m_Thread;
+        std::atomic<bool> m_Running;
+
+        PipelineFrame m_Frames[2];
+        //frames handed over / given back by the render thread, frame n lives in m_Frames[n % 2]
+        std::atomic<unsigned long long> m_Published;
+        std::atomic<unsigned long long> m_Released;
+        //hops finished while both buffers were taken, owned by the analysis thread
+        PipelineFrame m_Pending;
+        std::vector<float> m_HopSamples;
+
+        void run();
+        void addHop(const FrameResult& result);
+        //copies the pending hops into a free buffer and hands it over, keeps them pending if none is free
+        void publish();
+
+    public:
+        //maxBacklogHops: whole hops allowed to queue up in the audio buffer before old audio is skipped
+        AnalysisPipeline(AnalysisEngine& engine, size_t maxBacklogHops);
+        ~AnalysisPipeline();
+
+        //starts draining ring on the analysis thread, the engine must not be used elsewhere until stop()
+        void start(RingBuffer<float>& ring);
+        //joins the analysis thread, frames that were not acquired yet are discarded
+        void stop();
+
+        //render thread: oldest frame not consumed yet (nullptr if there is none), call release() once it is applied
+        const PipelineFrame* acquire();
+        void release();
+
+        inline bool isRunning() const { return m_Running.load(std::memory_order_relaxed); }
+};
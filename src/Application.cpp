@@ -1,22 +1,42 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <fftw3.h>
 
 #include <iostream>
+#include <algorithm>
+#include <cctype>
 #include <cmath>
-#include <deque>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
 #include <vector>
-#include <numeric>
 
 #include "ErrorHandler.h"
+#include "GLStateCache.h"
 #include "Renderer.h"
 #include "Shader.h"
+#include "ShaderManager.h"
+#include "UniformBuffer.h"
 #include "ImgTexture.h"
 #include "SampleLine.h"
 #include "AudioPlayer.h"
 #include "AuxComputations.h"
 #include "MappedDrawObj.h"
 #include "ColorThemes.h"
+#include "FrameScheduler.h"
+#include "AnalysisEngine.h"
+#include "AnalysisPipeline.h"
+#include "ThreadPool.h"
+#include "Visualizer.h"
+#include "VisualizerConfig.h"
+#include "Headless.h"
+#include "MultiStream.h"
+#include "FrameCapture.h"
+#include "Profiler.h"
+#include "FrameArena.h"
+#include "Layout.h"
+#include "Spectrogram.h"
+#include "Tracer.h"
 
 #include "vendor/glm/glm.hpp"
 #include "vendor/glm/gtc/matrix_transform.hpp"
@@ -25,33 +45,8 @@
 #include "vendor/imgui/imgui_impl_opengl3.h"
 #include "vendor/portable-file-dialogs/portable-file-dialogs.h"
  
-#define WINDOW_WIDTH 1080.0f
-#define WINDOW_HEIGHT 720.0f
-#define SAMPLE_WIDTH 2
-#define SAMPLE_MARGIN 1
-#define NUM_FFT_SAMPLES 4096
-//256 regular amplitude samples
-#define NUM_GRAPH_SAMPLES 256
-#define WINDOW_MARGIN (((int)WINDOW_WIDTH - NUM_GRAPH_SAMPLES*(SAMPLE_WIDTH + 2*SAMPLE_MARGIN)) / 2)
-//3 values (xyz)
-#define NUM_POSITION_POINTS 3
-//2 triangles, 3 indices each
-#define NUM_INDEX_POINTS (2*3)
-//4 color components (rgba)
-#define NUM_COLOR_POINTS 4
-//4 position points, 4 color points, 1 SampleLine object
-#define NUM_TOTAL_VERTEX_POINTS (4*NUM_POSITION_POINTS + 4*NUM_COLOR_POINTS)
-#define MAX_AMPLITUDE_HEIGHT 200
-#define AUDIO_SAMPLE_RATE 48000
-#define DECIBEL_METER_MAX_LENGTH 400
-#define MIN_FREQ 20.0f
-//Nyquist frequency; can only determine up to half the sample rate frequency
-#define MAX_FREQ ((float) AUDIO_SAMPLE_RATE/2)
-#define BIN_WIDTH_FREQ_RANGE (((float) AUDIO_SAMPLE_RATE) / NUM_FFT_SAMPLES)
-#define NUM_HALVES 4
-#define SCALING_FACTOR (360/(((float)NUM_GRAPH_SAMPLES/NUM_HALVES) * 2))
-#define HERTZ_PARTITIONS_INIT {MIN_FREQ, 60, 200, 1000, 2000, MAX_FREQ} //divides into important frequency ranges
-#define BIN_PARTITIONS_INIT {1, 48, 100, 72, 35} //Adds to NUM_GRAPH_SAMPLES (256)
+//whole hops allowed to queue up before old audio is skipped to bound latency
+#define MAX_BACKLOG_HOPS 4
 
 typedef enum{
     INACTIVE = -1,
@@ -64,16 +59,38 @@ static bool toggleFileSelector = false;
 static bool resetGraphs = false;
 static bool changeTheme = false;
 static bool useSelectedTheme = false;
+static bool toggleRecording = false;
+static bool showSpectrogram = false;
+//capture/duplex/loopback input instead of a track, there is no file to pick
+static bool liveInput = false;
 static std::string filepath;
 static std::string filename;
-static std::map<ColorThemes::ThemeType, ColorThemes::Theme> themeTable;
-static ColorThemes::ThemeType currentThemeType;
+static std::vector<ColorThemes::Theme> themeTable;
+static int currentThemeType;
+//set when the framebuffer size or the content scale changed, the render loop recomputes the layout
+static bool layoutChanged = true;
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height){
     glViewport(0, 0, width, height);
+    layoutChanged = true;
+}
+
+void content_scale_callback(GLFWwindow* window, float xscale, float yscale){
+    layoutChanged = true;
+}
+
+//reads the current framebuffer size, window size and content scale of the window
+void updateLayout(GLFWwindow* window, Layout& layout){
+    int framebufferWidth, framebufferHeight, windowWidth, windowHeight;
+    float xscale, yscale;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glfwGetWindowSize(window, &windowWidth, &windowHeight);
+    glfwGetWindowContentScale(window, &xscale, &yscale);
+    layout.update(framebufferWidth, framebufferHeight, windowWidth, windowHeight, xscale);
 }
 
 bool pickFile(){
+    if(liveInput) return false;
     std::vector<std::string> fpath = pfd::open_file("Select a File", ".", 
     {"Audio Files", "*.wav *.mp3 *.flac *.ogg"}, /*multiselect=*/false).result();
     if(fpath.size() < 1) return false;
@@ -109,10 +126,29 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         return;
     }
 
+    if(key == GLFW_KEY_R){
+        toggleRecording = true;
+        return;
+    }
+
+    if(key == GLFW_KEY_S){
+        showSpectrogram = !showSpectrogram;
+        return;
+    }
+
+    //first press starts tracing, later presses write everything traced so far
+    if(key == GLFW_KEY_T){
+        if(Tracer::IsEnabled()) Tracer::Dump();
+        else{
+            Tracer::Enable(Tracer::GetPath());
+            std::cout << "Tracing started, press T again to write " << Tracer::GetPath() << std::endl;
+        }
+        return;
+    }
+
     if(key == GLFW_KEY_TAB){
         if(useSelectedTheme == false){
-            currentThemeType = (ColorThemes::ThemeType) ((currentThemeType + 1) % 
-                (ColorThemes::ThemeType::NeonDesRainbow + 1));
+            currentThemeType = (currentThemeType + 1) % (int)themeTable.size();
         }
         changeTheme = true;
         useSelectedTheme = false;
@@ -133,201 +169,153 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     #endif
 }
 
-void generateCustomBins(float* freqTable){
-    int currentFreq = 0;
-    std::vector<float> hertzPartitions = HERTZ_PARTITIONS_INIT;
-    std::vector<int> binPartitions = BIN_PARTITIONS_INIT;
-
-    assert(hertzPartitions.size() == binPartitions.size() + 1 
-        && "Hertz partitions must be of size bin partitions + 1");
-    assert(std::accumulate(binPartitions.begin(), binPartitions.end(), 0) == NUM_GRAPH_SAMPLES 
-        && "Bin partitions must accumulate to the number of graph samples");
-
-    for(int part_c = 0; part_c < binPartitions.size(); part_c++){
-        float hertzPerBin = (hertzPartitions[part_c+1] - hertzPartitions[part_c]) / binPartitions[part_c];
-        for(int i = 0; i < binPartitions[part_c]; i++){
-            freqTable[currentFreq] = hertzPartitions[part_c] + i * (hertzPerBin);
-            currentFreq++;
-        }
-    }
-    freqTable[NUM_GRAPH_SAMPLES] = MAX_FREQ;
+//recordings are named after the time they were started
+std::string recordingPath(){
+    char name[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(name, sizeof(name), "recording_%Y%m%d_%H%M%S.y4m", std::localtime(&now));
+    return name;
 }
 
-void generateGraph(std::vector<SampleLine>& graphArr, float* positions, unsigned int* indices, double* funcTable, ColorThemes::Theme* theme){
-    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
-        AuxComputations::RGBAColor color = theme->generateColorSecondary();
-        theme->updateSecondaryIterator();
-        graphArr.push_back(SampleLine(i, WINDOW_MARGIN + i*(SAMPLE_WIDTH + 2*SAMPLE_MARGIN), WINDOW_HEIGHT/2, 
-                                        4 + MAX_AMPLITUDE_HEIGHT * funcTable[(int)(SCALING_FACTOR*i)%360], SAMPLE_WIDTH,
-                                        color.r, color.g, color.b, color.a));
-        graphArr.back().fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*i);
-        graphArr.back().fillIndices(indices, NUM_INDEX_POINTS*i);
+//targetObj is in the design units of its layout anchor, the cursor is mapped back into them
+bool checkMousePos(GLFWwindow* window, SampleLine targetObj, const Layout& layout, LayoutAnchor anchor){
+    if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS){
+        return false;
     }
-}
-
-void generateFreqGraph(std::vector<SampleLine>& freqArr, float* positions, unsigned int* indices, double* funcTable, ColorThemes::Theme* theme){
-    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
-        AuxComputations::RGBAColor color = theme->generateColorPrimary();
-        theme->updatePrimaryIterator();
-        freqArr.push_back(SampleLine(i, WINDOW_MARGIN + i*(SAMPLE_WIDTH + 2*SAMPLE_MARGIN), WINDOW_HEIGHT/2, 
-                                        4 + MAX_AMPLITUDE_HEIGHT * funcTable[(int)(SCALING_FACTOR*i)%360], SAMPLE_WIDTH,
-                                        color.r, color.g, color.b, color.a));
-        freqArr.back().fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*i);
-        freqArr.back().fillIndices(indices, NUM_INDEX_POINTS*i);
+    double mouseX;
+    double mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+    glm::vec2 mouse = layout.windowToDesign(anchor, mouseX, mouseY);
+    if(mouse.x >= targetObj.getBaseX() && mouse.x <= targetObj.getBaseX() + targetObj.getWidth()
+        && mouse.y >= targetObj.getBaseY() && mouse.y <= targetObj.getBaseY() + targetObj.getHeight()){
+            return true;
     }
+    return false;
 }
 
-void shiftGraphLeft(std::vector<SampleLine>& graphArr, ColorThemes::Theme* theme, float* positions, unsigned int* indices, float leftSample, float rightSample){
-    //update all graph bars and shift left
-    for(int i = 0; i < NUM_GRAPH_SAMPLES - 1; i++){
-        const float* newColors = graphArr[i+1].getColors();
-        graphArr[i].changeColor(newColors[0], newColors[1], newColors[2], newColors[3]);
-        const float newHeight = graphArr[i+1].getHeight();
-        graphArr[i].changeHeight(newHeight);
-        const float newBaseY = graphArr[i+1].getBaseY();
-        graphArr[i].changeYPos(newBaseY);
-    }
+//workers for the per-hop task graph in the interactive window, the render thread helps as well
+#define ANALYSIS_POOL_THREADS 2
+
+typedef struct{
+    //0 = ANALYSIS_POOL_THREADS
+    unsigned int analysisThreads;
+    bool pinThreads;
+    //analysis on the render thread only, without a thread pool
+    bool singleThreaded;
+    //analysis on its own thread, one frame behind rendering (high throughput instead of low latency)
+    bool pipelined;
+    //rebuild res/shaders programs when their file is saved (shader development)
+    bool reloadShaders;
+    AudioInputOptions input;
+} WindowOptions;
 
-    //update last element
-    AuxComputations::RGBAColor color = theme->generateColorSecondary();
-    graphArr.back().changeColor(color.r, color.g, color.b, color.a);
-    graphArr.back().changeYPos(WINDOW_HEIGHT/2 - (2 + MAX_AMPLITUDE_HEIGHT * rightSample));
-    graphArr.back().changeHeight(2 + MAX_AMPLITUDE_HEIGHT * rightSample + 2 + MAX_AMPLITUDE_HEIGHT * leftSample);
-
-    //increment iterator after creating sample
-    theme->updateSecondaryIterator();
-    //update position array
-    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
-        graphArr.at(i).fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*i);
-    }
+typedef enum{
+    RUN_WINDOW,
+    RUN_HEADLESS,
+    RUN_MULTI_STREAM,
+    RUN_LIST_DEVICES
+} RunMode;
+
+//optional device index after --capture/--duplex/--loopback
+int parseDeviceIndex(int argc, char** argv, int& i){
+    if(i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) return atoi(argv[++i]);
+    return -1;
 }
 
-void updateFreqValues(std::vector<SampleLine>& freqGraphArr, ColorThemes::Theme* theme, float* positions, unsigned int* indices, fftw_complex* leftSamples, fftw_complex* rightSamples, float* freqSeparationTable){
-    for(int visBin = 0; visBin < NUM_GRAPH_SAMPLES; visBin++){
-        float startFreq = freqSeparationTable[visBin];
-        float endFreq = freqSeparationTable[visBin+1];
-        //compute starting and ending position of bins
-        int startBin = (int)(startFreq / BIN_WIDTH_FREQ_RANGE);
-        int endBin = (int)(endFreq / BIN_WIDTH_FREQ_RANGE);
-
-        if (endBin <= startBin){
-            endBin = startBin + 1;
+//usage: Application --headless <audio file> [--output <path|->] [--format raw|y4m|png] [--fps <n>] 
+//                   [--threads <n>] [--theme <n>] [--egl] [--profile <json path>]
+//       Application --streams <audio file> <audio file> ... [--threads <n>] [--pin-threads] [--theme <n>]
+//       Application [--threads <n>] [--pin-threads] [--single-threaded] [--pipelined] [--reload-shaders]
+//                   [--capture [index] | --duplex [index] | --loopback [index]] [--period <frames>] [--null-backend]
+//       Application --list-devices [--null-backend]
+//       Application [--trace <json path>] (also valid with --headless and --streams)
+RunMode parseArgs(int argc, char** argv, HeadlessOptions& options, MultiStreamOptions& streamOptions, WindowOptions& windowOptions){
+    RunMode mode = RUN_WINDOW;
+    windowOptions.pinThreads = false;
+    windowOptions.singleThreaded = false;
+    windowOptions.pipelined = false;
+    windowOptions.reloadShaders = false;
+    windowOptions.input.mode = AUDIO_INPUT_FILE;
+    windowOptions.input.deviceIndex = -1;
+    windowOptions.input.periodFrames = 0;
+    windowOptions.input.useNullBackend = false;
+    options.outputPath = "-";
+    options.format = FrameWriter::Raw;
+    options.fps = ANALYSIS_RATE;
+    options.threads = 0;
+    options.useEGL = false;
+    //negative: DEFAULT_THEME_ID
+    options.themeIndex = -1;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--headless" && i + 1 < argc){
+            mode = RUN_HEADLESS;
+            options.inputPath = argv[++i];
         }
-
-        if (endBin > NUM_FFT_SAMPLES / 2){
-            endBin = NUM_FFT_SAMPLES / 2;
-            startBin = endBin - 1;
+        else if(arg == "--streams"){
+            mode = RUN_MULTI_STREAM;
+            while(i + 1 < argc && std::string(argv[i + 1]).compare(0, 2, "--") != 0){
+                streamOptions.inputPaths.push_back(argv[++i]);
+            }
         }
-
-        float centerFreq = (startFreq + endFreq) / 2.0f;
-        //0.5f = tight central emphasis, 1.0f = default, 2.0f = less weight focus
-        float weightingFactor = 1.7f;
-        float sigma = (endFreq - startFreq) / 2.0f * weightingFactor;
-
-        float leftWeightedSum = 0.0f, rightWeightedSum = 0.0f;
-        float weightTotal = 0.0f;
-
-        //compute magnitudes of both left and right channels within the given frequency range
-        float re, im;
-        for (int i = startBin; i < endBin && i < (NUM_FFT_SAMPLES/2 + 1); i++) {
-            float binFreq = i * BIN_WIDTH_FREQ_RANGE;
-            float dist = binFreq - centerFreq;
-
-            // Gaussian weighting, e^-0.5(((x-u)/s)^2), smaller sigma means stricter fall-off
-            float weight = expf(-0.5f * (dist * dist) / (sigma * sigma + 1e-6f));
-            re = leftSamples[i][0], im = leftSamples[i][1];
-            float leftMag = sqrtf(fmaxf(0.0f, re * re + im * im));
-
-            re = rightSamples[i][0], im = rightSamples[i][1];
-            float rightMag = sqrtf(fmaxf(0.0f, re * re + im * im));
-
-            leftWeightedSum += leftMag * weight;
-            rightWeightedSum += rightMag * weight;
-            weightTotal += weight;
+        else if(arg == "--output" && i + 1 < argc) options.outputPath = argv[++i];
+        else if(arg == "--format" && i + 1 < argc){
+            if(!FrameWriter::ParseFormat(argv[++i], options.format)){
+                std::cerr << "Unknown format " << argv[i] << ", expected raw, y4m or png" << std::endl;
+                exit(1);
+            }
         }
-        int gain = 30;
-        //compute overall height of left and right sample
-        float leftHeight = (leftWeightedSum / (weightTotal + 1e-6f)) / NUM_FFT_SAMPLES * MAX_AMPLITUDE_HEIGHT * gain;
-        float rightHeight = (rightWeightedSum / (weightTotal + 1e-6f)) / NUM_FFT_SAMPLES * MAX_AMPLITUDE_HEIGHT * gain;
-
-        //set default value to 0 if value is invalid
-        if(std::isnan(leftHeight) || std::isinf(leftHeight) || leftHeight < 0) leftHeight = 0;
-        if(std::isnan(rightHeight) || std::isinf(rightHeight) || rightHeight < 0) rightHeight = 0;
-
-        float prevRightHeight = WINDOW_HEIGHT/2 - freqGraphArr[visBin].getBaseY();
-        float prevLeftHeight = freqGraphArr[visBin].getHeight() - prevRightHeight;
-        //calculate smoothed values (exponential smoothing)
-        float newLeftHeight = AuxComputations::expSmooth(prevLeftHeight, leftHeight, 0.85f);
-        float newRightHeight = AuxComputations::expSmooth(abs(prevRightHeight), rightHeight, 0.85f);
-
-        freqGraphArr[visBin].changeHeight(fmaxf(4.0f, newRightHeight + newLeftHeight));
-        freqGraphArr[visBin].changeYPos(WINDOW_HEIGHT/2 - fmaxf(2.0f, newRightHeight));
-    }
-    //update position array
-    for(int i = 0; i < freqGraphArr.size(); i++){
-        freqGraphArr.at(i).fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*i);
+        else if(arg == "--threads" && i + 1 < argc) options.threads = std::max(0, atoi(argv[++i]));
+        else if(arg == "--fps" && i + 1 < argc) options.fps = std::max(1, atoi(argv[++i]));
+        else if(arg == "--theme" && i + 1 < argc) options.themeIndex = std::max(0, atoi(argv[++i]));
+        else if(arg == "--egl") options.useEGL = true;
+        else if(arg == "--pin-threads") windowOptions.pinThreads = true;
+        else if(arg == "--single-threaded") windowOptions.singleThreaded = true;
+        else if(arg == "--pipelined") windowOptions.pipelined = true;
+        else if(arg == "--reload-shaders") windowOptions.reloadShaders = true;
+        else if(arg == "--capture"){
+            windowOptions.input.mode = AUDIO_INPUT_CAPTURE;
+            windowOptions.input.deviceIndex = parseDeviceIndex(argc, argv, i);
+        }
+        else if(arg == "--duplex"){
+            windowOptions.input.mode = AUDIO_INPUT_DUPLEX;
+            windowOptions.input.deviceIndex = parseDeviceIndex(argc, argv, i);
+        }
+        else if(arg == "--loopback"){
+            windowOptions.input.mode = AUDIO_INPUT_LOOPBACK;
+            windowOptions.input.deviceIndex = parseDeviceIndex(argc, argv, i);
+        }
+        else if(arg == "--period" && i + 1 < argc) windowOptions.input.periodFrames = std::max(0, atoi(argv[++i]));
+        else if(arg == "--null-backend") windowOptions.input.useNullBackend = true;
+        else if(arg == "--list-devices") mode = RUN_LIST_DEVICES;
+        else if(arg == "--profile" && i + 1 < argc) options.profilePath = argv[++i];
+        else if(arg == "--trace" && i + 1 < argc) Tracer::Enable(argv[++i]);
+        else std::cerr << "Ignoring unknown argument: " << arg << std::endl;
     }
+    if(options.format == FrameWriter::PNG && options.outputPath == "-") options.outputPath = "frame_%06d.png";
+    streamOptions.threads = options.threads;
+    streamOptions.pinThreads = windowOptions.pinThreads;
+    streamOptions.themeIndex = options.themeIndex;
+    windowOptions.analysisThreads = options.threads == 0 ? ANALYSIS_POOL_THREADS : options.threads;
+    return mode;
 }
 
-void changeGraphThemes(std::vector<SampleLine>& ampGraphArr, std::vector<SampleLine>& freqGraphArr, float* ampPositions, float* freqPositions, ColorThemes::Theme* theme){
-    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
-        AuxComputations::RGBAColor color = theme->generateColorPrimary();
-        freqGraphArr[i].changeColor(color.r, color.g, color.b, color.a);
-        freqGraphArr[i].fillVertices(freqPositions, NUM_TOTAL_VERTEX_POINTS*i);
-        color = theme->generateColorSecondary();
-        ampGraphArr[i].changeColor(color.r, color.g, color.b, color.a);
-        ampGraphArr[i].fillVertices(ampPositions, NUM_TOTAL_VERTEX_POINTS*i);
-        theme->updatePrimaryIterator();
-        theme->updateSecondaryIterator();
+int main(int argc, char** argv){
+    HeadlessOptions headlessOptions;
+    MultiStreamOptions streamOptions;
+    WindowOptions windowOptions;
+    RunMode mode = parseArgs(argc, argv, headlessOptions, streamOptions, windowOptions);
+    if(mode == RUN_HEADLESS) return RunHeadless(headlessOptions);
+    if(mode == RUN_MULTI_STREAM) return RunMultiStream(streamOptions);
+    if(mode == RUN_LIST_DEVICES){
+        ma_context context;
+        if(createContext(context, windowOptions.input.useNullBackend) != 0) return -1;
+        listAudioDevices(context);
+        ma_context_uninit(&context);
+        return 0;
     }
-}
-
-void adjustDecibelMeters(float* positions, unsigned int* indices, SampleLine& leftDBMeter, SampleLine& rightDBMeter, float prevLeftDB, float prevRightDB, float& leftDB, float& rightDB){
-    leftDB = AuxComputations::expSmooth(prevLeftDB, glm::clamp((leftDB + 60.0f) / 60.0f, 0.01f, 1.0f), 0.93f);
-    leftDBMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
-    if(leftDB >= 0.05f) leftDBMeter.changeColor(0.0f, 0.9f, 0.0f, 0.8f);
-    if(leftDB >= 0.5f) leftDBMeter.changeColor(0.9f, 0.9f, 0.0f, 0.8f);
-    if(leftDB >= 0.75f) leftDBMeter.changeColor(0.9f, 0.0f, 0.0f, 0.8f);
-    if(leftDB >= 0.99f) leftDBMeter.changeColor(0.9f, 0.9f, 0.9f, 0.8f);
-    leftDBMeter.changeWidth(leftDB*DECIBEL_METER_MAX_LENGTH);
-    leftDBMeter.fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*4);
-    leftDBMeter.fillIndices(indices, NUM_INDEX_POINTS*4);
-
-    rightDB = AuxComputations::expSmooth(prevRightDB, glm::clamp((rightDB + 60.0f) / 60.0f, 0.01f, 1.0f), 0.93f);
-    rightDBMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
-    if(rightDB >= 0.05f) rightDBMeter.changeColor(0.0f, 0.9f, 0.0f, 0.8f);
-    if(rightDB >= 0.5f) rightDBMeter.changeColor(0.9f, 0.9f, 0.0f, 0.8f);
-    if(rightDB >= 0.75f) rightDBMeter.changeColor(0.9f, 0.0f, 0.0f, 0.8f);
-    if(rightDB >= 0.99f) rightDBMeter.changeColor(0.9f, 0.9f, 0.9f, 0.8f);
-    rightDBMeter.changeWidth(rightDB*DECIBEL_METER_MAX_LENGTH);
-    rightDBMeter.fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*5);
-    rightDBMeter.fillIndices(indices, NUM_INDEX_POINTS*5);
-}
-
-void addSeparatorLine(size_t offset, float* positions, unsigned int* indices){
-    SampleLine separator(offset, WINDOW_MARGIN, WINDOW_HEIGHT/2 - 1, 2, 
-        WINDOW_WIDTH - 2*WINDOW_MARGIN - SAMPLE_MARGIN, 0.5f, 0.5f, 0.5f, 1.0f);
+    liveInput = windowOptions.input.mode != AUDIO_INPUT_FILE;
 
-    separator.fillVertices(positions, NUM_TOTAL_VERTEX_POINTS*(offset));
-    separator.fillIndices(indices, NUM_INDEX_POINTS*(offset));
-}
-
-bool checkMousePos(GLFWwindow* window, SampleLine targetObj){
-    if(glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS){
-        return false;
-    }
-    double mouseX;
-    double mouseY;
-    glfwGetCursorPos(window, &mouseX, &mouseY);
-    mouseY = WINDOW_HEIGHT - mouseY;
-    if(mouseX >= targetObj.getBaseX() && mouseX <= targetObj.getBaseX() + targetObj.getWidth()
-        && mouseY >= targetObj.getBaseY() && mouseY <= targetObj.getBaseY() + targetObj.getHeight()){
-            return true;
-    }
-    return false;
-}
-
-int main(){
     //intialize glfw and configure
     if(!glfwInit()) return -1;
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -337,7 +325,13 @@ int main(){
     #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     #endif
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+    //opens at the design size times the content scale (HiDPI on Windows/Linux, macOS scales the framebuffer instead)
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+    #if GL_CHECK_ERRORS
+    //debug builds report GL errors through the debug output callback instead of glGetError round-trips
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+    #endif
     //initialize window
     GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Audio Visualizer", nullptr, nullptr);
     if(!window){
@@ -347,259 +341,185 @@ int main(){
     }
     glfwMakeContextCurrent(window);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetWindowContentScaleCallback(window, content_scale_callback);
     glfwSetKeyCallback(window, key_callback);
-    
-    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
 
     //initialize glad
     if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)){
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    #if GL_CHECK_ERRORS
+    //synchronous: a message arrives inside the failing call, so it names the right GLCall
+    if(!EnableGLDebugOutput((GLADloadproc)glfwGetProcAddress, true)){
+        std::cerr << "GL debug output unavailable, GLCall falls back to glGetError" << std::endl;
+    }
+    #endif
 
-    GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-    GLCall(glEnable(GL_BLEND));
+    //a new context starts with default state, whatever the cache remembers belongs to an older one
+    GLStateCache::Get().invalidate();
+    GLStateCache::Get().setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::Get().setBlend(true);
+    ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress);
+    Profiler::Get().initGpu();
 
-    ColorThemes::InitializeThemes(themeTable, (SCALING_FACTOR/(NUM_HALVES/2)));
-    currentThemeType = ColorThemes::ThemeType::TealWarm;
-    ColorThemes::Theme* currentTheme = &themeTable.at(currentThemeType);
+    ColorThemes::InitializeThemes(themeTable);
+    currentThemeType = ColorThemes::FindTheme(themeTable, DEFAULT_THEME_ID);
+    ColorThemes::Theme* currentTheme = &themeTable[currentThemeType];
     AuxComputations::RGBAColor bgColorTheme = currentTheme->getBG();
     // AuxComputations::RGBAColor txColorTheme = currentTheme.getText();
     AuxComputations::RGBAColor btColorTheme = currentTheme->getButton();
     // AuxComputations::RGBAColor pbColorTheme = currentTheme.getPlayButton();
 
-    double sinTable[360] = {};
-    for(int i = 0; i < 360; i++){
-        sinTable[i] = sin(i * M_PI/180);
-    }
-    double cosTable[360] = {};
-    for(int i = 0; i < 360; i++){
-        cosTable[i] = cos(i * M_PI/180);
-    }
-    double tanTable[360] = {};
-    for(int i = 0; i < 360; i++){
-        tanTable[i] = tan(i * M_PI/180);
-    }
-    //IMPORTANT: sets the function for drawing heights
-    double* funcTable = sinTable;
     {
-        VertexBufferLayout layout;
-        //vertex position coords
-        layout.Push<float>(3);
-        //color coords
-        layout.Push<float>(4);
-
-        //start setting up main graph
-        std::vector<SampleLine> ampGraph;
-        float ampPositions[NUM_TOTAL_VERTEX_POINTS*(NUM_GRAPH_SAMPLES + 1)];
-        unsigned int ampIndices[NUM_INDEX_POINTS*(NUM_GRAPH_SAMPLES + 1)];
-        
-        generateGraph(ampGraph, ampPositions, ampIndices, funcTable, currentTheme);
-        addSeparatorLine(NUM_GRAPH_SAMPLES, ampPositions, ampIndices);
-
-        MappedDrawObj ampGraphObj(ampPositions, ampIndices, 
-            NUM_TOTAL_VERTEX_POINTS * (NUM_GRAPH_SAMPLES + 1), 
-            NUM_INDEX_POINTS*(NUM_GRAPH_SAMPLES + 1), layout);
-        //end setting up main graph
-
-        //start setting up decibel meter
-        float dbPositions[NUM_TOTAL_VERTEX_POINTS*6];
-        unsigned int dbIndices[NUM_INDEX_POINTS*6];
-        int dbIterator = 0;
-        float dbXPos = WINDOW_MARGIN;
-        float dbYPos = WINDOW_MARGIN + 10.0f;
-
-        SampleLine blackOutline(dbIterator, dbXPos - 5, dbYPos - 5, 
-            70, DECIBEL_METER_MAX_LENGTH + 10 + 10, 
-            0.0f, 0.0f, 0.0f, 1.0f);
-        blackOutline.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        blackOutline.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        SampleLine greenSegment(dbIterator, dbXPos, dbYPos, 
-            60, DECIBEL_METER_MAX_LENGTH/2 + 10, 
-            0.0f, 0.7f, 0.0f, 1.0f);
-        greenSegment.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        greenSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        SampleLine yellowSegment(dbIterator, dbXPos + DECIBEL_METER_MAX_LENGTH/2, dbYPos, 
-            60, DECIBEL_METER_MAX_LENGTH/4 + 10, 
-            0.7f, 0.7f, 0.0f, 1.0f);
-        yellowSegment.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        yellowSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        SampleLine redSegment(dbIterator, dbXPos + ((DECIBEL_METER_MAX_LENGTH * 3) / 4), dbYPos, 
-            60, DECIBEL_METER_MAX_LENGTH/4 + 10, 
-            0.7f, 0.0f, 0.0f, 1.0f);
-        redSegment.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        redSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        SampleLine leftDecibelMeter(dbIterator, dbXPos + 5, dbYPos + 5 + 30, 
-            20, DECIBEL_METER_MAX_LENGTH, 
-            0.85f, 0.85f, 0.85f, 0.7f);
-        leftDecibelMeter.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        leftDecibelMeter.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        SampleLine rightDecibelMeter(dbIterator, dbXPos + 5, dbYPos + 5, 
-            20, DECIBEL_METER_MAX_LENGTH, 
-            0.85f, 0.85f, 0.85f, 0.7f);
-        rightDecibelMeter.fillVertices(dbPositions, NUM_TOTAL_VERTEX_POINTS*dbIterator);
-        rightDecibelMeter.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
-        dbIterator++;
-
-        MappedDrawObj dbMeterObj(dbPositions, dbIndices, 
-            NUM_TOTAL_VERTEX_POINTS*6, NUM_INDEX_POINTS*6, layout);
-        //end setting up decibel meter
-
-        //start setting up frequency graph
-        std::vector<SampleLine> freqGraph;
-        float freqPositions[NUM_TOTAL_VERTEX_POINTS*(NUM_GRAPH_SAMPLES + 1)];
-        unsigned int freqIndices[NUM_INDEX_POINTS*(NUM_GRAPH_SAMPLES + 1)];
-        generateFreqGraph(freqGraph, freqPositions, freqIndices, funcTable, currentTheme);
-
-        MappedDrawObj freqGraphObj(freqPositions, freqIndices, 
-            NUM_TOTAL_VERTEX_POINTS * (NUM_GRAPH_SAMPLES + 1), 
-            NUM_INDEX_POINTS*(NUM_GRAPH_SAMPLES + 1), layout);
-        
-        double* leftIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
-        fftw_complex* leftOut = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (NUM_FFT_SAMPLES/2 + 1));
-        double* rightIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
-        fftw_complex* rightOut = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (NUM_FFT_SAMPLES/2 + 1));
-        std::fill(leftIn, leftIn + NUM_FFT_SAMPLES, 0.0);
-        std::fill(rightIn, rightIn + NUM_FFT_SAMPLES, 0.0);
-        for(int i = 0; i < (NUM_FFT_SAMPLES/2 + 1); i++){
-            leftOut[i][0] = 0;
-            leftOut[i][1] = 0;
-            rightOut[i][0] = 0;
-            rightOut[i][1] = 0;
-        }
-
-        fftw_plan freqGraphPlanLeft = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, leftIn, leftOut, FFTW_ESTIMATE);
-        fftw_plan freqGraphPlanRight = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, rightIn, rightOut, FFTW_ESTIMATE);
-
-        float logFreqSpacingTable[NUM_GRAPH_SAMPLES+1] = {0};
-        float linearFreqSpacingTable[NUM_GRAPH_SAMPLES+1] = {0};
-        float customFreqSpacingTable[NUM_GRAPH_SAMPLES+1] = {0};
-
-        float logMinFreq = logf(MIN_FREQ);
-        float binSpacing = logf(MAX_FREQ / MIN_FREQ);
-        //precompute logarithmic spacing for frequency graph
-        for(int i = 0; i < NUM_GRAPH_SAMPLES+1; i++) {
-            logFreqSpacingTable[i] = expf(logMinFreq + (float)i / NUM_GRAPH_SAMPLES * binSpacing);
-        }
-        for(int i = 0; i < NUM_GRAPH_SAMPLES+1; i++){
-            linearFreqSpacingTable[i] = MIN_FREQ + (float)i/(NUM_GRAPH_SAMPLES+1) * (MAX_FREQ - MIN_FREQ);
+        VertexBufferLayout layout = Visualizer::CreateVertexLayout();
+
+        //graphs and decibel meters, fed by the analysis engine
+        Visualizer visualizer(currentTheme);
+        AnalysisEngine engine;
+        engine.reset(visualizer.getFreqGraph().getLeftHeights(), visualizer.getFreqGraph().getRightHeights());
+        //per-hop analysis runs as a task graph on the pool and is joined before the graphs are updated
+        std::unique_ptr<ThreadPool> analysisPool;
+        if(!windowOptions.singleThreaded){
+            analysisPool.reset(new ThreadPool(windowOptions.analysisThreads, windowOptions.pinThreads));
+            engine.setThreadPool(analysisPool.get());
         }
-        generateCustomBins(customFreqSpacingTable);
-        std::deque<float> rollingFreqBuffer(NUM_FFT_SAMPLES, 0.0f);
-        //end setting up frequency graph
+        //high-throughput mode: the engine runs on a pipeline thread while the render thread draws the previous frame
+        std::unique_ptr<AnalysisPipeline> pipeline;
+        if(windowOptions.pipelined) pipeline.reset(new AnalysisPipeline(engine, MAX_BACKLOG_HOPS));
 
         //start setting up miscellaneous icons
         float icon_size = 60.0f;
         float icon_offset = 20.0f;
         float miscIconXpos = WINDOW_MARGIN + icon_offset;
         float miscIconYpos = WINDOW_HEIGHT - WINDOW_MARGIN - icon_offset - icon_size;
-        //2 for pause icon, 0.5 for play icon, 2 for file icon
-        float pauseButtonPositions[(int)(NUM_TOTAL_VERTEX_POINTS*2.0f)] = {
-            miscIconXpos + icon_size*0.2f, miscIconYpos            , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.4f, miscIconYpos            , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.4f, miscIconYpos + icon_size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.2f, miscIconYpos + icon_size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.6f, miscIconYpos            , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.8f, miscIconYpos            , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.8f, miscIconYpos + icon_size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size*0.6f, miscIconYpos + icon_size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        //8 vertices for pause icon, 3 for play icon, 12 for file icon
+        Vertex pauseButtonPositions[8] = {
+            {miscIconXpos + icon_size*0.2f, miscIconYpos            , 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.4f, miscIconYpos            , 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.4f, miscIconYpos + icon_size, 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.2f, miscIconYpos + icon_size, 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.6f, miscIconYpos            , 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.8f, miscIconYpos            , 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.8f, miscIconYpos + icon_size, 0, 0, 0, 255},
+            {miscIconXpos + icon_size*0.6f, miscIconYpos + icon_size, 0, 0, 0, 255},
         };
-        unsigned int pauseButtonIndices[(int)(NUM_INDEX_POINTS*2.0f)] = {
+        unsigned int pauseButtonIndices[12] = {
             0, 1, 2, 2, 3, 0,
             4, 5, 6, 6, 7, 4,
         };
-        MappedDrawObj pauseButtonObj(pauseButtonPositions, pauseButtonIndices, 
-            (size_t)(NUM_TOTAL_VERTEX_POINTS * 2.0f), 
-            (size_t)(NUM_INDEX_POINTS * 2.0f), layout);
-
-        float startButtonPositions[(int)(NUM_TOTAL_VERTEX_POINTS*0.75f)] = {
-            miscIconXpos            , miscIconYpos                 , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos            , miscIconYpos + icon_size     , 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            miscIconXpos + icon_size, miscIconYpos + icon_size*0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        MappedDrawObj pauseButtonObj(pauseButtonPositions, pauseButtonIndices, 8, 12, layout);
+
+        Vertex startButtonPositions[3] = {
+            {miscIconXpos            , miscIconYpos                 , 0, 0, 0, 255},
+            {miscIconXpos            , miscIconYpos + icon_size     , 0, 0, 0, 255},
+            {miscIconXpos + icon_size, miscIconYpos + icon_size*0.5f, 0, 0, 0, 255},
         };
-        unsigned int startButtonIndices[(int)(NUM_INDEX_POINTS*0.5f)] = {
+        unsigned int startButtonIndices[3] = {
             0, 1, 2,
         };
-        MappedDrawObj startButtonObj(startButtonPositions, startButtonIndices, 
-            (size_t)(NUM_TOTAL_VERTEX_POINTS * 2.0f), 
-            (size_t)(NUM_INDEX_POINTS * 2.0f), layout);
+        MappedDrawObj startButtonObj(startButtonPositions, startButtonIndices, 3, 3, layout);
 
         float fileOpenButtonXpos = WINDOW_WIDTH - WINDOW_MARGIN - icon_offset - icon_size;
         float fileOpenButtonYpos = WINDOW_HEIGHT - WINDOW_MARGIN - icon_size - icon_offset;
-        float fileButtonPositions[(int)(NUM_TOTAL_VERTEX_POINTS*3.0f)] = {
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.1f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.65f, 1.0f, 0.48f, 0.48f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.65f, 1.0f, 0.48f, 0.48f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.1f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.65f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.8f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.8f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.65f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.8f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.9f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size*0.5f, fileOpenButtonYpos + icon_size*0.9f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
-            fileOpenButtonXpos + icon_size*0.5f, fileOpenButtonYpos + icon_size*0.8f, 1.0f, 0.5f, 0.5f, 0.5f, 1.0f,
+        //color bytes: 122 = 0.48f, 128 = 0.5f
+        Vertex fileButtonPositions[12] = {
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.1f , 0, 0, 0, 255},
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.65f, 122, 122, 128, 255},
+            {fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.65f, 122, 122, 128, 255},
+            {fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.1f , 0, 0, 0, 255},
+
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.65f, 128, 128, 128, 255},
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.8f , 128, 128, 128, 255},
+            {fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.8f , 128, 128, 128, 255},
+            {fileOpenButtonXpos + icon_size     , fileOpenButtonYpos + icon_size*0.65f, 128, 128, 128, 255},
+
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.8f , 128, 128, 128, 255},
+            {fileOpenButtonXpos                 , fileOpenButtonYpos + icon_size*0.9f , 128, 128, 128, 255},
+            {fileOpenButtonXpos + icon_size*0.5f, fileOpenButtonYpos + icon_size*0.9f , 128, 128, 128, 255},
+            {fileOpenButtonXpos + icon_size*0.5f, fileOpenButtonYpos + icon_size*0.8f , 128, 128, 128, 255},
         };
-        unsigned int fileButtonIndices[(int)(NUM_INDEX_POINTS*3.0f)] = {
+        unsigned int fileButtonIndices[18] = {
             0, 1, 2, 2, 3, 0,
             4, 5, 6, 6, 7, 4,
             8, 9, 10, 10, 11, 8,
         };
-        MappedDrawObj fileButtonObj(fileButtonPositions, fileButtonIndices, 
-            (size_t)(NUM_TOTAL_VERTEX_POINTS * 3.0f), 
-            (size_t)(NUM_INDEX_POINTS * 3.0f), layout);
+        MappedDrawObj fileButtonObj(fileButtonPositions, fileButtonIndices, 12, 18, layout);
 
         float border_icon_size = 100.0f;
         float border_margin = 5.0f;
         float borderXpos = WINDOW_MARGIN;
         float borderYpos = WINDOW_HEIGHT - WINDOW_MARGIN - border_icon_size;
         float fileBorderXpos = WINDOW_WIDTH - WINDOW_MARGIN - border_icon_size;
-        float borderButtonPositions[(int)(NUM_TOTAL_VERTEX_POINTS*4.0f)];
-        unsigned int borderButtonIndices[(int)(NUM_INDEX_POINTS*4.0f)];
-
-        float borderIterator = 0;
-        SampleLine border(borderIterator, borderXpos, borderYpos, 
-            border_icon_size, border_icon_size, 0.0f, 0.0f, 0.0f, 1.0f);
-        border.fillVertices(borderButtonPositions, NUM_TOTAL_VERTEX_POINTS*borderIterator);
-        border.fillIndices(borderButtonIndices, NUM_INDEX_POINTS*borderIterator);
-        borderIterator++;
+        //play/pause and file borders are separate objects, they belong to different corners of the layout
+        Vertex borderButtonPositions[NUM_VERTICES_PER_SAMPLE*2];
+        unsigned int borderButtonIndices[NUM_INDEX_POINTS*2];
+        Vertex fileBorderPositions[NUM_VERTICES_PER_SAMPLE*2];
+        unsigned int fileBorderIndices[NUM_INDEX_POINTS*2];
 
-        SampleLine borderFile(borderIterator, fileBorderXpos, borderYpos, 
+        SampleLine border(0, borderXpos, borderYpos, 
             border_icon_size, border_icon_size, 0.0f, 0.0f, 0.0f, 1.0f);
-        borderFile.fillVertices(borderButtonPositions, NUM_TOTAL_VERTEX_POINTS*borderIterator);
-        borderFile.fillIndices(borderButtonIndices, NUM_INDEX_POINTS*borderIterator);
-        borderIterator++;
+        border.fillVertices(borderButtonPositions, 0);
+        border.fillIndices(borderButtonIndices, 0);
 
-        SampleLine borderInterior(borderIterator, borderXpos + border_margin, borderYpos + border_margin, 
+        SampleLine borderInterior(1, borderXpos + border_margin, borderYpos + border_margin, 
             border_icon_size - 2*border_margin, border_icon_size - 2*border_margin, btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
-        borderInterior.fillVertices(borderButtonPositions, NUM_TOTAL_VERTEX_POINTS*borderIterator);
-        borderInterior.fillIndices(borderButtonIndices, NUM_INDEX_POINTS*borderIterator);
-        borderIterator++;
+        borderInterior.fillVertices(borderButtonPositions, NUM_VERTICES_PER_SAMPLE);
+        borderInterior.fillIndices(borderButtonIndices, NUM_INDEX_POINTS);
 
-        SampleLine borderFileInterior(borderIterator, fileBorderXpos + border_margin, borderYpos + border_margin, 
+        SampleLine borderFile(0, fileBorderXpos, borderYpos, 
+            border_icon_size, border_icon_size, 0.0f, 0.0f, 0.0f, 1.0f);
+        borderFile.fillVertices(fileBorderPositions, 0);
+        borderFile.fillIndices(fileBorderIndices, 0);
+
+        SampleLine borderFileInterior(1, fileBorderXpos + border_margin, borderYpos + border_margin, 
             border_icon_size - 2*border_margin, border_icon_size - 2*border_margin, btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
-        borderFileInterior.fillVertices(borderButtonPositions, NUM_TOTAL_VERTEX_POINTS*borderIterator);
-        borderFileInterior.fillIndices(borderButtonIndices, NUM_INDEX_POINTS*borderIterator);
-        borderIterator++;
+        borderFileInterior.fillVertices(fileBorderPositions, NUM_VERTICES_PER_SAMPLE);
+        borderFileInterior.fillIndices(fileBorderIndices, NUM_INDEX_POINTS);
 
         MappedDrawObj borderButtonObj(borderButtonPositions, borderButtonIndices, 
-            (size_t)(NUM_TOTAL_VERTEX_POINTS * 4.0f), 
-            (size_t)(NUM_INDEX_POINTS * 4.0f), layout);
+            NUM_VERTICES_PER_SAMPLE * 2, NUM_INDEX_POINTS * 2, layout);
+        MappedDrawObj fileBorderObj(fileBorderPositions, fileBorderIndices, 
+            NUM_VERTICES_PER_SAMPLE * 2, NUM_INDEX_POINTS * 2, layout);
+
+        //record toggle, right next to play/pause
+        float record_icon_size = 50.0f;
+        float recordXpos = borderXpos + border_icon_size + 2*border_margin;
+        float recordYpos = borderYpos + border_icon_size - record_icon_size;
+        float record_dot_size = 20.0f;
+        Vertex recordButtonPositions[NUM_VERTICES_PER_SAMPLE*3];
+        unsigned int recordButtonIndices[NUM_INDEX_POINTS*3];
+
+        SampleLine recordBorder(0, recordXpos, recordYpos, 
+            record_icon_size, record_icon_size, 0.0f, 0.0f, 0.0f, 1.0f);
+        recordBorder.fillVertices(recordButtonPositions, 0);
+        recordBorder.fillIndices(recordButtonIndices, 0);
+
+        SampleLine recordInterior(1, recordXpos + border_margin, recordYpos + border_margin, 
+            record_icon_size - 2*border_margin, record_icon_size - 2*border_margin, btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
+        recordInterior.fillVertices(recordButtonPositions, NUM_VERTICES_PER_SAMPLE);
+        recordInterior.fillIndices(recordButtonIndices, NUM_INDEX_POINTS);
+
+        SampleLine recordDot(2, recordXpos + (record_icon_size - record_dot_size)/2, recordYpos + (record_icon_size - record_dot_size)/2, 
+            record_dot_size, record_dot_size, 0.4f, 0.0f, 0.0f, 1.0f);
+        recordDot.fillVertices(recordButtonPositions, NUM_VERTICES_PER_SAMPLE*2);
+        recordDot.fillIndices(recordButtonIndices, NUM_INDEX_POINTS*2);
+
+        MappedDrawObj recordButtonObj(recordButtonPositions, recordButtonIndices, 
+            NUM_VERTICES_PER_SAMPLE * 3, NUM_INDEX_POINTS * 3, layout);
         //end setting up miscellaneous icons
 
         Shader shader("./res/shaders/shader.glsl");
+        //waterfall of every hop behind the graphs, filled whether it is shown or not
+        Spectrogram spectrogram(WINDOW_MARGIN, WINDOW_HEIGHT/2 - MAX_AMPLITUDE_HEIGHT,
+            NUM_GRAPH_SAMPLES * (SAMPLE_WIDTH + 2*SAMPLE_MARGIN), 2 * MAX_AMPLITUDE_HEIGHT);
+        //bar colors of every theme, switching themes only changes the row the shader reads
+        std::vector<unsigned char> paletteTexels;
+        ColorThemes::PackPalettes(themeTable, paletteTexels);
+        Texture paletteTexture(PALETTE_PERIOD, 2 * (int)themeTable.size(), paletteTexels.data());
+        if(windowOptions.reloadShaders && !ShaderManager::Get().enableHotReload()){
+            std::cout << "Shader hot reload unavailable on this platform" << std::endl;
+        }
         Renderer renderer;
 
         ImGui::CreateContext();
@@ -611,120 +531,139 @@ int main(){
         ImGui_ImplOpenGL3_Init("#version 330");
         ImGui::StyleColorsDark();
 
-        glm::mat4 proj = glm::ortho(0.0f, WINDOW_WIDTH, 0.0f, WINDOW_HEIGHT, -1.0f, 1.0f);
-        glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 0.0f));
-        glm::vec3 translation(0.0f, 0.0f, 0);
+        //ImGui sizes at scale 1, rescaled from this copy whenever the content scale changes
+        const ImGuiStyle baseStyle = ImGui::GetStyle();
+        //maps the design-unit geometry to the framebuffer, recomputed on resize (the mvp and anchors change, no vertices)
+        Layout windowLayout;
+        //shared by every program through the FrameConstants block, uploaded once per frame
+        FrameConstants frameConstants;
+        const int anchorUniform = shader.GetUniformHandle("u_Anchor");
+        UniformBuffer frameConstantsBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+        const double startTime = glfwGetTime();
+        double previousFrameTime = startTime;
+        unsigned long long frameNumber = 0;
 
         //file_example_WAV_1MG
         //Moon_River_Audio_File
-        if(pickFile() == false){
+        if(!liveInput && pickFile() == false){
             std::cout << "No File Selected" << std::endl;
-            fftw_free(leftIn);
-            fftw_free(leftOut);
-            fftw_free(rightIn);
-            fftw_free(rightOut);
-            fftw_destroy_plan(freqGraphPlanLeft);
-            fftw_destroy_plan(freqGraphPlanRight);
             return 0;
         }
 
+        ma_context context;
+        if(createContext(context, windowOptions.input.useNullBackend) != 0) return -1;
         ma_device device;
         ma_decoder decoder;
 
         glfwSetWindowUserPointer(window, &device);
 
         TrackRingBuffer audioBuffer;
-        createDevice(device, decoder, filepath.c_str(), audioBuffer);
+        if(liveInput){
+            //live input feeds the same ring buffer and analysis as a track, it just never ends
+            std::string deviceName;
+            if(createCaptureDevice(context, device, windowOptions.input, audioBuffer, deviceName) != 0){
+                ma_context_uninit(&context);
+                return -1;
+            }
+            filename = "Live input (" + deviceName + ")";
+        }
+        else createDevice(device, decoder, filepath.c_str(), audioBuffer, &context);
+        if(pipeline) pipeline->start(*audioBuffer.ringBuffer);
+
+        //analysis is paced by the audio clock, rendering by the display (vsync or fps cap)
+        FrameScheduler scheduler(ANALYSIS_HOP_SAMPLES, 2 * AUDIO_SAMPLE_RATE, MAX_BACKLOG_HOPS);
+        scheduler.setSwapInterval(1);
+        //one hop of interleaved samples drained from the ring buffer, reused every hop
+        std::vector<float> hopSamples(ANALYSIS_HOP_SAMPLES, 0.0f);
 
-        //number of samples to be read per frame = sampling rate / refresh rate
-        int samplesPerDrawCall = AUDIO_SAMPLE_RATE / mode->refreshRate;
-        float prevLeftSample = 0;
-        float prevRightSample = 0;
-        float prevLeftDB = 1.0f;
-        float prevRightDB = 1.0f;
+        //recording reads back the whole window framebuffer (may be larger than the window on HiDPI screens)
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        std::unique_ptr<FrameCapture> capture(new FrameCapture(framebufferWidth, framebufferHeight));
 
         audioDeviceStatus = PAUSED;
         bool cursorPressedBefore = false;
         bool canSelectFile = true;
+        bool showProfiler = false;
+        TRACE_THREAD_NAME("render loop");
         while(!glfwWindowShouldClose(window)){
+            TRACE_SCOPE("frame");
+            scheduler.beginFrame();
+            FrameArena::Get().reset();
+            Profiler::Get().beginFrame();
+            GLStateCache::Get().beginFrame();
+            //shaders saved since the last frame are rebuilt before anything binds them
+            ShaderManager::Get().pollReload();
+            //ImGui windows follow the layout in the frame after a resize, in between they stay where the user put them
+            const bool placeWindows = layoutChanged;
+            if(layoutChanged){
+                updateLayout(window, windowLayout);
+                windowLayout.fillFrameConstants(frameConstants);
+                const float uiScale = windowLayout.getWindowScale(LAYOUT_ANCHOR_TOP_LEFT);
+                ImGui::GetStyle() = baseStyle;
+                ImGui::GetStyle().ScaleAllSizes(uiScale);
+                io.FontGlobalScale = uiScale;
+                layoutChanged = false;
+            }
             renderer.Clear(bgColorTheme.r, bgColorTheme.g, bgColorTheme.b, bgColorTheme.a);
             {
-                if(audioDeviceStatus == PLAYING && !(*audioBuffer.ringBuffer).isEmpty()){
-                    if((*audioBuffer.ringBuffer).getSize() >= 2*samplesPerDrawCall){
-                        for(int i = 0; i < samplesPerDrawCall; i++){
-                            float temp;
-                            (*audioBuffer.ringBuffer).pop(temp);
+                if(pipeline){
+                    //frames the analysis thread finished while the previous frame was drawn
+                    while(const PipelineFrame* frame = pipeline->acquire()){
+                        visualizer.update(*frame);
+                        for(size_t hop = 0; hop < frame->hops; hop++){
+                            spectrogram.addRow(frame->spectra[hop]);
+                            scheduler.markAnalysisFrame();
                         }
+                        scheduler.addDroppedHops(frame->droppedHops);
+                        if(frame->hops > 0) scheduler.setAudioBacklog(frame->backlogSamples);
+                        pipeline->release();
+                    }
+                }
+                else if(audioDeviceStatus == PLAYING){
+                    size_t hopsToDrop = 0;
+                    size_t hopsDue = scheduler.scheduleHops((*audioBuffer.ringBuffer).getSize(), hopsToDrop);
+                    TRACE_COUNTER("hops due", hopsDue);
+                    TRACE_COUNTER("hops dropped", hopsToDrop);
+                    //render loop fell behind the audio clock; skip whole hops instead of drifting
+                    for(size_t i = 0; i < hopsToDrop * ANALYSIS_HOP_SAMPLES; i++){
+                        float temp;
+                        (*audioBuffer.ringBuffer).pop(temp);
                     }
-                    float leftSample = prevLeftSample;
-                    float rightSample = prevRightSample;
-                    std::vector<float> arraySamples(samplesPerDrawCall, 0.0f);
-
-                    AuxComputations::fillArrayWithSamples((*audioBuffer.ringBuffer), arraySamples, samplesPerDrawCall);
-                    AuxComputations::computePeakValueStereo(arraySamples, samplesPerDrawCall, leftSample, rightSample);
-                    leftSample = AuxComputations::expSmooth(prevLeftSample, leftSample, 0.3f);
-                    rightSample = AuxComputations::expSmooth(prevRightSample, rightSample, 0.3f);
-                    shiftGraphLeft(ampGraph, currentTheme, 
-                                ampGraphObj.mappedPositions, ampGraphObj.mappedIndices, 
-                                leftSample, rightSample);
-                    prevLeftSample = leftSample;
-                    prevRightSample = rightSample;
-
-                    float leftDB = prevLeftDB;
-                    float rightDB = prevRightDB;
-                    AuxComputations::computeDecibelLevels(leftSample, rightSample, leftDB, rightDB);
-                    adjustDecibelMeters(dbMeterObj.mappedPositions, dbMeterObj.mappedIndices, 
-                        leftDecibelMeter, rightDecibelMeter, prevLeftDB, prevRightDB, leftDB, rightDB);
-                    prevLeftDB = leftDB;
-                    prevRightDB = rightDB;
-
-                    for(int i = 0; i < arraySamples.size(); i++){
-                        rollingFreqBuffer.push_back(arraySamples[i]);
-                        //hop with size of samples per draw call;
-                        //if buffer is full, compute FFT and remove samples
-                        if(rollingFreqBuffer.size() >= samplesPerDrawCall){
-                            //fill in input array and compute FFT
-                            std::fill(leftIn, leftIn + NUM_FFT_SAMPLES, 0.0);
-                            std::fill(rightIn, rightIn + NUM_FFT_SAMPLES, 0.0);
-                            int idx = 0;
-                            for(int i = 0; i < rollingFreqBuffer.size(); i+=2){
-                                leftIn[idx] = (double) rollingFreqBuffer[i];
-                                rightIn[idx] = (double) rollingFreqBuffer[i+1];
-                                idx++;
-                            }
-                            fftw_execute(freqGraphPlanLeft);
-                            fftw_execute(freqGraphPlanRight);
-                            //update frequency bars
-                            updateFreqValues(freqGraph, currentTheme, 
-                                        freqGraphObj.mappedPositions, freqGraphObj.mappedIndices, 
-                                        leftOut, rightOut, customFreqSpacingTable);
-                            //clear output values after frequency change
-                            for(int i = 0; i < (NUM_FFT_SAMPLES/2 + 1); i++){
-                                leftOut[i][0] = 0;
-                                leftOut[i][1] = 0;
-                                rightOut[i][0] = 0;
-                                rightOut[i][1] = 0;
-                            }
-                            //remove samples after fft computation
-                            for(int j = 0; j < samplesPerDrawCall; j++){
-                                rollingFreqBuffer.pop_front();
-                            }
+                    for(size_t hop = 0; hop < hopsDue; hop++){
+                        TRACE_SCOPE("analysis hop");
+                        {
+                            PROFILE_SCOPE(PROFILE_RING_DRAIN);
+                            const size_t filled = AuxComputations::fillArrayWithSamples((*audioBuffer.ringBuffer), hopSamples, ANALYSIS_HOP_SAMPLES);
+                            //hopSamples outlives the hop, an underrun must not replay the previous hop's tail
+                            std::fill(hopSamples.begin() + filled, hopSamples.begin() + ANALYSIS_HOP_SAMPLES, 0.0f);
                         }
+                        //one hop per call so every hop reaches the amplitude graph and the spectrogram
+                        const FrameResult& result = engine.process(hopSamples.data(), ANALYSIS_HOP_SAMPLES / 2);
+                        visualizer.update(result);
+                        if(result.hops > 0) spectrogram.addRow(result.spectrum);
+                        scheduler.markAnalysisFrame();
                     }
+                    scheduler.setAudioBacklog((*audioBuffer.ringBuffer).getSize());
                 }
                 if(audioBuffer.trackEnded == true){
                     audioDeviceStatus = INACTIVE;
                     toggleFileSelector = true;
                 }
-                // model handles the objects view
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), translation);
-                // all three are multiplied together (in reverse order due to column ordered matrices)
-                glm::mat4 mvp = proj * view * model;
+                const float alpha = scheduler.getInterpolationAlpha();
+                const double frameTime = glfwGetTime();
+                frameConstants.time = glm::vec4(frameTime - startTime, frameTime - previousFrameTime, alpha, (float)frameNumber++);
+                previousFrameTime = frameTime;
+                visualizer.fillFrameConstants(frameConstants);
+                frameConstantsBuffer.Update(&frameConstants, sizeof(frameConstants));
+                Profiler::Get().beginGpu(PROFILE_GPU_VISUALIZER);
+                TRACE_BEGIN("draw");
+                if(showSpectrogram) spectrogram.draw(renderer);
                 shader.Bind();
-                shader.SetUniformMat4f("u_MVP", mvp);
-                renderer.Draw(ampGraphObj.va, ampGraphObj.ib, shader);
-                renderer.Draw(dbMeterObj.va, dbMeterObj.ib, shader);
-                renderer.Draw(freqGraphObj.va, freqGraphObj.ib, shader);
+                paletteTexture.Bind(PALETTE_TEXTURE_UNIT);
+                shader.SetUniform1i(anchorUniform, LAYOUT_ANCHOR_GRAPHS);
+                visualizer.draw(renderer, shader, alpha);
+                shader.SetUniform1i(anchorUniform, LAYOUT_ANCHOR_TOP_LEFT);
                 renderer.Draw(borderButtonObj.va, borderButtonObj.ib, shader);
                 if(audioDeviceStatus == PLAYING){
                     renderer.Draw(pauseButtonObj.va, pauseButtonObj.ib, shader);
@@ -732,12 +671,21 @@ int main(){
                 if(audioDeviceStatus <= PAUSED){
                     renderer.Draw(startButtonObj.va, startButtonObj.ib, shader);
                 }
+                renderer.Draw(recordButtonObj.va, recordButtonObj.ib, shader);
+                shader.SetUniform1i(anchorUniform, LAYOUT_ANCHOR_TOP_RIGHT);
+                renderer.Draw(fileBorderObj.va, fileBorderObj.ib, shader);
                 renderer.Draw(fileButtonObj.va, fileButtonObj.ib, shader);
-                if(!cursorPressedBefore && canSelectFile && checkMousePos(window, borderFile) == true){
+                Profiler::Get().endGpu(PROFILE_GPU_VISUALIZER);
+                TRACE_END("draw");
+                if(!cursorPressedBefore && checkMousePos(window, recordBorder, windowLayout, LAYOUT_ANCHOR_TOP_LEFT) == true){
+                    toggleRecording = true;
+                    cursorPressedBefore = true;
+                }
+                if(!cursorPressedBefore && canSelectFile && checkMousePos(window, borderFile, windowLayout, LAYOUT_ANCHOR_TOP_RIGHT) == true){
                     if(pickFile() == true) resetGraphs = true;
                     cursorPressedBefore = true;
                 }
-                if(!cursorPressedBefore && checkMousePos(window, border) == true){
+                if(!cursorPressedBefore && checkMousePos(window, border, windowLayout, LAYOUT_ANCHOR_TOP_LEFT) == true){
                     key_callback(window, GLFW_KEY_SPACE, 0, GLFW_PRESS, 0);
                     cursorPressedBefore = true;
                 }
@@ -753,109 +701,166 @@ int main(){
                         canSelectFile = true;
                         borderFileInterior.changeColor(btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
                     }
-                    borderFileInterior.fillVertices(borderButtonObj.mappedPositions, 
-                        NUM_TOTAL_VERTEX_POINTS*(borderIterator - 1));
+                    borderFileInterior.fillVertices(fileBorderObj.mappedVertices, NUM_VERTICES_PER_SAMPLE);
                     toggleFileSelector = false;
                 }
                 if(resetGraphs == true){
-                    //reset all graphs
-                    ampGraph.clear();
-                    currentTheme->resetSecondaryIterator();
-                    freqGraph.clear();
-                    currentTheme->resetPrimaryIterator();
-                    generateGraph(ampGraph, ampGraphObj.mappedPositions, 
-                        ampGraphObj.mappedIndices, funcTable, currentTheme);
-                    generateFreqGraph(freqGraph, freqGraphObj.mappedPositions, 
-                        freqGraphObj.mappedIndices, funcTable, currentTheme);
-                    //reset decibel meters
-                    leftDecibelMeter.changeWidth(DECIBEL_METER_MAX_LENGTH);
-                    leftDecibelMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
-                    leftDecibelMeter.fillVertices(dbMeterObj.mappedPositions, 
-                        NUM_TOTAL_VERTEX_POINTS*(dbIterator - 2));
-                    rightDecibelMeter.changeWidth(DECIBEL_METER_MAX_LENGTH);
-                    rightDecibelMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
-                    rightDecibelMeter.fillVertices(dbMeterObj.mappedPositions, 
-                        NUM_TOTAL_VERTEX_POINTS*(dbIterator - 1));
+                    //the pipeline thread owns the engine and the ring buffer while it runs
+                    if(pipeline) pipeline->stop();
+                    //reset all graphs and decibel meters
+                    visualizer.reset(currentTheme);
+                    spectrogram.clear();
+                    engine.reset(visualizer.getFreqGraph().getLeftHeights(), visualizer.getFreqGraph().getRightHeights());
                     //destroy current device (old filepath)
                     destroyDevice(device, decoder, audioBuffer);
                     //create new device with new filepath
-                    createDevice(device, decoder, filepath.c_str(), audioBuffer);
+                    createDevice(device, decoder, filepath.c_str(), audioBuffer, &context);
+                    if(pipeline) pipeline->start(*audioBuffer.ringBuffer);
                     audioBuffer.trackEnded = false;
+                    scheduler.resetAnalysis();
                     audioDeviceStatus = PAUSED;
                     resetGraphs = false;
                 }
                 if(changeTheme == true){
-                    currentTheme = &themeTable.at(currentThemeType);
-                    currentTheme->resetPrimaryIterator();
-                    currentTheme->resetSecondaryIterator();
+                    currentTheme = &themeTable[currentThemeType];
                     bgColorTheme = currentTheme->getBG();
                     btColorTheme = currentTheme->getButton();
                     borderInterior.changeColor(btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
-                    borderInterior.fillVertices(borderButtonObj.mappedPositions, NUM_TOTAL_VERTEX_POINTS*(borderIterator - 2));
+                    borderInterior.fillVertices(borderButtonObj.mappedVertices, NUM_VERTICES_PER_SAMPLE);
                     if(audioDeviceStatus == PLAYING){
                         borderFileInterior.changeColor(0.7f, 0.7f, 0.7f, 1.0f);
                     }
                     else{
                         borderFileInterior.changeColor(btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
                     }
-                    borderFileInterior.fillVertices(borderButtonObj.mappedPositions, NUM_TOTAL_VERTEX_POINTS*(borderIterator - 1));
-                    changeGraphThemes(ampGraph, freqGraph, ampGraphObj.mappedPositions, freqGraphObj.mappedPositions, currentTheme);
+                    borderFileInterior.fillVertices(fileBorderObj.mappedVertices, NUM_VERTICES_PER_SAMPLE);
+                    recordInterior.changeColor(btColorTheme.r, btColorTheme.g, btColorTheme.b, btColorTheme.a);
+                    recordInterior.fillVertices(recordButtonObj.mappedVertices, NUM_VERTICES_PER_SAMPLE);
+                    visualizer.setTheme(currentTheme);
                     changeTheme = false;
                 }
+                if(toggleRecording == true){
+                    if(capture->IsRecording()){
+                        capture->Stop();
+                        std::cout << "Recording stopped (" << capture->GetFramesCaptured() << " frames, " 
+                            << capture->GetFramesDropped() << " dropped, " << capture->GetFramesRepeated() 
+                            << " repeated)" << std::endl;
+                        recordDot.changeColor(0.4f, 0.0f, 0.0f, 1.0f);
+                    }
+                    else{
+                        //a recording keeps the frame size it started with, the next one reads the current framebuffer
+                        if(capture->GetWidth() != windowLayout.getWidth() || capture->GetHeight() != windowLayout.getHeight()){
+                            capture.reset(new FrameCapture(windowLayout.getWidth(), windowLayout.getHeight()));
+                        }
+                        std::string path = recordingPath();
+                        if(capture->Start(FrameWriter::Y4M, path, ANALYSIS_RATE)){
+                            std::cout << "Recording to " << path << std::endl;
+                            recordDot.changeColor(0.95f, 0.1f, 0.1f, 1.0f);
+                        }
+                    }
+                    recordDot.fillVertices(recordButtonObj.mappedVertices, NUM_VERTICES_PER_SAMPLE*2);
+                    toggleRecording = false;
+                }
             }
+            //the recording shows the visualizer without the ImGui windows
+            capture->Capture();
 
+            TRACE_BEGIN("imgui");
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
 
             {
-                ImGui::SetNextWindowPos(ImVec2(dbXPos + DECIBEL_METER_MAX_LENGTH + 50, 
-                    WINDOW_HEIGHT - dbYPos - 80), ImGuiCond_Once);
-                ImGui::SetNextWindowSize(ImVec2(WINDOW_WIDTH/2 + 20, 100), ImGuiCond_Once);
+                //placed in design units next to the geometry they belong to
+                const ImGuiCond placement = placeWindows ? ImGuiCond_Always : ImGuiCond_Once;
+                const glm::vec2 infoPos = windowLayout.designToWindow(LAYOUT_ANCHOR_GRAPHS, 
+                    glm::vec2(DECIBEL_METER_XPOS + DECIBEL_METER_MAX_LENGTH + 50, DECIBEL_METER_YPOS + 80));
+                const float graphScale = windowLayout.getWindowScale(LAYOUT_ANCHOR_GRAPHS);
+                ImGui::SetNextWindowPos(ImVec2(infoPos.x, infoPos.y), placement);
+                ImGui::SetNextWindowSize(ImVec2((WINDOW_WIDTH/2 + 20) * graphScale, 150 * graphScale), placement);
                 ImGui::Begin("Information");
                 ImGui::TextWrapped("Now Playing: %s", filename.c_str());
 
                 // ImGui::SliderFloat3("Translation", &translation.x, -WINDOW_WIDTH, WINDOW_WIDTH);
                 ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 
                     1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+                ImGui::Text("Frame interval %.2f ms, jitter %.2f ms, worst %.2f ms", 
+                    scheduler.getAverageFrameMs(), scheduler.getJitterMs(), scheduler.getMaxFrameMs());
+                ImGui::Text("Analysis %.0f Hz (%llu hops, %llu dropped), latency %.1f ms", 
+                    scheduler.getAnalysisRate(), scheduler.getAnalysisFrames(), 
+                    scheduler.getDroppedHops(), scheduler.getLatencyMs());
+                bool vsync = scheduler.getSwapInterval() != 0;
+                if(ImGui::Checkbox("VSync", &vsync)) scheduler.setSwapInterval(vsync ? 1 : 0);
+                ImGui::SameLine();
+                int fpsCap = scheduler.getFpsCap();
+                ImGui::SetNextItemWidth(150.0f * windowLayout.getWindowScale(LAYOUT_ANCHOR_TOP_LEFT));
+                if(ImGui::SliderInt("FPS cap (0 = off)", &fpsCap, 0, 240)) scheduler.setFpsCap(fpsCap);
+                ImGui::Checkbox("Profiler", &showProfiler);
+                ImGui::SameLine();
+                ImGui::Checkbox("Spectrogram (S)", &showSpectrogram);
+                if(showSpectrogram){
+                    float seconds = spectrogram.getVisibleSeconds();
+                    ImGui::SetNextItemWidth(150.0f * windowLayout.getWindowScale(LAYOUT_ANCHOR_TOP_LEFT));
+                    if(ImGui::SliderFloat("History (s)", &seconds, 1.0f, spectrogram.getHistorySeconds(), "%.0f")){
+                        spectrogram.setVisibleSeconds(seconds);
+                    }
+                }
+                if(capture->IsRecording()){
+                    ImGui::Text("Recording (R): %llu frames, %llu dropped, %llu repeated%s", capture->GetFramesCaptured(), 
+                        capture->GetFramesDropped(), capture->GetFramesRepeated(), capture->HasWriteFailed() ? ", write failed" : "");
+                }
                 ImGui::End();
 
-                ImGui::SetNextWindowPos(ImVec2(2*WINDOW_MARGIN + border_icon_size, WINDOW_MARGIN), ImGuiCond_Once);
-                ImGui::SetNextWindowSize(ImVec2(WINDOW_WIDTH - 4*WINDOW_MARGIN - 2*border_icon_size, 100), ImGuiCond_Once);
-                float spacing = 10.0f;
-                float buttonHeight = 30.0f;
-                std::vector<std::string> themeTexts = {"Default", "Light Rainbow", "Teal Warm", "Purple Blue", "Yellow Grayscale", "Neon Rainbow"};
+                //between the record button (top left) and the file button (top right)
+                const float uiScale = windowLayout.getWindowScale(LAYOUT_ANCHOR_TOP_LEFT);
+                const glm::vec2 selectorStart = windowLayout.designToWindow(LAYOUT_ANCHOR_TOP_LEFT, 
+                    glm::vec2(recordXpos + record_icon_size + WINDOW_MARGIN, WINDOW_HEIGHT - WINDOW_MARGIN));
+                const glm::vec2 selectorEnd = windowLayout.designToWindow(LAYOUT_ANCHOR_TOP_RIGHT, 
+                    glm::vec2(fileBorderXpos - WINDOW_MARGIN, WINDOW_HEIGHT - WINDOW_MARGIN));
+                ImGui::SetNextWindowPos(ImVec2(selectorStart.x, selectorStart.y), placement);
+                ImGui::SetNextWindowSize(ImVec2(std::max(selectorEnd.x - selectorStart.x, 100.0f), 
+                    100 * uiScale), placement);
+                float spacing = 10.0f * uiScale;
+                float buttonHeight = 30.0f * uiScale;
 
                 ImGui::Begin("Theme Selector");
-                for (int i = 0; i < themeTexts.size(); ++i){
-                    float buttonWidth = 10.0f * themeTexts[i].size();
+                for (size_t i = 0; i < themeTable.size(); ++i){
+                    const std::string& themeName = themeTable[i].getName();
+                    float buttonWidth = 10.0f * uiScale * themeName.size();
                     // Check available width to wrap
                     if (buttonWidth >= ImGui::GetContentRegionAvail().x) ImGui::NewLine();
 
-                    if(ImGui::Button(themeTexts[i].c_str(), ImVec2(buttonWidth, buttonHeight))){
+                    if(ImGui::Button(themeName.c_str(), ImVec2(buttonWidth, buttonHeight))){
                         useSelectedTheme = true;
-                        currentThemeType = static_cast<ColorThemes::ThemeType>(i);
+                        currentThemeType = (int)i;
                         key_callback(window, GLFW_KEY_TAB, 0, GLFW_PRESS, 0);
                     }
-                    if(i < themeTexts.size() - 1) ImGui::SameLine(0.0f, spacing);
+                    if(i < themeTable.size() - 1) ImGui::SameLine(0.0f, spacing);
                 }
                 ImGui::End();
             }
+            if(showProfiler) Profiler::Get().drawOverlay();
             ImGui::Render();
+            Profiler::Get().beginGpu(PROFILE_GPU_UI);
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            Profiler::Get().endGpu(PROFILE_GPU_UI);
+            TRACE_END("imgui");
     
+            scheduler.endFrame();
+            TRACE_BEGIN("swap");
             glfwSwapBuffers(window);
+            TRACE_END("swap");
             glfwPollEvents();
         }
         // printRingBufferContents(*audioBuffer.ringBuffer);
-        destroyDevice(device, decoder, audioBuffer);
-        fftw_free(leftIn);
-        fftw_free(leftOut);
-        fftw_free(rightIn);
-        fftw_free(rightOut);
-        fftw_destroy_plan(freqGraphPlanLeft);
-        fftw_destroy_plan(freqGraphPlanRight);
+        capture->Stop();
+        if(pipeline) pipeline->stop();
+        if(liveInput) destroyCaptureDevice(device, audioBuffer);
+        else destroyDevice(device, decoder, audioBuffer);
+        ma_context_uninit(&context);
     }
+    if(Tracer::IsEnabled()) Tracer::Dump();
+    Profiler::Get().destroyGpu();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
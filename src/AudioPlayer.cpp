@@ -1,8 +1,21 @@
 #include "AudioPlayer.h"
+#include "Profiler.h"
+#include "Tracer.h"
+#include "VisualizerConfig.h"
+
+#include <algorithm>
+#include <cstring>
+
+//hops of interleaved samples a live input may buffer, enough to ride out a slow frame without adding latency
+#define CAPTURE_BUFFER_HOPS 8
 
 void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount){
+    PROFILE_SCOPE(PROFILE_DECODE);
     TrackRingBuffer* audioBuffer = (TrackRingBuffer*)pDevice->pUserData;
     if (audioBuffer == NULL) return;
+    TRACE_BIND_THREAD(audioBuffer->trace);
+    TRACE_THREAD_NAME("audio callback");
+    TRACE_SCOPE("data_callback");
     //prevent unnecessary reads from being written into the buffer
     if(audioBuffer->trackEnded) return;
 
@@ -10,7 +23,9 @@ void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uin
     if (pDecoder == NULL) return;
 
     ma_uint64 framesRead = 0;
+    TRACE_BEGIN("decode");
     int result = ma_decoder_read_pcm_frames(pDecoder, pOutput, frameCount, &framesRead);
+    TRACE_END("decode");
 
     //track whether or not track has ended
     audioBuffer->trackEnded = (result == MA_AT_END) || (framesRead < frameCount);
@@ -23,20 +38,51 @@ void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uin
         }
         // printf("Sample[%d]: %f\n", i, samples[i]);  // <-- You can process here
     }
+    TRACE_COUNTER("ring buffer samples", (*audioBuffer->ringBuffer).getSize());
 
     (void)pInput; // Avoid unused warning
 }
 
-int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, TrackRingBuffer& audioBuffer){
-    ma_result result;
-    ma_device_config deviceConfig;
+void capture_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount){
+    TrackRingBuffer* audioBuffer = (TrackRingBuffer*)pDevice->pUserData;
+    if (audioBuffer == NULL || pInput == NULL) return;
+    TRACE_BIND_THREAD(audioBuffer->trace);
+    TRACE_THREAD_NAME("audio callback");
+    TRACE_SCOPE("capture_callback");
+
+    const float* samples = (const float*)pInput;
+    const ma_uint32 channels = pDevice->capture.channels;
+    //analysis fell behind, drop the newest frames instead of growing the latency
+    //whole frames only, a partial frame would swap the channels of every sample after it
+    const ma_uint32 framesFree = (ma_uint32)((*audioBuffer->ringBuffer).getFreeSpace() / channels);
+    const ma_uint32 framesPushed = std::min(frameCount, framesFree);
+    for (ma_uint32 i = 0; i < framesPushed * channels; ++i) {
+        (*audioBuffer->ringBuffer).push(samples[i]);
+    }
+    TRACE_COUNTER("ring buffer samples", (*audioBuffer->ringBuffer).getSize());
+
+    //duplex: play the input back so the source can be monitored
+    if(pOutput != NULL){
+        std::memcpy(pOutput, pInput, frameCount * pDevice->capture.channels * sizeof(float));
+    }
+}
+
+int createDecoder(ma_decoder& decoder, const char* filepath){
     ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, 48000);
 
-    result = ma_decoder_init_file(filepath, &config, &decoder);
+    ma_result result = ma_decoder_init_file(filepath, &config, &decoder);
     if (result != MA_SUCCESS) {
         printf("Failed to open audio file.\n");
         return -1;
     }
+    return 0;
+}
+
+int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, TrackRingBuffer& audioBuffer, ma_context* context){
+    ma_result result;
+    ma_device_config deviceConfig;
+
+    if(createDecoder(decoder, filepath) != 0) return -1;
 
     long long unsigned int lengthTrack = 0;
     //length of track in pcm frames = subchunk2size / (num bytes per sample * num channels)
@@ -45,7 +91,7 @@ int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, T
     int safetyFactor = 2;
     RingBuffer<float>* ringBuffer = new RingBuffer<float>(lengthTrack * decoder.outputChannels * safetyFactor);
 
-    audioBuffer = {ringBuffer, false, decoder};
+    audioBuffer = {ringBuffer, false, decoder, Tracer::ReserveThread()};
 
     deviceConfig = ma_device_config_init(ma_device_type_playback);
     deviceConfig.playback.format   = decoder.outputFormat;
@@ -54,10 +100,100 @@ int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, T
     deviceConfig.dataCallback      = data_callback;
     deviceConfig.pUserData         = &audioBuffer;
 
-    result = ma_device_init(NULL, &deviceConfig, &device);
+    result = ma_device_init(context, &deviceConfig, &device);
     if (result != MA_SUCCESS) {
         printf("Failed to initialize playback device.\n");
         ma_decoder_uninit(&decoder);
+        Tracer::ReleaseThread(audioBuffer.trace);
+        audioBuffer.trace = NULL;
+        return -2;
+    }
+    return 0;
+}
+
+int createContext(ma_context& context, bool useNullBackend){
+    ma_backend nullBackend[] = {ma_backend_null};
+    ma_result result = useNullBackend ? ma_context_init(nullBackend, 1, NULL, &context) : ma_context_init(NULL, 0, NULL, &context);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize audio context.\n");
+        return -1;
+    }
+    return 0;
+}
+
+void listAudioDevices(ma_context& context){
+    ma_device_info* playbackInfos;
+    ma_uint32 playbackCount;
+    ma_device_info* captureInfos;
+    ma_uint32 captureCount;
+    if (ma_context_get_devices(&context, &playbackInfos, &playbackCount, &captureInfos, &captureCount) != MA_SUCCESS) {
+        printf("Failed to enumerate audio devices.\n");
+        return;
+    }
+    std::cout << "Audio backend: " << ma_get_backend_name(context.backend) << std::endl;
+    std::cout << "Capture devices (--capture/--duplex <index>):" << std::endl;
+    for (ma_uint32 i = 0; i < captureCount; i++) {
+        std::cout << "  " << i << ": " << captureInfos[i].name << (captureInfos[i].isDefault ? " [default]" : "") << std::endl;
+    }
+    std::cout << "Playback devices (--loopback <index>):" << std::endl;
+    for (ma_uint32 i = 0; i < playbackCount; i++) {
+        std::cout << "  " << i << ": " << playbackInfos[i].name << (playbackInfos[i].isDefault ? " [default]" : "") << std::endl;
+    }
+}
+
+int createCaptureDevice(ma_context& context, ma_device& device, const AudioInputOptions& options, 
+    TrackRingBuffer& audioBuffer, std::string& deviceName){
+    ma_device_type deviceType = ma_device_type_capture;
+    if (options.mode == AUDIO_INPUT_DUPLEX) deviceType = ma_device_type_duplex;
+    if (options.mode == AUDIO_INPUT_LOOPBACK) deviceType = ma_device_type_loopback;
+
+    //capture and duplex pick a capture device, loopback picks the playback device it listens to
+    ma_device_id* deviceID = NULL;
+    deviceName = "default";
+    if (options.deviceIndex >= 0) {
+        ma_device_info* playbackInfos;
+        ma_uint32 playbackCount;
+        ma_device_info* captureInfos;
+        ma_uint32 captureCount;
+        if (ma_context_get_devices(&context, &playbackInfos, &playbackCount, &captureInfos, &captureCount) != MA_SUCCESS) {
+            printf("Failed to enumerate audio devices.\n");
+            return -1;
+        }
+        ma_device_info* infos = deviceType == ma_device_type_loopback ? playbackInfos : captureInfos;
+        ma_uint32 count = deviceType == ma_device_type_loopback ? playbackCount : captureCount;
+        if ((ma_uint32)options.deviceIndex >= count) {
+            printf("No audio device with index %d.\n", options.deviceIndex);
+            return -1;
+        }
+        deviceID = &infos[options.deviceIndex].id;
+        deviceName = infos[options.deviceIndex].name;
+    }
+
+    //+1 for the slot that always stays empty, so the usable space holds whole stereo frames
+    RingBuffer<float>* ringBuffer = new RingBuffer<float>(CAPTURE_BUFFER_HOPS * ANALYSIS_HOP_SAMPLES + 1);
+    audioBuffer.ringBuffer = ringBuffer;
+    audioBuffer.trackEnded = false;
+    audioBuffer.trace = Tracer::ReserveThread();
+
+    ma_device_config deviceConfig = ma_device_config_init(deviceType);
+    deviceConfig.capture.pDeviceID   = deviceID;
+    deviceConfig.capture.format      = ma_format_f32;
+    deviceConfig.capture.channels    = 2;
+    deviceConfig.playback.format     = ma_format_f32;
+    deviceConfig.playback.channels   = 2;
+    deviceConfig.sampleRate          = AUDIO_SAMPLE_RATE;
+    deviceConfig.periodSizeInFrames  = options.periodFrames;
+    deviceConfig.performanceProfile  = ma_performance_profile_low_latency;
+    deviceConfig.dataCallback        = capture_callback;
+    deviceConfig.pUserData           = &audioBuffer;
+
+    ma_result result = ma_device_init(&context, &deviceConfig, &device);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize capture device (%s).\n", ma_result_description(result));
+        delete audioBuffer.ringBuffer;
+        audioBuffer.ringBuffer = NULL;
+        Tracer::ReleaseThread(audioBuffer.trace);
+        audioBuffer.trace = NULL;
         return -2;
     }
     return 0;
@@ -101,5 +237,15 @@ void destroyDevice(ma_device& device, ma_decoder& decoder, TrackRingBuffer& audi
     ma_device_uninit(&device);
     ma_decoder_uninit(&decoder);
     delete audioBuffer.ringBuffer;
+    Tracer::ReleaseThread(audioBuffer.trace);
+    audioBuffer.trace = NULL;
     return;
 }
+
+void destroyCaptureDevice(ma_device& device, TrackRingBuffer& audioBuffer){
+    ma_device_uninit(&device);
+    delete audioBuffer.ringBuffer;
+    audioBuffer.ringBuffer = NULL;
+    Tracer::ReleaseThread(audioBuffer.trace);
+    audioBuffer.trace = NULL;
+}
@@ -2,19 +2,60 @@
 
 #include <stdio.h>
 #include <iostream>
+#include <string>
 #include "RingBuffer.hpp"
+#include "Tracer.h"
 
 #include "vendor/miniaudio/miniaudio.h"
 
+//where the analyzed audio comes from
+typedef enum{
+    AUDIO_INPUT_FILE = 0, //decoded track played back on the output device
+    AUDIO_INPUT_CAPTURE,  //line-in, microphone or a monitor source of the system output (e.g. PulseAudio "Monitor of ...")
+    AUDIO_INPUT_DUPLEX,   //capture device, played back on the output device as well (monitoring)
+    AUDIO_INPUT_LOOPBACK  //whatever an output device is playing (WASAPI only)
+} AudioInputMode;
+
+typedef struct{
+    AudioInputMode mode;
+    //index printed by listAudioDevices() (capture devices, playback devices for loopback), -1 = system default
+    int deviceIndex;
+    //frames per device callback, 0 = backend default; small periods lower latency at the cost of more callbacks
+    unsigned int periodFrames;
+    //null backend: runs on a timer without audio hardware (captures silence, discards playback)
+    bool useNullBackend;
+} AudioInputOptions;
+
 typedef struct{
     RingBuffer<float> *ringBuffer;
     bool trackEnded;
     ma_decoder decoder;
+    //trace buffer of the device's callback thread, reserved so the callback never allocates
+    ThreadTrace* trace;
 } TrackRingBuffer;
 
 void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
 
-int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, TrackRingBuffer& audioBuffer);
+//pushes captured frames into the ring buffer (and through to the output in duplex mode)
+void capture_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
+
+//opens a track as interleaved stereo f32 at 48kHz (the format every analysis step assumes)
+int createDecoder(ma_decoder& decoder, const char* filepath);
+
+//context = NULL uses the default backends
+int createDevice(ma_device& device, ma_decoder& decoder, const char* filepath, TrackRingBuffer& audioBuffer, ma_context* context = NULL);
+
+//initializes the default backends, or only the null backend
+int createContext(ma_context& context, bool useNullBackend);
+
+//prints the playback and capture devices of a context with the indices AudioInputOptions::deviceIndex expects
+void listAudioDevices(ma_context& context);
+
+//opens a live input (capture, duplex or loopback) as interleaved stereo f32 at 48kHz, the same format as a track
+//the ring buffer only holds a few hops, if analysis falls behind the newest frames are dropped
+//returns 0 on success, the device name (or "default") is written to deviceName
+int createCaptureDevice(ma_context& context, ma_device& device, const AudioInputOptions& options, 
+    TrackRingBuffer& audioBuffer, std::string& deviceName);
 
 void startAudioCallback(ma_device& device);
 
@@ -22,4 +63,6 @@ void stopAudioCallback(ma_device& device);
 
 void printRingBufferContents(RingBuffer<float>& ringBuffer);
 
-void destroyDevice(ma_device& device, ma_decoder& decoder, TrackRingBuffer& audioBuffer);
\ No newline at end of file
+void destroyDevice(ma_device& device, ma_decoder& decoder, TrackRingBuffer& audioBuffer);
+
+void destroyCaptureDevice(ma_device& device, TrackRingBuffer& audioBuffer);
\ No newline at end of file
@@ -1,11 +1,22 @@
 #include "AuxComputations.h"
+#include <cmath>
+#include <cstring>
 
-void AuxComputations::fillArrayWithSamples(RingBuffer<float>& ringBuffer, std::vector<float>& outArray, size_t amtOfSamples){
-    for(int i = 0; i < amtOfSamples; i++){
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HSB_SIMD_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define HSB_SIMD_NEON 1
+#endif
+
+size_t AuxComputations::fillArrayWithSamples(RingBuffer<float>& ringBuffer, std::vector<float>& outArray, size_t amtOfSamples){
+    for(size_t i = 0; i < amtOfSamples; i++){
         if(!ringBuffer.pop(outArray[i])){
-            break;
+            return i;
         }
     }
+    return amtOfSamples;
 }
 
 void AuxComputations::HSBtoRGBA(int h, float s, float b, AuxComputations::RGBAColor& target){
@@ -16,7 +27,8 @@ void AuxComputations::HSBtoRGBA(int h, float s, float b, AuxComputations::RGBACo
     if(b > 1) b = 1;
 
     float c = b * s;
-    float x = c * (1 - abs((fmod(h/60.0f, 2.0f) - 1)));
+    //fabsf: plain abs can resolve to the int overload and truncate the distance to 0
+    float x = c * (1 - fabsf(fmodf(h/60.0f, 2.0f) - 1));
     float m = b - c;
     AuxComputations::RGBAColor primes = {0, 0, 0, 0};
     if(h >= 0 && h < 60) primes = {c, x, 0};
@@ -29,6 +41,199 @@ void AuxComputations::HSBtoRGBA(int h, float s, float b, AuxComputations::RGBACo
     target = {primes.r + m, primes.g + m, primes.b + m, target.a};
 }
 
+//batch conversion, 4 colors per step: every channel is brightness * (1 - saturation * t) with
+//t = clamp(min(k, 4 - k), 0, 1) and k = (n + hue / 60) mod 6 (n = 5, 3, 1 for r, g, b), the sector cases of HSBtoRGBA
+//folded into min/max so all lanes run the same instructions
+#define HSB_LANES 4
+
+#if HSB_SIMD_SSE2
+static inline __m128 floor4(__m128 x){
+    //sse2 has no floor: truncate, then step down where truncation rounded up (negative values)
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+}
+
+static inline __m128 clamp4(__m128 x){
+    return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+static inline __m128 channel4(__m128 sector, float n, __m128 brightness, __m128 chroma){
+    const __m128 six = _mm_set1_ps(6.0f);
+    __m128 k = _mm_add_ps(sector, _mm_set1_ps(n));
+    k = _mm_sub_ps(k, _mm_and_ps(_mm_cmpge_ps(k, six), six));
+    __m128 t = clamp4(_mm_min_ps(k, _mm_sub_ps(_mm_set1_ps(4.0f), k)));
+    return _mm_sub_ps(brightness, _mm_mul_ps(chroma, t));
+}
+
+static inline void hsb4(const float* hues, const float* saturations, const float* brightnesses, __m128& r, __m128& g, __m128& b){
+    const __m128 turn = _mm_set1_ps(360.0f);
+    __m128 hue = floor4(_mm_loadu_ps(hues));
+    hue = _mm_sub_ps(hue, _mm_mul_ps(floor4(_mm_div_ps(hue, turn)), turn));
+    __m128 sector = _mm_div_ps(hue, _mm_set1_ps(60.0f));
+    __m128 brightness = clamp4(_mm_loadu_ps(brightnesses));
+    __m128 chroma = _mm_mul_ps(clamp4(_mm_loadu_ps(saturations)), brightness);
+    r = channel4(sector, 5.0f, brightness, chroma);
+    g = channel4(sector, 3.0f, brightness, chroma);
+    b = channel4(sector, 1.0f, brightness, chroma);
+}
+
+static inline void storeRGBA4(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    AuxComputations::RGBAColor* target){
+    __m128 r, g, b;
+    hsb4(hues, saturations, brightnesses, r, g, b);
+    __m128 a = _mm_loadu_ps(alphas);
+    //channel vectors to one rgba vector per color
+    _MM_TRANSPOSE4_PS(r, g, b, a);
+    float* out = &target[0].r;
+    _mm_storeu_ps(out, r);
+    _mm_storeu_ps(out + 4, g);
+    _mm_storeu_ps(out + 8, b);
+    _mm_storeu_ps(out + 12, a);
+}
+
+static inline __m128i byte4(__m128 x){
+    //same rounding as PackColorChannel
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamp4(x), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+static inline void storeRGBA84(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    unsigned char* target){
+    __m128 r, g, b;
+    hsb4(hues, saturations, brightnesses, r, g, b);
+    //r | g << 8 | b << 16 | a << 24 is the byte order r, g, b, a in memory (little endian)
+    __m128i rgba = _mm_or_si128(_mm_or_si128(byte4(r), _mm_slli_epi32(byte4(g), 8)),
+        _mm_or_si128(_mm_slli_epi32(byte4(b), 16), _mm_slli_epi32(byte4(_mm_loadu_ps(alphas)), 24)));
+    _mm_storeu_si128((__m128i*)target, rgba);
+}
+#elif HSB_SIMD_NEON
+static inline float32x4_t clamp4(float32x4_t x){
+    return vminq_f32(vmaxq_f32(x, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+}
+
+static inline float32x4_t channel4(float32x4_t sector, float n, float32x4_t brightness, float32x4_t chroma){
+    const float32x4_t six = vdupq_n_f32(6.0f);
+    float32x4_t k = vaddq_f32(sector, vdupq_n_f32(n));
+    k = vsubq_f32(k, vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(k, six), vreinterpretq_u32_f32(six))));
+    float32x4_t t = clamp4(vminq_f32(k, vsubq_f32(vdupq_n_f32(4.0f), k)));
+    return vmlsq_f32(brightness, chroma, t);
+}
+
+static inline void hsb4(const float* hues, const float* saturations, const float* brightnesses,
+    float32x4_t& r, float32x4_t& g, float32x4_t& b){
+    const float32x4_t turn = vdupq_n_f32(360.0f);
+    float32x4_t hue = vrndmq_f32(vld1q_f32(hues));
+    hue = vmlsq_f32(hue, vrndmq_f32(vdivq_f32(hue, turn)), turn);
+    float32x4_t sector = vdivq_f32(hue, vdupq_n_f32(60.0f));
+    float32x4_t brightness = clamp4(vld1q_f32(brightnesses));
+    float32x4_t chroma = vmulq_f32(clamp4(vld1q_f32(saturations)), brightness);
+    r = channel4(sector, 5.0f, brightness, chroma);
+    g = channel4(sector, 3.0f, brightness, chroma);
+    b = channel4(sector, 1.0f, brightness, chroma);
+}
+
+static inline void storeRGBA4(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    AuxComputations::RGBAColor* target){
+    float32x4x4_t rgba;
+    hsb4(hues, saturations, brightnesses, rgba.val[0], rgba.val[1], rgba.val[2]);
+    rgba.val[3] = vld1q_f32(alphas);
+    //interleaving store, one rgba color per 16 bytes
+    vst4q_f32(&target[0].r, rgba);
+}
+
+static inline uint32x4_t byte4(float32x4_t x){
+    //same rounding as PackColorChannel
+    return vcvtq_u32_f32(vmlaq_f32(vdupq_n_f32(0.5f), clamp4(x), vdupq_n_f32(255.0f)));
+}
+
+static inline void storeRGBA84(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    unsigned char* target){
+    float32x4_t r, g, b;
+    hsb4(hues, saturations, brightnesses, r, g, b);
+    //r | g << 8 | b << 16 | a << 24 is the byte order r, g, b, a in memory (little endian)
+    uint32x4_t rgba = vorrq_u32(vorrq_u32(byte4(r), vshlq_n_u32(byte4(g), 8)),
+        vorrq_u32(vshlq_n_u32(byte4(b), 16), vshlq_n_u32(byte4(vld1q_f32(alphas)), 24)));
+    vst1q_u8(target, vreinterpretq_u8_u32(rgba));
+}
+#else
+//same steps one lane at a time, floorf/fminf/fmaxf compile to branch-free instructions
+static inline float clamp1(float x){
+    return fminf(fmaxf(x, 0.0f), 1.0f);
+}
+
+static inline float channel1(float sector, float n, float brightness, float chroma){
+    float k = sector + n;
+    k -= 6.0f * (float)(k >= 6.0f);
+    return brightness - chroma * clamp1(fminf(k, 4.0f - k));
+}
+
+static inline void hsb4(const float* hues, const float* saturations, const float* brightnesses, float* r, float* g, float* b){
+    for(int i = 0; i < HSB_LANES; i++){
+        float hue = floorf(hues[i]);
+        hue -= 360.0f * floorf(hue / 360.0f);
+        float sector = hue / 60.0f;
+        float brightness = clamp1(brightnesses[i]);
+        float chroma = clamp1(saturations[i]) * brightness;
+        r[i] = channel1(sector, 5.0f, brightness, chroma);
+        g[i] = channel1(sector, 3.0f, brightness, chroma);
+        b[i] = channel1(sector, 1.0f, brightness, chroma);
+    }
+}
+
+static inline void storeRGBA4(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    AuxComputations::RGBAColor* target){
+    float r[HSB_LANES], g[HSB_LANES], b[HSB_LANES];
+    hsb4(hues, saturations, brightnesses, r, g, b);
+    for(int i = 0; i < HSB_LANES; i++) target[i] = {r[i], g[i], b[i], alphas[i]};
+}
+
+static inline unsigned char byte1(float x){
+    //same rounding as PackColorChannel
+    return (unsigned char)(clamp1(x) * 255.0f + 0.5f);
+}
+
+static inline void storeRGBA84(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    unsigned char* target){
+    float r[HSB_LANES], g[HSB_LANES], b[HSB_LANES];
+    hsb4(hues, saturations, brightnesses, r, g, b);
+    for(int i = 0; i < HSB_LANES; i++){
+        target[4*i + 0] = byte1(r[i]);
+        target[4*i + 1] = byte1(g[i]);
+        target[4*i + 2] = byte1(b[i]);
+        target[4*i + 3] = byte1(alphas[i]);
+    }
+}
+#endif
+
+//the last count % 4 colors go through zero-padded copies, so they take the same path as the rest
+template<typename T, int Channels, void (*Store)(const float*, const float*, const float*, const float*, T*)>
+static void convertBatch(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    size_t count, T* target){
+    size_t i = 0;
+    for(; i + HSB_LANES <= count; i += HSB_LANES){
+        Store(hues + i, saturations + i, brightnesses + i, alphas + i, target + Channels * i);
+    }
+    if(i == count) return;
+    float h[HSB_LANES] = {0}, s[HSB_LANES] = {0}, b[HSB_LANES] = {0}, a[HSB_LANES] = {0};
+    T out[Channels * HSB_LANES];
+    const size_t rest = count - i;
+    memcpy(h, hues + i, rest * sizeof(float));
+    memcpy(s, saturations + i, rest * sizeof(float));
+    memcpy(b, brightnesses + i, rest * sizeof(float));
+    memcpy(a, alphas + i, rest * sizeof(float));
+    Store(h, s, b, a, out);
+    memcpy(target + Channels * i, out, Channels * rest * sizeof(T));
+}
+
+void AuxComputations::HSBtoRGBABatch(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    size_t count, AuxComputations::RGBAColor* target){
+    convertBatch<AuxComputations::RGBAColor, 1, storeRGBA4>(hues, saturations, brightnesses, alphas, count, target);
+}
+
+void AuxComputations::HSBtoRGBA8Batch(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+    size_t count, unsigned char* target){
+    convertBatch<unsigned char, 4, storeRGBA84>(hues, saturations, brightnesses, alphas, count, target);
+}
+
 void AuxComputations::computeRMSValueStereo(std::vector<float>& arraySamples, size_t amtOfSamples, float& leftVal, float& rightVal){
     float sumSquaresLeft = 0.0f;
     float sumSquaresRight = 0.0f;
@@ -12,9 +12,18 @@ namespace AuxComputations{
         float a;
     } RGBAColor;
 
-    void fillArrayWithSamples(RingBuffer<float>& ringBuffer, std::vector<float>& outArray, size_t amtOfSamples);
+    //returns how many samples were popped, on underrun the rest of outArray is left as it was
+    size_t fillArrayWithSamples(RingBuffer<float>& ringBuffer, std::vector<float>& outArray, size_t amtOfSamples);
     
     void HSBtoRGBA(int h, float s, float b, AuxComputations::RGBAColor& target);
+
+    //HSBtoRGBA for count colors at once, without branches and 4 colors per instruction (SSE2 or NEON when available)
+    //hues are floored to whole degrees and wrapped into [0, 360) (negative hues too), saturation and brightness are clamped
+    //results match HSBtoRGBA up to float rounding; the RGBA8 variant writes 4 bytes per color (see PackColorChannel)
+    void HSBtoRGBABatch(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+        size_t count, AuxComputations::RGBAColor* target);
+    void HSBtoRGBA8Batch(const float* hues, const float* saturations, const float* brightnesses, const float* alphas,
+        size_t count, unsigned char* target);
     
     void computeRMSValueStereo(std::vector<float>& arraySamples, size_t amtOfSamples, float& leftVal, float& rightVal);
     
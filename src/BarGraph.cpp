@@ -0,0 +1,138 @@
+#include "BarGraph.h"
+
+#include <cmath>
+#include <cstring>
+
+BarGraph::BarGraph(unsigned int numBars, float basex, float centery, float barWidth, float barStride)
+    : m_NumBars(numBars), m_BaseX(basex), m_CenterY(centery), m_BarWidth(barWidth), m_BarStride(barStride),
+    m_HeightScale(1.0f), m_Dirty(true), m_LeftHeights(numBars, 0.0f), m_RightHeights(numBars, 0.0f),
+    m_PrevLeftHeights(numBars, 0.0f), m_PrevRightHeights(numBars, 0.0f), m_Colors(4*numBars, 0){
+
+}
+
+BarGraph::~BarGraph(){
+
+}
+
+void BarGraph::setBar(unsigned int index, float heightLeft, float heightRight){
+    m_LeftHeights[index] = heightLeft;
+    m_RightHeights[index] = heightRight;
+    m_PrevLeftHeights[index] = heightLeft;
+    m_PrevRightHeights[index] = heightRight;
+    m_Dirty = true;
+}
+
+void BarGraph::setBar(unsigned int index, float heightLeft, float heightRight, float r, float g, float b, float a){
+    setBar(index, heightLeft, heightRight);
+    setColor(index, r, g, b, a);
+}
+
+void BarGraph::setColor(unsigned int index, float r, float g, float b, float a){
+    m_Colors[4*index + 0] = PackColorChannel(r);
+    m_Colors[4*index + 1] = PackColorChannel(g);
+    m_Colors[4*index + 2] = PackColorChannel(b);
+    m_Colors[4*index + 3] = PackColorChannel(a);
+    m_Dirty = true;
+}
+
+void BarGraph::setPaletteColor(unsigned int index, unsigned int palette, unsigned int phase, int theme){
+    phase %= PALETTE_PERIOD;
+    m_Colors[4*index + 0] = (unsigned char)(phase & 0xFF);
+    m_Colors[4*index + 1] = (unsigned char)(phase >> 8);
+    m_Colors[4*index + 2] = (unsigned char)(palette + 2 * (theme + 1));
+    m_Colors[4*index + 3] = 0;
+    m_Dirty = true;
+}
+
+void BarGraph::shiftLeft(float heightLeft, float heightRight){
+    const size_t last = m_NumBars - 1;
+    const unsigned char* lastColor = &m_Colors[4*last];
+    if(lastColor[3] != 0){
+        shiftLeft(heightLeft, heightRight, lastColor[0] / 255.0f, lastColor[1] / 255.0f, lastColor[2] / 255.0f, lastColor[3] / 255.0f);
+        return;
+    }
+    //palette and theme byte stays the same
+    const unsigned char paletteTheme = lastColor[2];
+    const unsigned int phase = lastColor[0] | (lastColor[1] << 8);
+    shiftLeft(heightLeft, heightRight, 0.0f, 0.0f, 0.0f, 0.0f);
+    setPaletteColor(last, paletteTheme % 2, phase + 1, paletteTheme / 2 - 1);
+}
+
+void BarGraph::shiftLeft(float heightLeft, float heightRight, float r, float g, float b, float a){
+    const size_t last = m_NumBars - 1;
+    //contiguous moves instead of per-object copies
+    std::memmove(m_LeftHeights.data(), m_LeftHeights.data() + 1, last * sizeof(float));
+    std::memmove(m_RightHeights.data(), m_RightHeights.data() + 1, last * sizeof(float));
+    std::memmove(m_PrevLeftHeights.data(), m_PrevLeftHeights.data() + 1, last * sizeof(float));
+    std::memmove(m_PrevRightHeights.data(), m_PrevRightHeights.data() + 1, last * sizeof(float));
+    std::memmove(m_Colors.data(), m_Colors.data() + 4, 4 * last * sizeof(unsigned char));
+    setBar(last, heightLeft, heightRight, r, g, b, a);
+}
+
+void smoothBarHeights(unsigned int numBars, const float* targetLeft, const float* targetRight, float smoothingFactor, 
+    float minHalfHeight, float* leftHeights, float* rightHeights){
+    const float keep = smoothingFactor;
+    const float take = 1.0f - smoothingFactor;
+    //branch-free loop over flat arrays so the compiler can vectorize it
+    for(unsigned int i = 0; i < numBars; i++){
+        const float sl = keep * leftHeights[i] + take * targetLeft[i];
+        const float sr = keep * rightHeights[i] + take * targetRight[i];
+        const float right = fmaxf(minHalfHeight, sr);
+        rightHeights[i] = right;
+        leftHeights[i] = fmaxf(2.0f * minHalfHeight, sl + sr) - right;
+    }
+}
+
+void BarGraph::smoothTowards(const float* targetLeft, const float* targetRight, float smoothingFactor, float minHalfHeight){
+    //the current frame becomes the interpolation start point
+    std::memcpy(m_PrevLeftHeights.data(), m_LeftHeights.data(), m_NumBars * sizeof(float));
+    std::memcpy(m_PrevRightHeights.data(), m_RightHeights.data(), m_NumBars * sizeof(float));
+    smoothBarHeights(m_NumBars, targetLeft, targetRight, smoothingFactor, minHalfHeight, 
+        m_LeftHeights.data(), m_RightHeights.data());
+    m_Dirty = true;
+}
+
+void BarGraph::setHeights(const float* leftHeights, const float* rightHeights){
+    std::memcpy(m_PrevLeftHeights.data(), m_LeftHeights.data(), m_NumBars * sizeof(float));
+    std::memcpy(m_PrevRightHeights.data(), m_RightHeights.data(), m_NumBars * sizeof(float));
+    std::memcpy(m_LeftHeights.data(), leftHeights, m_NumBars * sizeof(float));
+    std::memcpy(m_RightHeights.data(), rightHeights, m_NumBars * sizeof(float));
+    m_Dirty = true;
+}
+
+void BarGraph::fillVertices(Vertex* target, int offset, float alpha) const{
+    Vertex* out = target + offset;
+    for(unsigned int i = 0; i < m_NumBars; i++){
+        const float x0 = m_BaseX + i * m_BarStride;
+        const float x1 = x0 + m_BarWidth;
+        const float right = m_HeightScale * (m_PrevRightHeights[i] + alpha * (m_RightHeights[i] - m_PrevRightHeights[i]));
+        const float left = m_HeightScale * (m_PrevLeftHeights[i] + alpha * (m_LeftHeights[i] - m_PrevLeftHeights[i]));
+        const float y0 = m_CenterY - right;
+        const float y1 = m_CenterY + left;
+        const unsigned char* c = &m_Colors[4*i];
+        out[4*i + 0] = {x0, y0, c[0], c[1], c[2], c[3]};
+        out[4*i + 1] = {x1, y0, c[0], c[1], c[2], c[3]};
+        out[4*i + 2] = {x1, y1, c[0], c[1], c[2], c[3]};
+        out[4*i + 3] = {x0, y1, c[0], c[1], c[2], c[3]};
+    }
+}
+
+void BarGraph::fillIndices(unsigned int* target, int offset, unsigned int firstID) const{
+    unsigned int* out = target + offset;
+    for(unsigned int i = 0; i < m_NumBars; i++){
+        const unsigned int id = (firstID + i) * 4;
+        out[6*i + 0] = 0 + id;
+        out[6*i + 1] = 1 + id;
+        out[6*i + 2] = 2 + id;
+        out[6*i + 3] = 2 + id;
+        out[6*i + 4] = 3 + id;
+        out[6*i + 5] = 0 + id;
+    }
+}
+
+void BarGraph::upload(Vertex* target, int offset, float alpha){
+    if(!m_Dirty) return;
+    fillVertices(target, offset, alpha);
+    //keep refilling every frame until the latest analysis frame is fully shown
+    m_Dirty = alpha < 1.0f;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include "Vertex.h"
+
+//exponentially smooths the drawn extents of numBars bars towards the targets and clamps them in place
+//(right extent at least minHalfHeight, full bar at least twice that); the clamped extents are the
+//starting point of the next step, so quiet bars decay from what was drawn
+void smoothBarHeights(unsigned int numBars, const float* targetLeft, const float* targetRight, float smoothingFactor, 
+    float minHalfHeight, float* leftHeights, float* rightHeights);
+
+//structure-of-arrays model for a row of vertical bars centered on a horizontal line
+//bars extend "left" (upwards, left channel) and "right" (downwards, right channel) from the center
+//all graph updates operate on the flat arrays; vertices are only generated on upload
+class BarGraph{
+    private:
+        unsigned int m_NumBars;
+        float m_BaseX;
+        float m_CenterY;
+        float m_BarWidth;
+        float m_BarStride;
+        //drawn size of one height unit, lets a graph be shown smaller than its model (e.g. in a grid cell)
+        float m_HeightScale;
+        bool m_Dirty;
+
+        //drawn extents above/below the center line, one entry per bar
+        std::vector<float> m_LeftHeights;
+        std::vector<float> m_RightHeights;
+        //extents of the previous analysis frame, used to interpolate between analysis frames
+        std::vector<float> m_PrevLeftHeights;
+        std::vector<float> m_PrevRightHeights;
+        //rgba bytes, 4 entries per bar
+        std::vector<unsigned char> m_Colors;
+
+    public:
+        BarGraph(unsigned int numBars, float basex, float centery, float barWidth, float barStride);
+        ~BarGraph();
+
+        //sets the extents of a single bar (and its color)
+        void setBar(unsigned int index, float heightLeft, float heightRight);
+        void setBar(unsigned int index, float heightLeft, float heightRight, float r, float g, float b, float a);
+        void setColor(unsigned int index, float r, float g, float b, float a);
+        //colors a bar from a theme palette (PALETTE_PRIMARY/PALETTE_SECONDARY), looked up by the shader at phase
+        //theme: fixed ColorThemes::Theme index or PALETTE_FRAME_THEME for the theme of the frame constants
+        void setPaletteColor(unsigned int index, unsigned int palette, unsigned int phase, int theme = PALETTE_FRAME_THEME);
+        //drops the first bar, moves every other bar one slot to the left and appends a new bar
+        void shiftLeft(float heightLeft, float heightRight, float r, float g, float b, float a);
+        //same, the new bar continues the palette of the last bar one phase further (or repeats its literal color)
+        void shiftLeft(float heightLeft, float heightRight);
+        //exponentially smooths every bar towards the target extents, then clamps the drawn extents
+        //so that the right extent is at least minHalfHeight and the full bar at least twice that
+        void smoothTowards(const float* targetLeft, const float* targetRight, float smoothingFactor, float minHalfHeight);
+        //sets the drawn extents of every bar to values smoothed elsewhere (e.g. by an AnalysisEngine)
+        void setHeights(const float* leftHeights, const float* rightHeights);
+
+        //writes 4 vertices per bar starting at target + offset
+        //alpha blends from the previous analysis frame (0) to the latest one (1)
+        void fillVertices(Vertex* target, int offset, float alpha = 1.0f) const;
+        //writes 6 indices per bar starting at target + offset, the first bar uses vertex id firstID
+        void fillIndices(unsigned int* target, int offset, unsigned int firstID) const;
+        //fills the vertices only if the model changed or is still being interpolated
+        void upload(Vertex* target, int offset, float alpha = 1.0f);
+
+        inline void setHeightScale(float scale) { m_HeightScale = scale; m_Dirty = true; }
+        inline unsigned int getNumBars() const { return m_NumBars; }
+        inline const float* getLeftHeights() const { return m_LeftHeights.data(); }
+        inline const float* getRightHeights() const { return m_RightHeights.data(); }
+        inline const unsigned char* getColors() const { return m_Colors.data(); }
+};
@@ -1,206 +1,227 @@
 #include "ColorThemes.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+//used when the themes file is missing or empty, same as the [default] section shipped in res/themes
+static const char* BUILTIN_THEMES =
+    "[default]\n"
+    "name = Default\n"
+    "background = 0.2 0.3 0.3 1.0\n"
+    "text = 1.0 1.0 1.0 1.0\n"
+    "button = 0.88 0.76 0.64 1.0\n"
+    "play_button = 0.1 0.1 0.1 1.0\n"
+    "primary = hsb 0 1.40625 1.0 1.0 1.0\n"
+    "secondary = hsb 0 1 0.6 0.7 0.7\n";
+
+//how the entries of a palette are generated, see res/themes/themes.ini
+typedef enum{
+    PALETTE_SOLID = 0,
+    PALETTE_HSB,
+    PALETTE_GRAY
+} PaletteMode;
+
+typedef struct{
+    PaletteMode mode;
+    //solid: rgba; hsb: hue, hue step, saturation, brightness, alpha; gray: value, value step, alpha
+    float args[5];
+    //0 = n counts up without turning
+    int pingPongTop;
+} PaletteDefinition;
+
+typedef struct{
+    std::string id;
+    std::string name;
+    AuxComputations::RGBAColor colors[4];
+    PaletteDefinition palettes[2];
+} ThemeDefinition;
+
+ColorThemes::Theme::Theme(const std::string& id, const std::string& name, int index, AuxComputations::RGBAColor bg,
+    AuxComputations::RGBAColor tx, AuxComputations::RGBAColor bt, AuxComputations::RGBAColor pb,
+    const std::vector<unsigned char>& palettes)
+: id(id), name(name), index(index), bgColor(bg), textColor(tx), buttonColor(bt), playButtonColor(pb), palettes(palettes){
 
-ColorThemes::Theme::Theme(AuxComputations::RGBAColor bg, AuxComputations::RGBAColor tx, 
-    AuxComputations::RGBAColor bt, AuxComputations::RGBAColor pb)
-: bgColor(bg), textColor(tx), buttonColor(bt), playButtonColor(pb){
-    primaryIterator = 0;
-    secondaryIterator = 0;
-    flipPrimaryDirection = false;
-    flipSecondaryDirection = false;
 }
 
 ColorThemes::Theme::~Theme(){
 
 }
 
-void ColorThemes::Theme::SetPrimaryColorFunction(ColorThemes::ThemeType type, float opt_args){
-    switch(type){
-        case LightRainbow:
-            generateColorPrimary = [](){
-                return AuxComputations::RGBAColor {0.85f, 0.85f, 0.85f, 1.0f};
-            };
-            break;
-        case TealWarm:
-            generateColorPrimary = [](){
-                return AuxComputations::RGBAColor {0.0f, 0.5f, 0.65f, 1.0f};
-            };
-            break;
-        case PurpleBlue:
-            generateColorPrimary = [](){
-                return AuxComputations::RGBAColor {0.67f, 0.14f, 1.0f, 1.0f};
-            };
-            break;
-        case YellowGrayScale:
-            generateColorPrimary = [](){
-                return AuxComputations::RGBAColor {1.0f, 1.0f, 0.3f, 1.0f};
-            };
-            break;
-        case NeonDesRainbow:
-            generateColorPrimary = [](){
-                return AuxComputations::RGBAColor {0.55f, 1.0f, 0.83f, 1.0f};
-            };
-            break;
-        case Default:
-        default:
-            generateColorPrimary = [this, opt_args](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 1.0f};
-                AuxComputations::HSBtoRGBA(opt_args*this->primaryIterator, 1.0f, 1.0f, color);
-                if(this->primaryIterator >= 360) this->primaryIterator %= 360;
-                return color;
-            };
-            break;
+static std::string trim(const std::string& text){
+    size_t first = text.find_first_not_of(" \t\r");
+    if(first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+//reads exactly count floats, false if there are fewer or more
+static bool parseFloats(std::istringstream& stream, float* values, int count){
+    for(int i = 0; i < count; i++){
+        if(!(stream >> values[i])) return false;
     }
+    std::string rest;
+    return !(stream >> rest);
 }
 
-void ColorThemes::Theme::SetSecondaryColorFunction(ColorThemes::ThemeType type, float opt_args){
-    switch(type){
-        case LightRainbow:
-            generateColorSecondary = [this](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 0.4f};
-                AuxComputations::HSBtoRGBA(this->secondaryIterator, 1.0, 1.0, color);
-                return color;
-            };
-            break;
-        case TealWarm:
-            generateColorSecondary = [this](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 1.0f};
-                if(this->secondaryIterator >= 360){
-                    flipSecondaryDirection = true;
-                }
-                if(this->secondaryIterator <= 0){
-                    flipSecondaryDirection = false;
-                }
-                AuxComputations::HSBtoRGBA(0.167f*this->secondaryIterator, 1.0f, 1.0f, color);
-                return color;
-            };
-            break;
-        case PurpleBlue:
-            generateColorSecondary = [this](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 1.0f};
-                if(this->secondaryIterator >= 2*180){
-                    flipSecondaryDirection = true;
-                }
-                if(this->secondaryIterator <= 0){
-                    flipSecondaryDirection = false;
-                }
-                AuxComputations::HSBtoRGBA(150 + 0.167f*this->secondaryIterator, 1.0f, 1.0f, color);
-                return color;
-            };
-            break;
-        case YellowGrayScale:
-            generateColorSecondary = [this](){
-                if(this->secondaryIterator >= 60){
-                    flipSecondaryDirection = true;
-                }
-                if(this->secondaryIterator <= 0){
-                    flipSecondaryDirection = false;
-                }
-                return AuxComputations::RGBAColor {0.01f*this->secondaryIterator + 0.2f, 
-                    0.01f*this->secondaryIterator + 0.2f, 0.01f*this->secondaryIterator + 0.2f, 1.0f};
-            };
-            break;
-        case NeonDesRainbow:
-            generateColorSecondary = [this](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 0.8f};
-                AuxComputations::HSBtoRGBA(this->secondaryIterator, 0.3f, 0.7f, color);
-                if(this->secondaryIterator >= 360) this->secondaryIterator %= 360;
-                return color;
-            };
-            break;
-        case Default:
-        default:
-            generateColorSecondary = [this](){
-                AuxComputations::RGBAColor color = {0, 0, 0, 0.7f};
-                AuxComputations::HSBtoRGBA(this->secondaryIterator, 0.6f, 0.7f, color);
-                if(this->secondaryIterator >= 360) this->secondaryIterator %= 360;
-                return color;
-            };
-            break;
+static bool parseColor(const std::string& value, AuxComputations::RGBAColor& color){
+    std::istringstream stream(value);
+    float channels[4];
+    if(!parseFloats(stream, channels, 4)) return false;
+    color = {channels[0], channels[1], channels[2], channels[3]};
+    return true;
+}
+
+//keeps the previous definition (and its ping-pong top) if the value is malformed
+static bool parsePalette(const std::string& value, PaletteDefinition& palette){
+    std::istringstream stream(value);
+    std::string mode;
+    stream >> mode;
+    PaletteDefinition parsed = palette;
+    if(mode == "solid") parsed.mode = PALETTE_SOLID;
+    else if(mode == "hsb") parsed.mode = PALETTE_HSB;
+    else if(mode == "gray") parsed.mode = PALETTE_GRAY;
+    else return false;
+    const int counts[3] = {4, 5, 3};
+    if(!parseFloats(stream, parsed.args, counts[parsed.mode])) return false;
+    palette = parsed;
+    return true;
+}
+
+static void startDefinition(ThemeDefinition& definition, const std::string& id){
+    definition.id = id;
+    definition.name = id;
+    //unset colors: black background, white text and buttons; unset palettes are solid white
+    definition.colors[0] = {0.0f, 0.0f, 0.0f, 1.0f};
+    definition.colors[1] = {1.0f, 1.0f, 1.0f, 1.0f};
+    definition.colors[2] = {1.0f, 1.0f, 1.0f, 1.0f};
+    definition.colors[3] = {0.1f, 0.1f, 0.1f, 1.0f};
+    for(int i = 0; i < 2; i++){
+        definition.palettes[i].mode = PALETTE_SOLID;
+        definition.palettes[i].args[0] = definition.palettes[i].args[1] = 1.0f;
+        definition.palettes[i].args[2] = definition.palettes[i].args[3] = 1.0f;
+        definition.palettes[i].pingPongTop = 0;
     }
 }
 
-void ColorThemes::Theme::updatePrimaryIterator(){
-    primaryIterator += 1 - 2*flipPrimaryDirection;
+//entries of one palette, the same values the old per-bar generators produced at bar n
+//hsb and gray entries are converted in one batch, a gray value is a brightness without saturation
+static void bakePalette(const PaletteDefinition& palette, unsigned char* entries){
+    if(palette.mode == PALETTE_SOLID){
+        for(unsigned int n = 0; n < PALETTE_PERIOD; n++){
+            for(int c = 0; c < 4; c++) entries[4*n + c] = PackColorChannel(palette.args[c]);
+        }
+        return;
+    }
+    std::vector<float> hues(PALETTE_PERIOD), saturations(PALETTE_PERIOD), brightnesses(PALETTE_PERIOD), alphas(PALETTE_PERIOD);
+    for(unsigned int n = 0; n < PALETTE_PERIOD; n++){
+        int step = (int)n;
+        if(palette.pingPongTop > 0){
+            int turn = step % (2 * palette.pingPongTop);
+            step = turn <= palette.pingPongTop ? turn : 2 * palette.pingPongTop - turn;
+        }
+        if(palette.mode == PALETTE_HSB){
+            hues[n] = palette.args[0] + palette.args[1] * step;
+            saturations[n] = palette.args[2];
+            brightnesses[n] = palette.args[3];
+            alphas[n] = palette.args[4];
+        }
+        else{
+            hues[n] = 0.0f;
+            saturations[n] = 0.0f;
+            brightnesses[n] = palette.args[1] * step + palette.args[0];
+            alphas[n] = palette.args[2];
+        }
+    }
+    AuxComputations::HSBtoRGBA8Batch(hues.data(), saturations.data(), brightnesses.data(), alphas.data(), PALETTE_PERIOD, entries);
 }
 
-void ColorThemes::Theme::updateSecondaryIterator(){
-    secondaryIterator += 1 - 2*flipSecondaryDirection;
+static void addTheme(const ThemeDefinition& definition, std::vector<ColorThemes::Theme>& themeTable){
+    if(themeTable.size() >= MAX_THEMES){
+        std::cerr << "Warning: more than " << MAX_THEMES << " themes, ignoring theme " << definition.id << std::endl;
+        return;
+    }
+    std::vector<unsigned char> palettes(2 * 4 * PALETTE_PERIOD);
+    bakePalette(definition.palettes[PALETTE_PRIMARY], &palettes[0]);
+    bakePalette(definition.palettes[PALETTE_SECONDARY], &palettes[4 * PALETTE_PERIOD]);
+    themeTable.push_back(ColorThemes::Theme(definition.id, definition.name, (int)themeTable.size(),
+        definition.colors[0], definition.colors[1], definition.colors[2], definition.colors[3], palettes));
+}
+
+static void parseThemes(std::istream& stream, const std::string& source, std::vector<ColorThemes::Theme>& themeTable){
+    ThemeDefinition definition;
+    bool inSection = false;
+    std::string line;
+    int lineNumber = 0;
+    while(std::getline(stream, line)){
+        lineNumber++;
+        line = trim(line);
+        if(line.empty() || line[0] == ';' || line[0] == '#') continue;
+        if(line[0] == '['){
+            if(inSection) addTheme(definition, themeTable);
+            startDefinition(definition, trim(line.substr(1, line.find(']') - 1)));
+            inSection = true;
+            continue;
+        }
+        size_t equals = line.find('=');
+        bool valid = inSection && equals != std::string::npos;
+        if(valid){
+            std::string key = trim(line.substr(0, equals));
+            std::string value = trim(line.substr(equals + 1));
+            if(key == "name") definition.name = value;
+            else if(key == "background") valid = parseColor(value, definition.colors[0]);
+            else if(key == "text") valid = parseColor(value, definition.colors[1]);
+            else if(key == "button") valid = parseColor(value, definition.colors[2]);
+            else if(key == "play_button") valid = parseColor(value, definition.colors[3]);
+            else if(key == "primary") valid = parsePalette(value, definition.palettes[PALETTE_PRIMARY]);
+            else if(key == "secondary") valid = parsePalette(value, definition.palettes[PALETTE_SECONDARY]);
+            else if(key == "primary_pingpong") definition.palettes[PALETTE_PRIMARY].pingPongTop = std::max(0, atoi(value.c_str()));
+            else if(key == "secondary_pingpong") definition.palettes[PALETTE_SECONDARY].pingPongTop = std::max(0, atoi(value.c_str()));
+            else valid = false;
+        }
+        if(!valid){
+            std::cerr << "Warning: " << source << ":" << lineNumber << ": ignoring \"" << line << "\"" << std::endl;
+        }
+    }
+    if(inSection) addTheme(definition, themeTable);
+}
+
+bool ColorThemes::LoadThemes(const std::string& filepath, std::vector<ColorThemes::Theme>& themeTable){
+    std::ifstream stream(filepath);
+    if(!stream.is_open()) return false;
+    parseThemes(stream, filepath, themeTable);
+    return true;
 }
 
-void ColorThemes::Theme::resetPrimaryIterator(){
-    primaryIterator = 0;
-    flipPrimaryDirection = false;
+void ColorThemes::InitializeThemes(std::vector<ColorThemes::Theme>& themeTable){
+    themeTable.clear();
+    if(!LoadThemes(THEMES_FILEPATH, themeTable)){
+        std::cerr << "Failed to open " << THEMES_FILEPATH << std::endl;
+    }
+    if(themeTable.empty()){
+        std::cerr << "No themes loaded, using the built-in default theme" << std::endl;
+        std::istringstream stream(BUILTIN_THEMES);
+        parseThemes(stream, "built-in", themeTable);
+    }
+}
+
+int ColorThemes::FindTheme(const std::vector<ColorThemes::Theme>& themeTable, const std::string& id){
+    for(size_t i = 0; i < themeTable.size(); i++){
+        if(themeTable[i].getId() == id) return (int)i;
+    }
+    return 0;
 }
 
-void ColorThemes::Theme::resetSecondaryIterator(){
-    secondaryIterator = 0;
-    flipSecondaryDirection = false;
+int ColorThemes::ResolveTheme(const std::vector<ColorThemes::Theme>& themeTable, int themeIndex){
+    if(themeIndex < 0) return FindTheme(themeTable, DEFAULT_THEME_ID);
+    return themeIndex % (int)themeTable.size();
 }
 
-void ColorThemes::InitializeThemes(std::map<ColorThemes::ThemeType, ColorThemes::Theme>& themeTable, float opt_args){
-    //initialize default theme
-    AuxComputations::RGBAColor bg_default = {0.2f, 0.3f, 0.3f, 1.0f};
-    AuxComputations::RGBAColor tx_default = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_default = {0.88f, 0.76f, 0.64f, 1.0f};
-    AuxComputations::RGBAColor pb_default = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::Default,
-        ColorThemes::Theme(bg_default, tx_default, bt_default, pb_default)});
-    auto& defaultTheme = themeTable.at(ColorThemes::ThemeType::Default);
-    defaultTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::Default, opt_args);
-    defaultTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::Default, opt_args);
-
-    //initialize light rainbow theme
-    AuxComputations::RGBAColor bg_lrnb = {0.212f, 0.27f, 0.31f, 1.0f};
-    AuxComputations::RGBAColor tx_lrnb = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_lrnb = {0.88f, 0.76f, 0.64f, 1.0f};
-    AuxComputations::RGBAColor pb_lrnb = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::LightRainbow,
-        ColorThemes::Theme(bg_lrnb, tx_lrnb, bt_lrnb, pb_lrnb)});
-    auto& lightRainbowTheme = themeTable.at(ColorThemes::ThemeType::LightRainbow);
-    lightRainbowTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::LightRainbow, opt_args);
-    lightRainbowTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::LightRainbow, opt_args);
-
-    //initialize teal warm theme
-    AuxComputations::RGBAColor bg_tlwrm = {0.17f, 0.0f, 0.44f, 1.0f};
-    AuxComputations::RGBAColor tx_tlwrm = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_tlwrm = {0.76f, 0.878f, 0.976f, 1.0f};
-    AuxComputations::RGBAColor pb_tlwrm = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::TealWarm,
-        ColorThemes::Theme(bg_tlwrm, tx_tlwrm, bt_tlwrm, pb_tlwrm)});
-    auto& tealWarmTheme = themeTable.at(ColorThemes::ThemeType::TealWarm);
-    tealWarmTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::TealWarm, opt_args);
-    tealWarmTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::TealWarm, opt_args);
-
-    //initialize purple blue theme
-    AuxComputations::RGBAColor bg_prpbl = {0.0f, 0.176f, 0.016f, 1.0f};
-    AuxComputations::RGBAColor tx_prpbl = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_prpbl = {0.76f, 0.878f, 0.976f, 1.0f};
-    AuxComputations::RGBAColor pb_prpbl = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::PurpleBlue,
-        ColorThemes::Theme(bg_prpbl, tx_prpbl, bt_prpbl, pb_prpbl)});
-    auto& purpleBlueTheme = themeTable.at(ColorThemes::ThemeType::PurpleBlue);
-    purpleBlueTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::PurpleBlue, opt_args);
-    purpleBlueTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::PurpleBlue, opt_args);
-
-    //initialize yellow grayscale theme
-    AuxComputations::RGBAColor bg_ylwgsc = {0.05f, 0.05f, 0.05f, 1.0f};
-    AuxComputations::RGBAColor tx_ylwgsc = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_ylwgsc = {0.9f, 0.9f, 0.9f, 1.0f};
-    AuxComputations::RGBAColor pb_ylwgsc = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::YellowGrayScale,
-        ColorThemes::Theme(bg_ylwgsc, tx_ylwgsc, bt_ylwgsc, pb_ylwgsc)});
-    auto& yellowGrayscaleTheme = themeTable.at(ColorThemes::ThemeType::YellowGrayScale);
-    yellowGrayscaleTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::YellowGrayScale, opt_args);
-    yellowGrayscaleTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::YellowGrayScale, opt_args);
-
-    //initialize neon desaturated rainbow theme
-    AuxComputations::RGBAColor bg_ndsrnbw = {0.04f, 0.04f, 0.25f, 1.0f};
-    AuxComputations::RGBAColor tx_ndsrnbw = {1.0f, 1.0f, 1.0f, 1.0f};
-    AuxComputations::RGBAColor bt_ndsrnbw = {0.42f, 0.85f, 0.54f, 1.0f};
-    AuxComputations::RGBAColor pb_ndsrnbw = {0.1f, 0.1f, 0.1f, 1.0f};
-    themeTable.insert({ColorThemes::ThemeType::NeonDesRainbow,
-        ColorThemes::Theme(bg_ndsrnbw, tx_ndsrnbw, bt_ndsrnbw, pb_ndsrnbw)});
-    auto& neonDesRainbowTheme = themeTable.at(ColorThemes::ThemeType::NeonDesRainbow);
-    neonDesRainbowTheme.SetPrimaryColorFunction(ColorThemes::ThemeType::NeonDesRainbow, opt_args);
-    neonDesRainbowTheme.SetSecondaryColorFunction(ColorThemes::ThemeType::NeonDesRainbow, opt_args);
+void ColorThemes::PackPalettes(const std::vector<ColorThemes::Theme>& themeTable, std::vector<unsigned char>& texels){
+    texels.clear();
+    texels.reserve(themeTable.size() * 2 * 4 * PALETTE_PERIOD);
+    for(const ColorThemes::Theme& theme : themeTable){
+        texels.insert(texels.end(), theme.getPalettes().begin(), theme.getPalettes().end());
+    }
 }
@@ -1,43 +1,47 @@
 #pragma once
 
-#include <functional>
-#include<map>
+#include <string>
+#include <vector>
 #include "vendor/imgui/imgui.h"
 #include "AuxComputations.h"
+#include "Vertex.h"
 
-namespace ColorThemes{
-    enum ThemeType{
-        Default,
-        LightRainbow,
-        TealWarm,
-        PurpleBlue,
-        YellowGrayScale,
-        NeonDesRainbow
-    };
+//theme definitions, one section per theme (format described in the file)
+#define THEMES_FILEPATH "./res/themes/themes.ini"
+//theme the window starts with when no --theme index is given
+#define DEFAULT_THEME_ID "teal_warm"
+//the vertex color encoding (Vertex.h) has room for this many fixed themes
+#define MAX_THEMES 126
 
+namespace ColorThemes{
+    //ui colors and baked bar palettes of a theme (primary: frequency graph, secondary: amplitude graph)
+    //a palette holds PALETTE_PERIOD rgba8 entries, entry n colors the bar at palette phase n (see Vertex.h);
+    //the bar shader looks the entries up in the palette texture, row 2 * index + palette
     class Theme {
+        std::string id;
+        std::string name;
+        int index;
         AuxComputations::RGBAColor bgColor;
         AuxComputations::RGBAColor textColor;
         AuxComputations::RGBAColor buttonColor;
         AuxComputations::RGBAColor playButtonColor;
-        int primaryIterator;
-        int secondaryIterator;
-        bool flipPrimaryDirection;
-        bool flipSecondaryDirection;
-        public:
-            std::function<AuxComputations::RGBAColor()> generateColorPrimary;
-            std::function<AuxComputations::RGBAColor()> generateColorSecondary;
+        //primary entries followed by secondary entries, 4 bytes each
+        std::vector<unsigned char> palettes;
 
         public:
-            Theme(AuxComputations::RGBAColor bg, AuxComputations::RGBAColor tx, 
-                AuxComputations::RGBAColor bt, AuxComputations::RGBAColor pb);
+            Theme(const std::string& id, const std::string& name, int index, AuxComputations::RGBAColor bg,
+                AuxComputations::RGBAColor tx, AuxComputations::RGBAColor bt, AuxComputations::RGBAColor pb,
+                const std::vector<unsigned char>& palettes);
             ~Theme();
-            void SetPrimaryColorFunction(enum ThemeType type, float opt_args);
-            void SetSecondaryColorFunction(enum ThemeType type, float opt_args);
-            void updatePrimaryIterator();
-            void updateSecondaryIterator();
-            void resetPrimaryIterator();
-            void resetSecondaryIterator();
+            inline const std::string& getId() const { return id; };
+            inline const std::string& getName() const { return name; };
+            //position in the theme table, also the theme argument of BarGraph::setPaletteColor
+            inline int getIndex() const { return index; };
+            //rgba8 entry of a palette (PALETTE_PRIMARY/PALETTE_SECONDARY) at a phase below PALETTE_PERIOD
+            inline const unsigned char* getPaletteEntry(unsigned int palette, unsigned int phase) const {
+                return &palettes[4 * (palette * PALETTE_PERIOD + phase)];
+            };
+            inline const std::vector<unsigned char>& getPalettes() const { return palettes; };
             inline AuxComputations::RGBAColor getBG() const { return bgColor; };
             inline AuxComputations::RGBAColor getText() const { return textColor; };
             inline AuxComputations::RGBAColor getButton() const { return buttonColor; };
@@ -48,5 +52,15 @@ namespace ColorThemes{
             inline ImVec4 getPlayButtonVec4() const { return ImVec4(playButtonColor.r, playButtonColor.g, playButtonColor.b, playButtonColor.a); };
     };
 
-    void InitializeThemes(std::map<ColorThemes::ThemeType, ColorThemes::Theme>& themeTable, float opt_args);
+    //reads the themes of a definition file and bakes their palettes, appends them to themeTable
+    //returns false if the file cannot be read; malformed lines are reported and skipped
+    bool LoadThemes(const std::string& filepath, std::vector<ColorThemes::Theme>& themeTable);
+    //themes of THEMES_FILEPATH, or a built-in default theme if the file has none
+    void InitializeThemes(std::vector<ColorThemes::Theme>& themeTable);
+    //index of the theme with the given id, 0 if there is none
+    int FindTheme(const std::vector<ColorThemes::Theme>& themeTable, const std::string& id);
+    //theme for a --theme index, wrapped to the table; a negative index selects DEFAULT_THEME_ID
+    int ResolveTheme(const std::vector<ColorThemes::Theme>& themeTable, int themeIndex);
+    //palettes of every theme as one rgba8 image, PALETTE_PERIOD wide and 2 rows per theme
+    void PackPalettes(const std::vector<ColorThemes::Theme>& themeTable, std::vector<unsigned char>& texels);
 }
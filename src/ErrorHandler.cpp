@@ -1,13 +1,103 @@
 #include "ErrorHandler.h"
 
+#include <atomic>
+#include <cstring>
+
+//GL_KHR_debug / GL 4.3 tokens, the loader only covers GL 3.3 core
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_OUTPUT 0x92E0
+
+typedef void (APIENTRYP DebugMessageCallbackProc)(GLDEBUGPROC callback, const void* userParam);
+typedef void (APIENTRYP DebugMessageControlProc)(GLenum source, GLenum type, GLenum severity,
+    GLsizei count, const GLuint* ids, GLboolean enabled);
+
+//call site of the latest GLCall, read by the callback which may run on a driver thread
+static std::atomic<const char*> s_CallFunction(nullptr);
+static std::atomic<const char*> s_CallFile(nullptr);
+static std::atomic<int> s_CallLine(0);
+static std::atomic<bool> s_DebugError(false);
+static bool s_DebugOutput = false;
+
 void GLClearError(){
     while(glGetError() != GL_NO_ERROR);
 }
 
 bool GLLogCall(const char* function, const char* file, int line){
     while(GLenum error = glGetError()){
-        std::cout << "[OpenGL Error] (0x" << std::hex << error << ") " << function << " " << file << ": line " << std::dec << line << std::endl;
+        std::cerr << "[OpenGL Error] (0x" << std::hex << error << ") " << function << " " << file << ": line " << std::dec << line << std::endl;
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+void GLBeginCall(const char* function, const char* file, int line){
+    s_CallFunction.store(function, std::memory_order_relaxed);
+    s_CallFile.store(file, std::memory_order_relaxed);
+    s_CallLine.store(line, std::memory_order_relaxed);
+    if(!s_DebugOutput) GLClearError();
+}
+
+bool GLEndCall(){
+    if(s_DebugOutput) return !s_DebugError.exchange(false, std::memory_order_relaxed);
+    return GLLogCall(s_CallFunction.load(std::memory_order_relaxed), s_CallFile.load(std::memory_order_relaxed),
+        s_CallLine.load(std::memory_order_relaxed));
+}
+
+static const char* severityName(GLenum severity){
+    switch(severity){
+        case GL_DEBUG_SEVERITY_HIGH: return "high";
+        case GL_DEBUG_SEVERITY_MEDIUM: return "medium";
+        case GL_DEBUG_SEVERITY_LOW: return "low";
+        default: return "info";
+    }
+}
+
+static void APIENTRY debugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* message, const void* userParam){
+    const char* function = s_CallFunction.load(std::memory_order_relaxed);
+    std::cerr << "[OpenGL " << (type == GL_DEBUG_TYPE_ERROR ? "Error" : "Debug") << "] (id " << id << ", "
+        << severityName(severity) << ") " << message << std::endl;
+    if(function){
+        std::cerr << "    at GLCall " << function << " " << s_CallFile.load(std::memory_order_relaxed)
+            << ": line " << s_CallLine.load(std::memory_order_relaxed) << std::endl;
+    }
+    if(type == GL_DEBUG_TYPE_ERROR) s_DebugError.store(true, std::memory_order_relaxed);
+    (void)source; (void)length; (void)userParam;
+}
+
+bool HasGLExtension(const char* name){
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for(GLint i = 0; i < count; i++){
+        const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+        if(extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+bool EnableGLDebugOutput(GLADloadproc load, bool synchronous){
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    const bool core = major > 4 || (major == 4 && minor >= 3);
+    if(!core && !HasGLExtension("GL_KHR_debug")) return false;
+    //KHR_debug in a core context has no suffix, same entry points as GL 4.3
+    DebugMessageCallbackProc debugMessageCallbackProc = (DebugMessageCallbackProc)load("glDebugMessageCallback");
+    DebugMessageControlProc debugMessageControlProc = (DebugMessageControlProc)load("glDebugMessageControl");
+    if(!debugMessageCallbackProc || !debugMessageControlProc) return false;
+
+    glEnable(GL_DEBUG_OUTPUT);
+    if(synchronous) glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    debugMessageCallbackProc(debugMessageCallback, nullptr);
+    //notifications (e.g. buffer placement hints) would flood the log every frame
+    debugMessageControlProc(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+    GLClearError();
+    s_DebugOutput = true;
+    return true;
+}
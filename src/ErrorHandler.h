@@ -3,10 +3,40 @@
 #include <glad/glad.h>
 #include <iostream>
 
+//GL_CHECK_ERRORS selects what GLCall costs, default: 1 in debug builds, 0 in release builds (NDEBUG)
+//1: GLCall records its call site; errors come from the debug output callback once EnableGLDebugOutput()
+//   succeeded, otherwise from glGetError drains before and after the call (a driver round-trip each)
+//0: GLCall(x) compiles to x
+#ifndef GL_CHECK_ERRORS
+    #ifdef NDEBUG
+        #define GL_CHECK_ERRORS 0
+    #else
+        #define GL_CHECK_ERRORS 1
+    #endif
+#endif
+
 #define ASSERT(x) if(!(x)) exit(1);
-#define GLCall(x) GLClearError();\
+#if GL_CHECK_ERRORS
+#define GLCall(x) GLBeginCall(#x, __FILE__, __LINE__);\
     x;\
-    ASSERT(GLLogCall(#x, __FILE__, __LINE__))
- 
+    ASSERT(GLEndCall())
+#else
+#define GLCall(x) x
+#endif
+
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
+
+//records the call site for debug messages, drains older errors if there is no debug output
+void GLBeginCall(const char* function, const char* file, int line);
+//false if the call raised an error (reported by the debug output callback or by glGetError)
+bool GLEndCall();
+
+//true if the current context lists the extension (GL 3.0+ indexed extension strings)
+bool HasGLExtension(const char* name);
+
+//reports GL errors through glDebugMessageCallback (GL 4.3 or GL_KHR_debug, needs a debug context on most drivers)
+//messages name the GLCall that was running; synchronous messages arrive inside the failing call (exact site),
+//asynchronous ones may arrive a few calls later but do not stall the driver
+//returns false if the context has no debug output, GLCall then keeps draining glGetError
+bool EnableGLDebugOutput(GLADloadproc load, bool synchronous);
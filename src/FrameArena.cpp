@@ -0,0 +1,41 @@
+#include "FrameArena.h"
+
+FrameArena::FrameArena()
+    : m_Block(FRAME_ARENA_BYTES), m_Offset(0), m_OverflowBytes(0){
+    m_Overflow.reserve(16);
+}
+
+FrameArena::~FrameArena(){
+    for(size_t i = 0; i < m_Overflow.size(); i++) delete[] m_Overflow[i];
+}
+
+FrameArena& FrameArena::Get(){
+    static FrameArena arena;
+    return arena;
+}
+
+void FrameArena::reset(){
+    if(!m_Overflow.empty()){
+        //grow to what the last frame needed, later frames of the same size fit into the block again
+        const size_t needed = getUsed();
+        for(size_t i = 0; i < m_Overflow.size(); i++) delete[] m_Overflow[i];
+        m_Overflow.clear();
+        m_OverflowBytes = 0;
+        m_Block.assign(needed + needed / 2, 0);
+    }
+    m_Offset = 0;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment){
+    const size_t base = (size_t)m_Block.data();
+    const size_t aligned = (base + m_Offset + alignment - 1) & ~(alignment - 1);
+    if(aligned + bytes <= base + m_Block.size()){
+        m_Offset = aligned + bytes - base;
+        return (void*)aligned;
+    }
+    //new[] returns memory aligned for any fundamental type
+    unsigned char* block = new unsigned char[bytes + alignment];
+    m_Overflow.push_back(block);
+    m_OverflowBytes += bytes + alignment;
+    return (void*)(((size_t)block + alignment - 1) & ~(alignment - 1));
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//first block of the per-frame arena, a frame that needs more grows it (once)
+#define FRAME_ARENA_BYTES (64 * 1024)
+
+//linear allocator for scratch memory that is only needed until the end of the current frame (sort buffers, ...)
+//allocate() bumps an offset in one preallocated block and reset() at the start of the next frame releases everything
+//at once, so a steady-state frame loop takes nothing from the heap; no destructors run, only use it for plain data
+//a frame that outgrows the block is served from extra heap blocks, the next reset() replaces them and the block with
+//one block of the size that frame needed
+//one arena per process, for the render thread
+class FrameArena{
+    private:
+        std::vector<unsigned char> m_Block;
+        size_t m_Offset;
+        //heap blocks of the current frame that did not fit into m_Block
+        std::vector<unsigned char*> m_Overflow;
+        size_t m_OverflowBytes;
+
+        FrameArena();
+        ~FrameArena();
+
+    public:
+        static FrameArena& Get();
+
+        //releases every allocation of the previous frame, call once at the start of each frame
+        void reset();
+        //alignment must be a power of two
+        void* allocate(size_t bytes, size_t alignment = sizeof(double));
+        template<typename T>
+        inline T* allocate(size_t count){ return (T*)allocate(count * sizeof(T), alignof(T)); }
+
+        inline size_t getCapacity() const { return m_Block.size(); }
+        //bytes handed out since the last reset, including padding and overflow blocks
+        inline size_t getUsed() const { return m_Offset + m_OverflowBytes; }
+};
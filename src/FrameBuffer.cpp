@@ -0,0 +1,43 @@
+#include "FrameBuffer.h"
+#include "ErrorHandler.h"
+#include <iostream>
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : m_RendererID(0), m_ColorBufferID(0), m_Width(width), m_Height(height){
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+    //color storage, never sampled so a renderbuffer is enough
+    GLCall(glGenRenderbuffers(1, &m_ColorBufferID));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorBufferID));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorBufferID));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    if(status != GL_FRAMEBUFFER_COMPLETE){
+        std::cout << "\nError: Framebuffer incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+        exit(1);
+    }
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+FrameBuffer::~FrameBuffer(){
+    GLCall(glDeleteRenderbuffers(1, &m_ColorBufferID));
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void FrameBuffer::Bind() const{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void FrameBuffer::Unbind() const{
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void FrameBuffer::ReadPixels(unsigned char* target) const{
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, target));
+}
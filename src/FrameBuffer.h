@@ -0,0 +1,22 @@
+#pragma once
+
+//offscreen render target (framebuffer object with an RGBA8 color renderbuffer)
+class FrameBuffer{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_ColorBufferID;
+        int m_Width, m_Height;
+    public:
+        FrameBuffer(int width, int height);
+        ~FrameBuffer();
+
+        //binds the framebuffer and sets the viewport to its size
+        void Bind() const;
+        void Unbind() const;
+        //reads the color attachment into target as tightly packed RGBA8 rows, bottom row first
+        void ReadPixels(unsigned char* target) const;
+
+        inline unsigned int GetRendererID() const { return m_RendererID; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+};
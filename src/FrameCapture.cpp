@@ -0,0 +1,205 @@
+#include "FrameCapture.h"
+#include "ErrorHandler.h"
+
+#include <algorithm>
+#include <cstring>
+
+template<typename Queue>
+static void pushFrame(Queue& queue, size_t frame){
+    queue.indices[(queue.head + queue.count) % CAPTURE_QUEUE_FRAMES] = frame;
+    queue.count++;
+}
+
+template<typename Queue>
+static size_t popFrame(Queue& queue){
+    size_t frame = queue.indices[queue.head];
+    queue.head = (queue.head + 1) % CAPTURE_QUEUE_FRAMES;
+    queue.count--;
+    return frame;
+}
+
+FrameCapture::FrameCapture(int width, int height, bool lossless, size_t numPixelBuffers)
+    : m_Width(width), m_Height(height), m_FrameSize((size_t)width * height * 4), m_Lossless(lossless),
+    m_Recording(false), m_PixelBuffers(numPixelBuffers, 0), m_Fences(numPixelBuffers, nullptr),
+    m_Head(0), m_InFlight(0), m_FramesCaptured(0), m_FramesDropped(0), m_Fps(0), m_LastSlot(-1), 
+    m_BufferSlots(numPixelBuffers, 0), m_FrameSlots(CAPTURE_QUEUE_FRAMES, 0), m_WrittenSlot(-1), m_FramesRepeated(0),
+    m_WriteFailed(false), m_Frames(CAPTURE_QUEUE_FRAMES), m_Stopping(false){
+    GLCall(glGenBuffers((GLsizei)m_PixelBuffers.size(), m_PixelBuffers.data()));
+    for(size_t i = 0; i < m_PixelBuffers.size(); i++){
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBuffers[i]));
+        //written by the GPU, read once by the CPU
+        GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, m_FrameSize, nullptr, GL_STREAM_READ));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    m_FreeFrames.head = m_FreeFrames.count = 0;
+    m_ReadyFrames.head = m_ReadyFrames.count = 0;
+    for(size_t i = 0; i < m_Frames.size(); i++){
+        m_Frames[i].resize(m_FrameSize);
+        pushFrame(m_FreeFrames, i);
+    }
+}
+
+FrameCapture::~FrameCapture(){
+    Stop();
+    GLCall(glDeleteBuffers((GLsizei)m_PixelBuffers.size(), m_PixelBuffers.data()));
+}
+
+bool FrameCapture::Start(FrameWriter::Format format, const std::string& path, int fps){
+    if(m_Recording) return true;
+    m_Writer.reset(new FrameWriter(format, path, m_Width, m_Height, fps));
+    if(!m_Writer->isOpen()){
+        m_Writer.reset();
+        return false;
+    }
+    m_FramesCaptured = 0;
+    m_FramesDropped = 0;
+    m_FramesRepeated = 0;
+    m_StartTime = std::chrono::steady_clock::now();
+    m_Fps = fps;
+    m_LastSlot = -1;
+    m_WrittenSlot = -1;
+    m_WriteFailed = false;
+    m_Stopping = false;
+    m_WriterThread = std::thread(&FrameCapture::writerLoop, this);
+    m_Recording = true;
+    return true;
+}
+
+void FrameCapture::Stop(){
+    if(!m_Recording) return;
+    //the GPU transfers still in flight belong to the recording
+    collectCompleted(true);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_WriterThread.join();
+    m_Writer.reset();
+    m_Recording = false;
+}
+
+void FrameCapture::Capture(unsigned int framebuffer){
+    if(!m_Recording) return;
+    //lossless: every call is the next video frame; realtime: the video frame due at this time
+    long long slot = m_LastSlot + 1;
+    if(!m_Lossless){
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_StartTime).count();
+        slot = (long long)(elapsed * m_Fps);
+        //this video frame already has its capture
+        if(slot <= m_LastSlot) return;
+    }
+    m_LastSlot = slot;
+    collectCompleted(false);
+    if(m_InFlight == m_PixelBuffers.size()){
+        if(!m_Lossless){
+            //every buffer is still owned by the GPU, waiting here would stall the frame
+            m_FramesDropped++;
+            return;
+        }
+        collectCompleted(true);
+    }
+
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer));
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBuffers[m_Head]));
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    //with a pack buffer bound the last argument is an offset and the call returns immediately
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+    GLCall(m_Fences[m_Head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    m_BufferSlots[m_Head] = slot;
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    m_Head = (m_Head + 1) % m_PixelBuffers.size();
+    m_InFlight++;
+}
+
+void FrameCapture::collectCompleted(bool wait){
+    while(m_InFlight > 0){
+        const size_t oldest = (m_Head + m_PixelBuffers.size() - m_InFlight) % m_PixelBuffers.size();
+        GLenum status;
+        if(wait){
+            //a timeout only means the GPU is slow, the buffer has to be collected before it is reused
+            do{
+                GLCall(status = glClientWaitSync(m_Fences[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull));
+            } while(status == GL_TIMEOUT_EXPIRED);
+        }
+        else{
+            GLCall(status = glClientWaitSync(m_Fences[oldest], 0, 0));
+            if(status == GL_TIMEOUT_EXPIRED) return;
+        }
+        GLCall(glDeleteSync(m_Fences[oldest]));
+        m_Fences[oldest] = nullptr;
+        m_InFlight--;
+        if(status == GL_WAIT_FAILED){
+            //the transfer's contents are unknown, drop it and fail the recording
+            std::cerr << "Capture: waiting for a pixel transfer failed, frame dropped" << std::endl;
+            m_FramesDropped++;
+            m_WriteFailed = true;
+            continue;
+        }
+
+        size_t frame;
+        if(!takeFreeFrame(frame)){
+            //writer thread is behind
+            m_FramesDropped++;
+            continue;
+        }
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_PixelBuffers[oldest]));
+        GLCall(const unsigned char* pixels = (const unsigned char*) 
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_FrameSize, GL_MAP_READ_BIT));
+        if(pixels != nullptr){
+            std::memcpy(m_Frames[frame].data(), pixels, m_FrameSize);
+        }
+        m_FrameSlots[frame] = m_BufferSlots[oldest];
+        GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+        GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            pushFrame(m_ReadyFrames, frame);
+        }
+        m_Condition.notify_all();
+        m_FramesCaptured++;
+    }
+}
+
+bool FrameCapture::takeFreeFrame(size_t& index){
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if(m_Lossless){
+        m_Condition.wait(lock, [this]{ return m_FreeFrames.count > 0; });
+    }
+    if(m_FreeFrames.count == 0) return false;
+    index = popFrame(m_FreeFrames);
+    return true;
+}
+
+void FrameCapture::writerLoop(){
+    //readback rows are bottom to top, FrameWriter expects top to bottom
+    std::vector<unsigned char> flipped(m_FrameSize);
+    const size_t rowSize = (size_t)m_Width * 4;
+    while(true){
+        size_t frame;
+        long long slot;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]{ return m_ReadyFrames.count > 0 || m_Stopping; });
+            if(m_ReadyFrames.count == 0) break;
+            frame = popFrame(m_ReadyFrames);
+            slot = m_FrameSlots[frame];
+        }
+        const unsigned char* pixels = m_Frames[frame].data();
+        for(int row = 0; row < m_Height; row++){
+            std::memcpy(&flipped[row * rowSize], pixels + (m_Height - 1 - row) * rowSize, rowSize);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            pushFrame(m_FreeFrames, frame);
+        }
+        m_Condition.notify_all();
+        //video frames since the last written one got no capture of their own, they show this one
+        for(long long written = m_WrittenSlot + 1; written <= slot && !m_WriteFailed; written++){
+            if(!m_Writer->writeFrame(flipped.data())) m_WriteFailed = true;
+            if(written < slot) m_FramesRepeated++;
+        }
+        m_WrittenSlot = std::max(m_WrittenSlot, slot);
+    }
+}
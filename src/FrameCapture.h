@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameWriter.h"
+
+//default number of pixel buffer objects in flight
+#define CAPTURE_PIXEL_BUFFERS 3
+//frames that can wait for the writer thread before capture starts dropping (or waiting)
+#define CAPTURE_QUEUE_FRAMES 8
+
+//asynchronous frame capture: glReadPixels goes into a ring of pixel buffer objects guarded by fences,
+//finished transfers are copied out a few frames later and encoded by a writer thread
+//in realtime mode frames are dropped instead of stalling the render loop, lossless mode waits instead
+//realtime mode also captures against a fixed clock at the output fps: calls between two video frames are skipped
+//and a video frame that got no capture (slow frame, dropped readback) repeats the next captured one,
+//so the recording plays back at the speed it was made at whatever rate the display runs
+//lossless mode writes every captured frame exactly once (offline rendering, one Capture per video frame)
+class FrameCapture{
+    private:
+        int m_Width, m_Height;
+        size_t m_FrameSize;
+        bool m_Lossless;
+        bool m_Recording;
+
+        std::vector<unsigned int> m_PixelBuffers;
+        std::vector<GLsync> m_Fences;
+        //next pixel buffer to read into, transfers still owned by the GPU
+        size_t m_Head;
+        size_t m_InFlight;
+
+        unsigned long long m_FramesCaptured;
+        unsigned long long m_FramesDropped;
+        //realtime clock: start of the recording, output fps and the last video frame a capture was queued for
+        std::chrono::steady_clock::time_point m_StartTime;
+        int m_Fps;
+        long long m_LastSlot;
+        //video frame of each pixel buffer transfer and of each pooled frame
+        std::vector<long long> m_BufferSlots;
+        std::vector<long long> m_FrameSlots;
+        //last video frame written, only touched by the writer thread
+        long long m_WrittenSlot;
+        //video frames written as a copy of a later capture, set by the writer thread
+        std::atomic<unsigned long long> m_FramesRepeated;
+        //set by the writer thread, or when waiting for a pixel transfer fails
+        std::atomic<bool> m_WriteFailed;
+
+        //ring of indices into m_Frames with room for every frame, so queueing never allocates
+        //(a deque frees and reallocates its chunks while the indices cycle through it)
+        typedef struct{
+            size_t indices[CAPTURE_QUEUE_FRAMES];
+            size_t head;
+            size_t count;
+        } FrameQueue;
+
+        //frame pool shared with the writer thread
+        std::vector<std::vector<unsigned char>> m_Frames;
+        FrameQueue m_FreeFrames;
+        FrameQueue m_ReadyFrames;
+        std::unique_ptr<FrameWriter> m_Writer;
+        std::thread m_WriterThread;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Stopping;
+
+        //moves finished transfers to the writer, wait blocks on the oldest one
+        void collectCompleted(bool wait);
+        bool takeFreeFrame(size_t& index);
+        void writerLoop();
+
+    public:
+        FrameCapture(int width, int height, bool lossless = false, size_t numPixelBuffers = CAPTURE_PIXEL_BUFFERS);
+        ~FrameCapture();
+
+        //opens the output and starts the writer thread
+        bool Start(FrameWriter::Format format, const std::string& path, int fps);
+        //finishes every queued frame and closes the output
+        void Stop();
+        //queues a readback of the bound size from framebuffer (0 = default framebuffer), call after drawing
+        void Capture(unsigned int framebuffer = 0);
+
+        inline bool IsRecording() const { return m_Recording; }
+        inline int GetWidth() const { return m_Width; }
+        inline int GetHeight() const { return m_Height; }
+        inline unsigned long long GetFramesCaptured() const { return m_FramesCaptured; }
+        inline unsigned long long GetFramesDropped() const { return m_FramesDropped; }
+        inline unsigned long long GetFramesRepeated() const { return m_FramesRepeated; }
+        inline bool HasWriteFailed() const { return m_WriteFailed; }
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "vendor/glm/glm.hpp"
+
+//binding point and block name of the per-frame constants in res/shaders, the ShaderManager attaches the block of
+//every program it loads to this point
+#define FRAME_CONSTANTS_BINDING 0
+#define FRAME_CONSTANTS_BLOCK "FrameConstants"
+
+//groups of geometry that move together when the window is resized, index of their transform in FrameConstants::anchors
+//(Layout.h); the shader selects one per draw through the u_Anchor uniform, 0 when a program never sets it
+typedef enum{
+    //graphs, separator and decibel meters
+    LAYOUT_ANCHOR_GRAPHS = 0,
+    //play/pause and record buttons
+    LAYOUT_ANCHOR_TOP_LEFT,
+    //file button
+    LAYOUT_ANCHOR_TOP_RIGHT,
+    LAYOUT_NUM_ANCHORS
+} LayoutAnchor;
+
+//values every program can read without uniform calls, uploaded once per frame into one UniformBuffer
+//std140 layout: only mat4 and vec4 members, so the C++ offsets equal the GLSL offsets without padding
+//keep in sync with the FrameConstants block in res/shaders
+typedef struct{
+    //pixels of the render target to clip space
+    glm::mat4 mvp;
+    //x = seconds since start, y = seconds since the previous frame, z = frequency graph interpolation alpha, w = frame
+    glm::vec4 time;
+    //x/y = smoothed left/right peak level (0-1), z/w = left/right decibel meter fill (0.01-1)
+    glm::vec4 levels;
+    //colors of the current theme
+    glm::vec4 backgroundColor;
+    glm::vec4 textColor;
+    glm::vec4 buttonColor;
+    glm::vec4 playButtonColor;
+    //x = ColorThemes::Theme index of the bar palettes (palette texture rows 2x and 2x + 1), yzw unused
+    glm::vec4 theme;
+    //design units (VisualizerConfig.h) to pixels per LayoutAnchor: xy = scale, zw = offset
+    glm::vec4 anchors[LAYOUT_NUM_ANCHORS];
+} FrameConstants;
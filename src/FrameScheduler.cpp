@@ -0,0 +1,123 @@
+#include "FrameScheduler.h"
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#define FRAME_STATS_WINDOW 240
+
+FrameScheduler::FrameScheduler(size_t hopSamples, unsigned int samplesPerSecond, size_t maxBacklogHops)
+    : m_HopSamples(hopSamples), m_SamplesPerSecond(samplesPerSecond), m_HopDuration((double)hopSamples / samplesPerSecond),
+    m_MaxBacklogHops(maxBacklogHops), m_LastAnalysisTime(0.0), m_AnalysisFrames(0), m_DroppedHops(0),
+    m_AudioLatency(0.0), m_SwapInterval(1), m_FpsCap(0), m_FrameStart(0.0), m_LastFrameStart(0.0),
+    m_FrameIntervals(FRAME_STATS_WINDOW, 0.0), m_IntervalHead(0), m_IntervalCount(0){
+
+}
+
+FrameScheduler::~FrameScheduler(){
+
+}
+
+void FrameScheduler::setSwapInterval(int interval){
+    m_SwapInterval = interval;
+    glfwSwapInterval(interval);
+}
+
+void FrameScheduler::setFpsCap(int fps){
+    m_FpsCap = fps < 0 ? 0 : fps;
+}
+
+void FrameScheduler::beginFrame(){
+    m_FrameStart = glfwGetTime();
+    if(m_LastFrameStart > 0.0){
+        m_FrameIntervals[m_IntervalHead] = m_FrameStart - m_LastFrameStart;
+        m_IntervalHead = (m_IntervalHead + 1) % m_FrameIntervals.size();
+        if(m_IntervalCount < m_FrameIntervals.size()) m_IntervalCount++;
+    }
+    m_LastFrameStart = m_FrameStart;
+}
+
+void FrameScheduler::endFrame(){
+    if(m_FpsCap <= 0) return;
+    const double target = m_FrameStart + 1.0 / m_FpsCap;
+    //coarse sleep first, then spin for the last millisecond to keep the interval tight
+    double remaining = target - glfwGetTime();
+    if(remaining > 0.002){
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining - 0.001));
+    }
+    while(glfwGetTime() < target){
+        std::this_thread::yield();
+    }
+}
+
+size_t FrameScheduler::scheduleHops(size_t availableSamples, size_t& hopsToDrop){
+    size_t hopsReady = availableSamples / m_HopSamples;
+    hopsToDrop = 0;
+    if(hopsReady > m_MaxBacklogHops){
+        hopsToDrop = hopsReady - m_MaxBacklogHops;
+        hopsReady = m_MaxBacklogHops;
+        m_DroppedHops += hopsToDrop;
+    }
+    return hopsReady;
+}
+
+void FrameScheduler::markAnalysisFrame(){
+    m_LastAnalysisTime = glfwGetTime();
+    m_AnalysisFrames++;
+}
+
+void FrameScheduler::addDroppedHops(size_t hops){
+    m_DroppedHops += hops;
+}
+
+void FrameScheduler::setAudioBacklog(size_t remainingSamples){
+    m_AudioLatency = (double)remainingSamples / m_SamplesPerSecond;
+}
+
+void FrameScheduler::resetAnalysis(){
+    m_LastAnalysisTime = 0.0;
+    m_AnalysisFrames = 0;
+    m_DroppedHops = 0;
+    m_AudioLatency = 0.0;
+}
+
+float FrameScheduler::getInterpolationAlpha() const{
+    if(m_AnalysisFrames == 0) return 1.0f;
+    double alpha = (m_FrameStart - m_LastAnalysisTime) / m_HopDuration;
+    if(alpha < 0.0) alpha = 0.0;
+    if(alpha > 1.0) alpha = 1.0;
+    return (float)alpha;
+}
+
+double FrameScheduler::getLatencyMs() const{
+    //samples still waiting in the buffer + time since the shown analysis frame was produced
+    double sinceAnalysis = m_AnalysisFrames == 0 ? 0.0 : m_FrameStart - m_LastAnalysisTime;
+    return 1000.0 * (m_AudioLatency + sinceAnalysis);
+}
+
+double FrameScheduler::getAverageFrameMs() const{
+    if(m_IntervalCount == 0) return 0.0;
+    double sum = 0.0;
+    for(size_t i = 0; i < m_IntervalCount; i++) sum += m_FrameIntervals[i];
+    return 1000.0 * sum / m_IntervalCount;
+}
+
+double FrameScheduler::getJitterMs() const{
+    if(m_IntervalCount < 2) return 0.0;
+    const double mean = getAverageFrameMs() / 1000.0;
+    double sumSquares = 0.0;
+    for(size_t i = 0; i < m_IntervalCount; i++){
+        const double d = m_FrameIntervals[i] - mean;
+        sumSquares += d * d;
+    }
+    return 1000.0 * sqrt(sumSquares / (m_IntervalCount - 1));
+}
+
+double FrameScheduler::getMaxFrameMs() const{
+    double maxInterval = 0.0;
+    for(size_t i = 0; i < m_IntervalCount; i++){
+        if(m_FrameIntervals[i] > maxInterval) maxInterval = m_FrameIntervals[i];
+    }
+    return 1000.0 * maxInterval;
+}
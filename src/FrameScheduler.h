@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//paces the render loop and decouples the analysis rate from the display rate
+//analysis is driven by the audio clock (whole hops of decoded samples), rendering by display timing;
+//the renderer interpolates between the last two analysis frames using getInterpolationAlpha()
+class FrameScheduler{
+    private:
+        //analysis timing
+        size_t m_HopSamples;
+        unsigned int m_SamplesPerSecond;
+        double m_HopDuration;
+        size_t m_MaxBacklogHops;
+        double m_LastAnalysisTime;
+        unsigned long long m_AnalysisFrames;
+        unsigned long long m_DroppedHops;
+        double m_AudioLatency;
+
+        //display timing
+        int m_SwapInterval;
+        int m_FpsCap;
+        double m_FrameStart;
+        double m_LastFrameStart;
+
+        //rolling frame interval statistics (seconds)
+        std::vector<double> m_FrameIntervals;
+        size_t m_IntervalHead;
+        size_t m_IntervalCount;
+
+    public:
+        //hopSamples: interleaved samples consumed per analysis frame, samplesPerSecond: sample rate * channels
+        FrameScheduler(size_t hopSamples, unsigned int samplesPerSecond, size_t maxBacklogHops);
+        ~FrameScheduler();
+
+        void setSwapInterval(int interval);
+        //0 disables the cap
+        void setFpsCap(int fps);
+
+        void beginFrame();
+        //sleeps until the fps cap allows the next frame to start
+        void endFrame();
+
+        //number of whole hops that should be analyzed this frame, given the samples waiting in the audio buffer
+        //hops beyond the backlog limit are returned through hopsToDrop so latency stays bounded
+        size_t scheduleHops(size_t availableSamples, size_t& hopsToDrop);
+        //called once per analysis frame that was actually run
+        void markAnalysisFrame();
+        //hops skipped by analysis running outside scheduleHops() (e.g. on a pipeline thread)
+        void addDroppedHops(size_t hops);
+        //samples left in the audio buffer after analysis, used for the latency estimate
+        void setAudioBacklog(size_t remainingSamples);
+        //resets analysis timing (e.g. after a new track was loaded)
+        void resetAnalysis();
+
+        //0 right after an analysis frame, 1 once a full hop duration has passed since then
+        float getInterpolationAlpha() const;
+
+        inline int getSwapInterval() const { return m_SwapInterval; }
+        inline int getFpsCap() const { return m_FpsCap; }
+        inline size_t getHopSamples() const { return m_HopSamples; }
+        inline double getAnalysisRate() const { return 1.0 / m_HopDuration; }
+        inline unsigned long long getAnalysisFrames() const { return m_AnalysisFrames; }
+        inline unsigned long long getDroppedHops() const { return m_DroppedHops; }
+        //estimated delay between audio leaving the device and it showing up on screen (ms)
+        double getLatencyMs() const;
+        double getAverageFrameMs() const;
+        //standard deviation of the frame interval (ms)
+        double getJitterMs() const;
+        double getMaxFrameMs() const;
+};
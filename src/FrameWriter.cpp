@@ -0,0 +1,252 @@
+#include "FrameWriter.h"
+
+#include <algorithm>
+#include <iostream>
+
+//full range BT.601, fixed point with 8 fractional bits
+static inline unsigned char rgbToY(int r, int g, int b){
+    return (unsigned char)((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+static inline unsigned char rgbToU(int r, int g, int b){
+    return (unsigned char)((-43 * r - 85 * g + 128 * b + 128 + (128 << 8)) >> 8);
+}
+
+static inline unsigned char rgbToV(int r, int g, int b){
+    return (unsigned char)((128 * r - 107 * g - 21 * b + 128 + (128 << 8)) >> 8);
+}
+
+static unsigned int crc32(unsigned int crc, const unsigned char* data, size_t length){
+    static unsigned int table[256];
+    static bool tableReady = false;
+    if(!tableReady){
+        for(unsigned int i = 0; i < 256; i++){
+            unsigned int c = i;
+            for(int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for(size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putU32(std::vector<unsigned char>& out, unsigned int value){
+    out.push_back((value >> 24) & 0xFF);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+}
+
+static bool writeChunk(FILE* file, const char* type, const std::vector<unsigned char>& data){
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    putU32(chunk, (unsigned int)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    putU32(chunk, crc32(0, &chunk[4], data.size() + 4));
+    return fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+}
+
+//splits a PNG path pattern around its single %d / %0Nd, false for any other conversion or a count other than one
+//the pattern never reaches printf, so a stray %s or %n in a file name cannot be misread
+static bool splitPathPattern(const std::string& pattern, std::string& prefix, std::string& suffix, int& digits){
+    prefix.clear();
+    suffix.clear();
+    digits = -1;
+    for(size_t i = 0; i < pattern.size(); i++){
+        std::string& out = digits < 0 ? prefix : suffix;
+        if(pattern[i] != '%'){
+            out += pattern[i];
+            continue;
+        }
+        if(i + 1 < pattern.size() && pattern[i + 1] == '%'){
+            out += '%';
+            i++;
+            continue;
+        }
+        if(digits >= 0) return false;
+        size_t end = i + 1;
+        int width = 0;
+        if(end < pattern.size() && pattern[end] == '0'){
+            end++;
+            while(end < pattern.size() && pattern[end] >= '0' && pattern[end] <= '9' && width < 100){
+                width = 10 * width + (pattern[end] - '0');
+                end++;
+            }
+            if(width == 0) return false;
+        }
+        if(end >= pattern.size() || pattern[end] != 'd') return false;
+        digits = width;
+        i = end;
+    }
+    return digits >= 0;
+}
+
+FrameWriter::FrameWriter(Format format, const std::string& path, int width, int height, int fps)
+    : m_Format(format), m_Path(path), m_NumberDigits(-1), m_Width(width), m_Height(height), m_Fps(fps),
+    m_File(NULL), m_FramesWritten(0){
+    if(m_Format == PNG){
+        if(!splitPathPattern(m_Path, m_PathPrefix, m_PathSuffix, m_NumberDigits)){
+            m_NumberDigits = -1;
+            std::cerr << "Invalid PNG output pattern " << m_Path << ", expected one %d or %0Nd (e.g. frame_%06d.png)" << std::endl;
+        }
+        return;
+    }
+
+    m_File = m_Path == "-" ? stdout : fopen(m_Path.c_str(), "wb");
+    if(m_File == NULL){
+        std::cerr << "Failed to open output file: " << m_Path << std::endl;
+        return;
+    }
+    if(m_Format == Y4M){
+        //4:2:0 with jpeg (centered) chroma siting, full range
+        fprintf(m_File, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", m_Width, m_Height, m_Fps);
+    }
+}
+
+FrameWriter::~FrameWriter(){
+    close();
+}
+
+bool FrameWriter::isOpen() const{
+    if(m_Format == PNG) return m_NumberDigits >= 0;
+    return m_File != NULL;
+}
+
+void FrameWriter::close(){
+    if(m_File == NULL) return;
+    if(m_File == stdout) fflush(m_File);
+    else fclose(m_File);
+    m_File = NULL;
+}
+
+bool FrameWriter::writeFrame(const unsigned char* rgba){
+    bool written = false;
+    switch(m_Format){
+        case Raw:
+            if(m_File == NULL) return false;
+            written = fwrite(rgba, 1, (size_t)m_Width * m_Height * 4, m_File) == (size_t)m_Width * m_Height * 4;
+            break;
+        case Y4M:
+            written = writeY4M(rgba);
+            break;
+        case PNG:
+            written = writePNG(rgba);
+            break;
+    }
+    if(written) m_FramesWritten++;
+    return written;
+}
+
+bool FrameWriter::writeY4M(const unsigned char* rgba){
+    if(m_File == NULL) return false;
+    const size_t lumaSize = (size_t)m_Width * m_Height;
+    const int chromaWidth = (m_Width + 1) / 2;
+    const int chromaHeight = (m_Height + 1) / 2;
+    const size_t chromaSize = (size_t)chromaWidth * chromaHeight;
+    m_Scratch.resize(lumaSize + 2 * chromaSize);
+    unsigned char* yPlane = m_Scratch.data();
+    unsigned char* uPlane = yPlane + lumaSize;
+    unsigned char* vPlane = uPlane + chromaSize;
+
+    for(int y = 0; y < m_Height; y++){
+        const unsigned char* row = rgba + (size_t)y * m_Width * 4;
+        for(int x = 0; x < m_Width; x++){
+            yPlane[(size_t)y * m_Width + x] = rgbToY(row[4*x], row[4*x + 1], row[4*x + 2]);
+        }
+    }
+    //chroma from the average of each 2x2 block
+    for(int cy = 0; cy < chromaHeight; cy++){
+        for(int cx = 0; cx < chromaWidth; cx++){
+            int r = 0, g = 0, b = 0, n = 0;
+            for(int dy = 0; dy < 2; dy++){
+                for(int dx = 0; dx < 2; dx++){
+                    const int x = 2*cx + dx;
+                    const int y = 2*cy + dy;
+                    if(x >= m_Width || y >= m_Height) continue;
+                    const unsigned char* p = rgba + ((size_t)y * m_Width + x) * 4;
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    n++;
+                }
+            }
+            uPlane[(size_t)cy * chromaWidth + cx] = rgbToU(r / n, g / n, b / n);
+            vPlane[(size_t)cy * chromaWidth + cx] = rgbToV(r / n, g / n, b / n);
+        }
+    }
+    if(fputs("FRAME\n", m_File) == EOF) return false;
+    return fwrite(m_Scratch.data(), 1, m_Scratch.size(), m_File) == m_Scratch.size();
+}
+
+bool FrameWriter::writePNG(const unsigned char* rgba){
+    if(m_NumberDigits < 0) return false;
+    std::string number = std::to_string(m_FramesWritten);
+    if((int)number.size() < m_NumberDigits) number.insert(0, m_NumberDigits - number.size(), '0');
+    const std::string filepath = m_PathPrefix + number + m_PathSuffix;
+    FILE* file = fopen(filepath.c_str(), "wb");
+    if(file == NULL){
+        std::cerr << "Failed to open output file: " << filepath << std::endl;
+        return false;
+    }
+
+    //scanlines with filter type 0 (none)
+    const size_t rowSize = (size_t)m_Width * 4;
+    m_Scratch.resize((rowSize + 1) * m_Height);
+    for(int y = 0; y < m_Height; y++){
+        m_Scratch[y * (rowSize + 1)] = 0;
+        std::copy(rgba + y * rowSize, rgba + (y + 1) * rowSize, &m_Scratch[y * (rowSize + 1) + 1]);
+    }
+
+    //zlib stream made of stored (uncompressed) deflate blocks, ffmpeg reencodes the frames anyway
+    std::vector<unsigned char> idat;
+    idat.reserve(m_Scratch.size() + m_Scratch.size() / 65535 * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    unsigned int adlerA = 1, adlerB = 0;
+    size_t offset = 0;
+    do{
+        const size_t blockSize = std::min((size_t)65535, m_Scratch.size() - offset);
+        const bool lastBlock = offset + blockSize == m_Scratch.size();
+        idat.push_back(lastBlock ? 1 : 0);
+        idat.push_back(blockSize & 0xFF);
+        idat.push_back((blockSize >> 8) & 0xFF);
+        idat.push_back(~blockSize & 0xFF);
+        idat.push_back((~blockSize >> 8) & 0xFF);
+        for(size_t i = offset; i < offset + blockSize; i++){
+            adlerA = (adlerA + m_Scratch[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        idat.insert(idat.end(), m_Scratch.begin() + offset, m_Scratch.begin() + offset + blockSize);
+        offset += blockSize;
+    } while(offset < m_Scratch.size());
+    putU32(idat, (adlerB << 16) | adlerA);
+
+    std::vector<unsigned char> header;
+    putU32(header, m_Width);
+    putU32(header, m_Height);
+    //8 bit depth, color type 6 (RGBA), deflate, no filter, no interlace
+    header.push_back(8);
+    header.push_back(6);
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(0);
+
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    bool ok = fwrite(signature, 1, 8, file) == 8;
+    ok = ok && writeChunk(file, "IHDR", header);
+    ok = ok && writeChunk(file, "IDAT", idat);
+    ok = ok && writeChunk(file, "IEND", std::vector<unsigned char>());
+    fclose(file);
+    return ok;
+}
+
+bool FrameWriter::ParseFormat(const std::string& name, Format& format){
+    if(name == "raw") format = Raw;
+    else if(name == "y4m") format = Y4M;
+    else if(name == "png") format = PNG;
+    else return false;
+    return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//writes rendered RGBA8 frames (top row first) as raw video, Y4M or a PNG sequence
+//raw and Y4M go to a single file ("-" = stdout), PNG paths come from a pattern with one frame number
+//conversion, %d or %0Nd ("%%" for a literal percent sign)
+class FrameWriter{
+    public:
+        enum Format{
+            Raw,
+            Y4M,
+            PNG
+        };
+
+    private:
+        Format m_Format;
+        std::string m_Path;
+        //PNG paths: prefix, frame number zero padded to m_NumberDigits (0 = no padding), suffix
+        //m_NumberDigits is -1 if the pattern was rejected
+        std::string m_PathPrefix, m_PathSuffix;
+        int m_NumberDigits;
+        int m_Width, m_Height, m_Fps;
+        FILE* m_File;
+        unsigned long long m_FramesWritten;
+        //scratch space for the converted frame (YUV planes or PNG scanlines)
+        std::vector<unsigned char> m_Scratch;
+
+        bool writeY4M(const unsigned char* rgba);
+        bool writePNG(const unsigned char* rgba);
+
+    public:
+        FrameWriter(Format format, const std::string& path, int width, int height, int fps);
+        ~FrameWriter();
+
+        bool isOpen() const;
+        bool writeFrame(const unsigned char* rgba);
+        //flushes and closes the output, called by the destructor
+        void close();
+
+        inline unsigned long long getFramesWritten() const { return m_FramesWritten; }
+
+        //"raw", "y4m" or "png", returns false for anything else
+        static bool ParseFormat(const std::string& name, Format& format);
+};
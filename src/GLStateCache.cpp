@@ -0,0 +1,135 @@
+#include "GLStateCache.h"
+#include "ErrorHandler.h"
+
+#include <cstring>
+
+//binding that does not match any object name, the next bind always reaches GL
+#define GLSTATE_UNKNOWN 0xFFFFFFFFu
+
+GLStateCache::GLStateCache(){
+    std::memset(m_Issued, 0, sizeof(m_Issued));
+    std::memset(m_Avoided, 0, sizeof(m_Avoided));
+    std::memset(m_LastIssued, 0, sizeof(m_LastIssued));
+    std::memset(m_LastAvoided, 0, sizeof(m_LastAvoided));
+    invalidate();
+}
+
+GLStateCache& GLStateCache::Get(){
+    static GLStateCache cache;
+    return cache;
+}
+
+const char* GLStateCache::GetKindName(GLStateKind kind){
+    switch(kind){
+        case GLSTATE_PROGRAM: return "program";
+        case GLSTATE_VERTEX_ARRAY: return "vertex array";
+        case GLSTATE_ARRAY_BUFFER: return "array buffer";
+        case GLSTATE_ELEMENT_BUFFER: return "element buffer";
+        case GLSTATE_TEXTURE: return "texture";
+        case GLSTATE_BLEND: return "blend";
+        default: return "unknown";
+    }
+}
+
+void GLStateCache::invalidate(){
+    m_Program = GLSTATE_UNKNOWN;
+    m_VertexArray = GLSTATE_UNKNOWN;
+    m_ArrayBuffer = GLSTATE_UNKNOWN;
+    m_ElementBuffers.clear();
+    m_ActiveTexture = GLSTATE_UNKNOWN;
+    for(int i = 0; i < GLSTATE_TEXTURE_UNITS; i++) m_Textures[i] = GLSTATE_UNKNOWN;
+    m_Blend = -1;
+    m_BlendSource = GLSTATE_UNKNOWN;
+    m_BlendDestination = GLSTATE_UNKNOWN;
+}
+
+void GLStateCache::beginFrame(){
+    std::memcpy(m_LastIssued, m_Issued, sizeof(m_Issued));
+    std::memcpy(m_LastAvoided, m_Avoided, sizeof(m_Avoided));
+    std::memset(m_Issued, 0, sizeof(m_Issued));
+    std::memset(m_Avoided, 0, sizeof(m_Avoided));
+}
+
+void GLStateCache::useProgram(unsigned int program){
+    if(!change(GLSTATE_PROGRAM, m_Program != program)) return;
+    GLCall(glUseProgram(program));
+    m_Program = program;
+}
+
+void GLStateCache::bindVertexArray(unsigned int vertexArray){
+    if(!change(GLSTATE_VERTEX_ARRAY, m_VertexArray != vertexArray)) return;
+    GLCall(glBindVertexArray(vertexArray));
+    m_VertexArray = vertexArray;
+}
+
+void GLStateCache::bindArrayBuffer(unsigned int buffer){
+    if(!change(GLSTATE_ARRAY_BUFFER, m_ArrayBuffer != buffer)) return;
+    GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    m_ArrayBuffer = buffer;
+}
+
+void GLStateCache::bindElementBuffer(unsigned int buffer){
+    //without a known vertex array the binding cannot be attributed, so it is not remembered
+    if(m_VertexArray == GLSTATE_UNKNOWN){
+        change(GLSTATE_ELEMENT_BUFFER, true);
+        GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer));
+        return;
+    }
+    std::unordered_map<unsigned int, unsigned int>::iterator bound = m_ElementBuffers.find(m_VertexArray);
+    if(!change(GLSTATE_ELEMENT_BUFFER, bound == m_ElementBuffers.end() || bound->second != buffer)) return;
+    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer));
+    m_ElementBuffers[m_VertexArray] = buffer;
+}
+
+void GLStateCache::bindTexture2D(unsigned int unit, unsigned int texture){
+    //texture calls that follow a bind act on the active unit, so it is selected even if the bind is skipped
+    if(m_ActiveTexture != unit){
+        GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+        m_ActiveTexture = unit;
+    }
+    const bool tracked = unit < GLSTATE_TEXTURE_UNITS;
+    if(!change(GLSTATE_TEXTURE, !tracked || m_Textures[unit] != texture)) return;
+    GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+    if(tracked) m_Textures[unit] = texture;
+}
+
+void GLStateCache::setBlend(bool enabled){
+    if(!change(GLSTATE_BLEND, m_Blend != (int)enabled)) return;
+    if(enabled){
+        GLCall(glEnable(GL_BLEND));
+    }
+    else{
+        GLCall(glDisable(GL_BLEND));
+    }
+    m_Blend = (int)enabled;
+}
+
+void GLStateCache::setBlendFunc(GLenum source, GLenum destination){
+    if(!change(GLSTATE_BLEND, m_BlendSource != source || m_BlendDestination != destination)) return;
+    GLCall(glBlendFunc(source, destination));
+    m_BlendSource = source;
+    m_BlendDestination = destination;
+}
+
+void GLStateCache::onDeleteProgram(unsigned int program){
+    //a deleted program stays in use until another one is, but its name is unreliable from now on
+    if(m_Program == program) m_Program = GLSTATE_UNKNOWN;
+}
+
+void GLStateCache::onDeleteVertexArray(unsigned int vertexArray){
+    if(m_VertexArray == vertexArray) m_VertexArray = 0;
+    m_ElementBuffers.erase(vertexArray);
+}
+
+void GLStateCache::onDeleteBuffer(unsigned int buffer){
+    if(m_ArrayBuffer == buffer) m_ArrayBuffer = 0;
+    for(std::unordered_map<unsigned int, unsigned int>::iterator it = m_ElementBuffers.begin(); it != m_ElementBuffers.end(); ++it){
+        if(it->second == buffer) it->second = GLSTATE_UNKNOWN;
+    }
+}
+
+void GLStateCache::onDeleteTexture(unsigned int texture){
+    for(int i = 0; i < GLSTATE_TEXTURE_UNITS; i++){
+        if(m_Textures[i] == texture) m_Textures[i] = 0;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <unordered_map>
+
+//texture units tracked by the cache, binds to higher units always reach GL
+#define GLSTATE_TEXTURE_UNITS 16
+
+//kinds of state changes counted by the cache
+typedef enum{
+    GLSTATE_PROGRAM = 0,
+    GLSTATE_VERTEX_ARRAY,
+    GLSTATE_ARRAY_BUFFER,
+    GLSTATE_ELEMENT_BUFFER,
+    GLSTATE_TEXTURE,
+    GLSTATE_BLEND,
+    GLSTATE_NUM_KINDS
+} GLStateKind;
+
+//remembers the bindings set through it so binding what is already bound never reaches GL
+//the GL wrappers (Shader, VertexArray, buffers, Texture) bind through it; code that changes the same state
+//directly has to restore it (as the ImGui backend does) or call invalidate()
+//one cache per process, for the context current on the render thread
+class GLStateCache{
+    private:
+        unsigned int m_Program;
+        unsigned int m_VertexArray;
+        unsigned int m_ArrayBuffer;
+        //the element buffer binding is vertex array state, so it is remembered per vertex array
+        std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+        unsigned int m_ActiveTexture;
+        unsigned int m_Textures[GLSTATE_TEXTURE_UNITS];
+        //-1 = unknown
+        int m_Blend;
+        GLenum m_BlendSource;
+        GLenum m_BlendDestination;
+
+        //changes that reached GL / were skipped, for the current and the previous frame
+        unsigned long long m_Issued[GLSTATE_NUM_KINDS];
+        unsigned long long m_Avoided[GLSTATE_NUM_KINDS];
+        unsigned long long m_LastIssued[GLSTATE_NUM_KINDS];
+        unsigned long long m_LastAvoided[GLSTATE_NUM_KINDS];
+
+        GLStateCache();
+        //true if the change has to reach GL, counts it either way
+        inline bool change(GLStateKind kind, bool needed){
+            if(needed) m_Issued[kind]++;
+            else m_Avoided[kind]++;
+            return needed;
+        }
+
+    public:
+        static GLStateCache& Get();
+        static const char* GetKindName(GLStateKind kind);
+
+        //forgets every binding, the next bind of each kind reaches GL (e.g. after a new context was made current)
+        void invalidate();
+        //moves the counters of the current frame to the previous frame
+        void beginFrame();
+
+        void useProgram(unsigned int program);
+        void bindVertexArray(unsigned int vertexArray);
+        void bindArrayBuffer(unsigned int buffer);
+        //binds into the current vertex array
+        void bindElementBuffer(unsigned int buffer);
+        //also makes unit the active texture unit
+        void bindTexture2D(unsigned int unit, unsigned int texture);
+        void setBlend(bool enabled);
+        void setBlendFunc(GLenum source, GLenum destination);
+
+        //GL unbinds deleted objects and may reuse their names, so the wrappers report deletions here
+        void onDeleteProgram(unsigned int program);
+        void onDeleteVertexArray(unsigned int vertexArray);
+        void onDeleteBuffer(unsigned int buffer);
+        void onDeleteTexture(unsigned int texture);
+
+        inline unsigned long long getLastIssued(GLStateKind kind) const { return m_LastIssued[kind]; }
+        inline unsigned long long getLastAvoided(GLStateKind kind) const { return m_LastAvoided[kind]; }
+};
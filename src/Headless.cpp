@@ -0,0 +1,284 @@
+#include "Headless.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ErrorHandler.h"
+#include "GLStateCache.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ShaderManager.h"
+#include "UniformBuffer.h"
+#include "ImgTexture.h"
+#include "FrameBuffer.h"
+#include "FrameCapture.h"
+#include "AnalysisEngine.h"
+#include "HopAnalyzer.h"
+#include "AudioPlayer.h"
+#include "Profiler.h"
+#include "FrameArena.h"
+#include "Layout.h"
+#include "Tracer.h"
+#include "Visualizer.h"
+#include "VisualizerConfig.h"
+#include "ColorThemes.h"
+#include "vendor/glm/glm.hpp"
+#include "vendor/glm/gtc/matrix_transform.hpp"
+#include "vendor/miniaudio/miniaudio.h"
+
+bool CreateOffscreenContext(bool useEGL, GLFWwindow*& window){
+    //the null platform needs no display server; the context comes from EGL or OSMesa
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if(!glfwInit()){
+        std::cerr << "Failed to initialize GLFW (null platform)" << std::endl;
+        return false;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, useEGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+
+    window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Audio Visualizer (headless)", nullptr, nullptr);
+    if(!window){
+        std::cerr << "Failed to create offscreen " << (useEGL ? "EGL" : "OSMesa") << " context" << std::endl;
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)){
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return false;
+    }
+    return true;
+}
+
+//hops decoded and analyzed together, one chunk is analyzed while the previous one is rendered
+#define HEADLESS_CHUNK_HOPS 256
+
+typedef struct{
+    //whole hops of interleaved samples
+    std::vector<float> samples;
+    std::vector<HopAnalysis> hops;
+    //samples decoded so far including the partial hop carried into the next chunk
+    size_t samplesDecoded;
+    bool trackEnded;
+} AnalysisChunk;
+
+static void decodeChunk(ma_decoder& decoder, std::vector<float>& leftover, size_t samplesDecoded, AnalysisChunk& chunk){
+    TRACE_SCOPE("decode chunk");
+    const ma_uint64 framesWanted = HEADLESS_CHUNK_HOPS * ANALYSIS_HOP_SAMPLES / 2;
+    chunk.samples.swap(leftover);
+    const size_t carried = chunk.samples.size();
+    chunk.samples.resize(carried + framesWanted * 2);
+
+    ma_uint64 framesRead = 0;
+    ma_result result = ma_decoder_read_pcm_frames(&decoder, chunk.samples.data() + carried, framesWanted, &framesRead);
+    chunk.trackEnded = (result == MA_AT_END) || (framesRead < framesWanted);
+    chunk.samplesDecoded = samplesDecoded + framesRead * 2;
+
+    //keep the unfinished hop for the next chunk
+    const size_t wholeHops = (carried + framesRead * 2) / ANALYSIS_HOP_SAMPLES;
+    leftover.assign(chunk.samples.begin() + wholeHops * ANALYSIS_HOP_SAMPLES, 
+        chunk.samples.begin() + carried + framesRead * 2);
+    chunk.samples.resize(wholeHops * ANALYSIS_HOP_SAMPLES);
+    chunk.hops.resize(wholeHops);
+}
+
+//hops do not depend on each other before smoothing, so every thread takes a contiguous time range
+static void analyzeChunk(std::vector<std::unique_ptr<HopAnalyzer>>& analyzers, AnalysisChunk& chunk){
+    const size_t numHops = chunk.hops.size();
+    const size_t numThreads = std::min(analyzers.size(), numHops);
+    //same window as the interactive loop: the most recent part of each hop
+    const size_t windowOffset = ANALYSIS_HOP_SAMPLES - ANALYSIS_WINDOW_SAMPLES;
+    auto analyzeRange = [&chunk, windowOffset](HopAnalyzer* analyzer, size_t begin, size_t end){
+        TRACE_THREAD_NAME("analysis worker");
+        TRACE_SCOPE("analyze hops");
+        for(size_t hop = begin; hop < end; hop++){
+            analyzer->compute(chunk.samples.data() + hop * ANALYSIS_HOP_SAMPLES + windowOffset, 
+                ANALYSIS_WINDOW_SAMPLES, chunk.hops[hop]);
+        }
+    };
+    if(numThreads <= 1){
+        analyzeRange(analyzers[0].get(), 0, numHops);
+        return;
+    }
+    std::vector<std::thread> workers;
+    const size_t hopsPerThread = (numHops + numThreads - 1) / numThreads;
+    for(size_t t = 0; t < numThreads; t++){
+        const size_t begin = t * hopsPerThread;
+        const size_t end = std::min(begin + hopsPerThread, numHops);
+        if(begin >= end) break;
+        workers.push_back(std::thread(analyzeRange, analyzers[t].get(), begin, end));
+    }
+    for(size_t t = 0; t < workers.size(); t++) workers[t].join();
+}
+
+int RunHeadless(const HeadlessOptions& options){
+    TRACE_THREAD_NAME("headless render");
+    GLFWwindow* window = nullptr;
+    if(!CreateOffscreenContext(options.useEGL, window)) return -1;
+
+    ma_decoder decoder;
+    if(createDecoder(decoder, options.inputPath.c_str()) != 0){
+        std::cerr << "Failed to open audio file: " << options.inputPath << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return -1;
+    }
+
+    //a new context starts with default state, whatever the cache remembers belongs to an older one
+    GLStateCache::Get().invalidate();
+    GLStateCache::Get().setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::Get().setBlend(true);
+    ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress);
+    Profiler::Get().initGpu();
+
+    std::vector<ColorThemes::Theme> themeTable;
+    ColorThemes::InitializeThemes(themeTable);
+    ColorThemes::Theme* theme = &themeTable[ColorThemes::ResolveTheme(themeTable, options.themeIndex)];
+    AuxComputations::RGBAColor bgColorTheme = theme->getBG();
+
+    unsigned int numThreads = options.threads;
+    if(numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    //fftw planning is not thread-safe, so every analyzer is created here
+    std::vector<std::unique_ptr<HopAnalyzer>> analyzers;
+    for(unsigned int t = 0; t < numThreads; t++) analyzers.push_back(std::unique_ptr<HopAnalyzer>(new HopAnalyzer()));
+
+    int exitCode = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    size_t samplesDecoded = 0;
+    unsigned long long framesWritten = 0;
+    {
+        //same graph objects and smoothing as the interactive window
+        Visualizer visualizer(theme);
+        //hops are analyzed by the worker threads, the engine only applies the smoothing in order
+        AnalysisEngine engine;
+        engine.reset(visualizer.getFreqGraph().getLeftHeights(), visualizer.getFreqGraph().getRightHeights());
+        Shader shader("./res/shaders/shader.glsl");
+        std::vector<unsigned char> paletteTexels;
+        ColorThemes::PackPalettes(themeTable, paletteTexels);
+        Texture paletteTexture(PALETTE_PERIOD, 2 * (int)themeTable.size(), paletteTexels.data());
+        Renderer renderer;
+        FrameBuffer frameBuffer(WINDOW_WIDTH, WINDOW_HEIGHT);
+        //lossless: waits for the GPU or the writer instead of dropping frames
+        FrameCapture capture(frameBuffer.GetWidth(), frameBuffer.GetHeight(), true);
+        if(!capture.Start(options.format, options.outputPath, options.fps)) exitCode = -1;
+
+        //the frame buffer has the design size, so the layout maps design units 1:1 to pixels
+        FrameConstants frameConstants;
+        Layout().fillFrameConstants(frameConstants);
+        UniformBuffer frameConstantsBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+        //frames advance on the video clock, so a render is the same however long it takes
+        const float frameSeconds = 1.0f / options.fps;
+        unsigned long long frameNumber = 0;
+
+        //interleaved samples up to the end of video frame n (counting from 1), taken from the frame number
+        //so a rate that does not divide the sample rate (e.g. 144 fps) does not drift away from the audio
+        auto videoFrameEnd = [&](unsigned long long n) -> size_t{
+            return (size_t)(n * 2 * AUDIO_SAMPLE_RATE / options.fps);
+        };
+        size_t hopsApplied = 0;
+        //last interleaved sample covered by the next video frame
+        size_t nextFrameEnd = videoFrameEnd(1);
+
+        //draws the state after hopsApplied hops, alpha covers the part of the next hop already elapsed
+        auto renderFrame = [&](size_t frameEnd) -> bool{
+            FrameArena::Get().reset();
+            Profiler::Get().beginFrame();
+            GLStateCache::Get().beginFrame();
+            TRACE_SCOPE("render frame");
+            float alpha = std::min(1.0f, (float)(frameEnd - hopsApplied * ANALYSIS_HOP_SAMPLES) / ANALYSIS_HOP_SAMPLES);
+            frameBuffer.Bind();
+            renderer.Clear(bgColorTheme.r, bgColorTheme.g, bgColorTheme.b, bgColorTheme.a);
+            frameConstants.time = glm::vec4(frameNumber * frameSeconds, frameSeconds, alpha, (float)frameNumber);
+            frameNumber++;
+            visualizer.fillFrameConstants(frameConstants);
+            frameConstantsBuffer.Update(&frameConstants, sizeof(frameConstants));
+            shader.Bind();
+            paletteTexture.Bind(PALETTE_TEXTURE_UNIT);
+            Profiler::Get().beginGpu(PROFILE_GPU_VISUALIZER);
+            visualizer.draw(renderer, shader, alpha);
+            Profiler::Get().endGpu(PROFILE_GPU_VISUALIZER);
+            //readback overlaps with rendering the next frames, encoding runs on the writer thread
+            capture.Capture(frameBuffer.GetRendererID());
+            frameBuffer.Unbind();
+            if(capture.HasWriteFailed()){
+                std::cerr << "Failed to write frame " << capture.GetFramesCaptured() << std::endl;
+                return false;
+            }
+            return true;
+        };
+        //every frame whose end falls inside the hop that follows the applied ones
+        auto renderDueFrames = [&](size_t available) -> bool{
+            while(nextFrameEnd <= available && nextFrameEnd / ANALYSIS_HOP_SAMPLES == hopsApplied){
+                if(!renderFrame(nextFrameEnd)) return false;
+                nextFrameEnd = videoFrameEnd(frameNumber + 1);
+            }
+            return true;
+        };
+
+        AnalysisChunk chunks[2];
+        std::vector<float> leftover;
+        int current = 0;
+        decodeChunk(decoder, leftover, samplesDecoded, chunks[current]);
+        samplesDecoded = chunks[current].samplesDecoded;
+        std::future<void> analysis = std::async(std::launch::async, analyzeChunk, std::ref(analyzers), std::ref(chunks[current]));
+
+        bool running = exitCode == 0;
+        while(running){
+            {
+                TRACE_SCOPE("wait for analysis");
+                analysis.get();
+            }
+            AnalysisChunk& chunk = chunks[current];
+            //start on the next chunk before rendering this one
+            if(!chunk.trackEnded){
+                AnalysisChunk& next = chunks[1 - current];
+                decodeChunk(decoder, leftover, samplesDecoded, next);
+                samplesDecoded = next.samplesDecoded;
+                analysis = std::async(std::launch::async, analyzeChunk, std::ref(analyzers), std::ref(next));
+            }
+            for(size_t hop = 0; hop < chunk.hops.size() && running; hop++){
+                running = renderDueFrames(chunk.samplesDecoded);
+                visualizer.update(engine.apply(chunk.hops[hop]));
+                hopsApplied++;
+            }
+            running = running && renderDueFrames(chunk.samplesDecoded);
+            if(chunk.trackEnded) break;
+            current = 1 - current;
+        }
+        if(analysis.valid()) analysis.wait();
+        //the tail of the track shorter than one video frame still gets a frame
+        if(running && samplesDecoded > videoFrameEnd(frameNumber)){
+            running = renderFrame(samplesDecoded);
+        }
+        capture.Stop();
+        framesWritten = capture.GetFramesCaptured();
+        if(!running || capture.HasWriteFailed()) exitCode = -1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double trackSeconds = (double)samplesDecoded / (2 * AUDIO_SAMPLE_RATE);
+    std::cerr << "Rendered " << framesWritten << " frames (" << (int)WINDOW_WIDTH << "x" << (int)WINDOW_HEIGHT 
+        << ", " << options.fps << " fps) in " << elapsed << " s, " << trackSeconds / std::max(elapsed, 1e-6) 
+        << "x realtime on " << numThreads << " analysis threads" << std::endl;
+
+    if(!options.profilePath.empty()) Profiler::Get().exportJSON(options.profilePath);
+    if(Tracer::IsEnabled()) Tracer::Dump();
+
+    Profiler::Get().destroyGpu();
+    ma_decoder_uninit(&decoder);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return exitCode;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+#include "FrameWriter.h"
+
+struct GLFWwindow;
+
+typedef struct{
+    std::string inputPath;
+    //"-" writes to stdout, for png a printf pattern such as "frames/frame_%06d.png"
+    std::string outputPath;
+    FrameWriter::Format format;
+    int fps;
+    //worker threads for the analysis, 0 = one per hardware thread
+    unsigned int threads;
+    //EGL (surfaceless) instead of OSMesa (llvmpipe) for the offscreen context
+    bool useEGL;
+    //index into res/themes/themes.ini (wraps around), negative = DEFAULT_THEME_ID
+    int themeIndex;
+    //per-stage timing summary (JSON) written at the end, empty = none
+    std::string profilePath;
+} HeadlessOptions;
+
+//renders a track into an offscreen framebuffer without a display, window or audio device
+//runs as fast as possible: analysis is spread over worker threads one chunk of hops ahead of rendering
+//frames are WINDOW_WIDTH x WINDOW_HEIGHT at options.fps, written by a FrameWriter
+int RunHeadless(const HeadlessOptions& options);
+
+//initializes GLFW on the null platform with an invisible WINDOW_WIDTH x WINDOW_HEIGHT GL 3.3 core context
+//(EGL or OSMesa) and loads GL, the caller destroys the window and terminates GLFW
+bool CreateOffscreenContext(bool useEGL, GLFWwindow*& window);
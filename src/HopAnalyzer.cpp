@@ -0,0 +1,163 @@
+#include "HopAnalyzer.h"
+
+#include <cmath>
+#include <numeric>
+#include <cassert>
+#include <algorithm>
+
+#include "AuxComputations.h"
+#include "Profiler.h"
+
+void generateCustomBins(float* freqTable){
+    int currentFreq = 0;
+    std::vector<float> hertzPartitions = HERTZ_PARTITIONS_INIT;
+    std::vector<int> binPartitions = BIN_PARTITIONS_INIT;
+
+    assert(hertzPartitions.size() == binPartitions.size() + 1 
+        && "Hertz partitions must be of size bin partitions + 1");
+    assert(std::accumulate(binPartitions.begin(), binPartitions.end(), 0) == NUM_GRAPH_SAMPLES 
+        && "Bin partitions must accumulate to the number of graph samples");
+
+    for(int part_c = 0; part_c < binPartitions.size(); part_c++){
+        float hertzPerBin = (hertzPartitions[part_c+1] - hertzPartitions[part_c]) / binPartitions[part_c];
+        for(int i = 0; i < binPartitions[part_c]; i++){
+            freqTable[currentFreq] = hertzPartitions[part_c] + i * (hertzPerBin);
+            currentFreq++;
+        }
+    }
+    freqTable[NUM_GRAPH_SAMPLES] = MAX_FREQ;
+}
+
+void computeFreqTargets(fftw_complex* leftSamples, fftw_complex* rightSamples, float* freqSeparationTable, 
+    float* leftTargets, float* rightTargets, int firstBar, int lastBar){
+    for(int visBin = firstBar; visBin < lastBar; visBin++){
+        float startFreq = freqSeparationTable[visBin];
+        float endFreq = freqSeparationTable[visBin+1];
+        //compute starting and ending position of bins
+        int startBin = (int)(startFreq / BIN_WIDTH_FREQ_RANGE);
+        int endBin = (int)(endFreq / BIN_WIDTH_FREQ_RANGE);
+
+        if (endBin <= startBin){
+            endBin = startBin + 1;
+        }
+
+        if (endBin > NUM_FFT_SAMPLES / 2){
+            endBin = NUM_FFT_SAMPLES / 2;
+            startBin = endBin - 1;
+        }
+
+        float centerFreq = (startFreq + endFreq) / 2.0f;
+        //0.5f = tight central emphasis, 1.0f = default, 2.0f = less weight focus
+        float weightingFactor = 1.7f;
+        float sigma = (endFreq - startFreq) / 2.0f * weightingFactor;
+
+        float leftWeightedSum = 0.0f, rightWeightedSum = 0.0f;
+        float weightTotal = 0.0f;
+
+        //compute magnitudes of both left and right channels within the given frequency range
+        float re, im;
+        for (int i = startBin; i < endBin && i < (NUM_FFT_SAMPLES/2 + 1); i++) {
+            float binFreq = i * BIN_WIDTH_FREQ_RANGE;
+            float dist = binFreq - centerFreq;
+
+            // Gaussian weighting, e^-0.5(((x-u)/s)^2), smaller sigma means stricter fall-off
+            float weight = expf(-0.5f * (dist * dist) / (sigma * sigma + 1e-6f));
+            re = leftSamples[i][0], im = leftSamples[i][1];
+            float leftMag = sqrtf(fmaxf(0.0f, re * re + im * im));
+
+            re = rightSamples[i][0], im = rightSamples[i][1];
+            float rightMag = sqrtf(fmaxf(0.0f, re * re + im * im));
+
+            leftWeightedSum += leftMag * weight;
+            rightWeightedSum += rightMag * weight;
+            weightTotal += weight;
+        }
+        int gain = 30;
+        //compute overall height of left and right sample
+        float leftHeight = (leftWeightedSum / (weightTotal + 1e-6f)) / NUM_FFT_SAMPLES * MAX_AMPLITUDE_HEIGHT * gain;
+        float rightHeight = (rightWeightedSum / (weightTotal + 1e-6f)) / NUM_FFT_SAMPLES * MAX_AMPLITUDE_HEIGHT * gain;
+
+        //set default value to 0 if value is invalid
+        if(std::isnan(leftHeight) || std::isinf(leftHeight) || leftHeight < 0) leftHeight = 0;
+        if(std::isnan(rightHeight) || std::isinf(rightHeight) || rightHeight < 0) rightHeight = 0;
+
+        leftTargets[visBin] = leftHeight;
+        rightTargets[visBin] = rightHeight;
+    }
+}
+
+void computeSpectrogramRow(fftw_complex* leftSamples, fftw_complex* rightSamples, float* row, int firstBin, int lastBin){
+    //a full scale sine fills its bin with half the window length (the zero padding adds nothing)
+    const float fullScale = ANALYSIS_WINDOW_SAMPLES / 4.0f;
+    const float fullScalePower = fullScale * fullScale;
+    for(int i = firstBin; i < lastBin; i++){
+        //mean power of both channels, one log per bin and no square roots
+        const float leftPower = leftSamples[i][0] * leftSamples[i][0] + leftSamples[i][1] * leftSamples[i][1];
+        const float rightPower = rightSamples[i][0] * rightSamples[i][0] + rightSamples[i][1] * rightSamples[i][1];
+        const float dB = 10.0f * log10f(0.5f * (leftPower + rightPower) / fullScalePower + 1e-12f);
+        row[i] = std::min(std::max((dB + SPECTROGRAM_RANGE_DB) / SPECTROGRAM_RANGE_DB, 0.0f), 1.0f);
+    }
+}
+
+HopAnalyzer::HopAnalyzer()
+    : m_Window(ANALYSIS_WINDOW_SAMPLES, 0.0f){
+    m_LeftIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
+    m_LeftOut = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (NUM_FFT_SAMPLES/2 + 1));
+    m_RightIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
+    m_RightOut = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (NUM_FFT_SAMPLES/2 + 1));
+    std::fill(m_LeftIn, m_LeftIn + NUM_FFT_SAMPLES, 0.0);
+    std::fill(m_RightIn, m_RightIn + NUM_FFT_SAMPLES, 0.0);
+
+    m_PlanLeft = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, m_LeftIn, m_LeftOut, FFTW_ESTIMATE);
+    m_PlanRight = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, m_RightIn, m_RightOut, FFTW_ESTIMATE);
+
+    generateCustomBins(m_CustomFreqSpacingTable);
+}
+
+HopAnalyzer::~HopAnalyzer(){
+    fftw_destroy_plan(m_PlanLeft);
+    fftw_destroy_plan(m_PlanRight);
+    fftw_free(m_LeftIn);
+    fftw_free(m_LeftOut);
+    fftw_free(m_RightIn);
+    fftw_free(m_RightOut);
+}
+
+void HopAnalyzer::compute(const float* samples, size_t count, HopAnalysis& result){
+    computePeak(samples, count, result);
+    computeSpectrum(samples, count, 0);
+    computeSpectrum(samples, count, 1);
+    computeTargets(result, 0, NUM_GRAPH_SAMPLES);
+    computeSpectrogram(result, 0, SPECTROGRAM_BINS);
+}
+
+void HopAnalyzer::computePeak(const float* samples, size_t count, HopAnalysis& result){
+    PROFILE_SCOPE(PROFILE_PEAK);
+    m_Window.assign(samples, samples + count);
+    result.leftPeak = 0.0f;
+    result.rightPeak = 0.0f;
+    AuxComputations::computePeakValueStereo(m_Window, count, result.leftPeak, result.rightPeak);
+}
+
+void HopAnalyzer::computeSpectrum(const float* samples, size_t count, int channel){
+    PROFILE_SCOPE(PROFILE_FFT);
+    double* in = channel == 0 ? m_LeftIn : m_RightIn;
+    //deinterleave one channel of the window into the zero padded fft input
+    std::fill(in, in + NUM_FFT_SAMPLES, 0.0);
+    const size_t frames = std::min(count / 2, (size_t)NUM_FFT_SAMPLES);
+    for(size_t i = 0; i < frames; i++){
+        in[i] = (double) samples[2*i + channel];
+    }
+    fftw_execute(channel == 0 ? m_PlanLeft : m_PlanRight);
+}
+
+void HopAnalyzer::computeTargets(HopAnalysis& result, int firstBar, int lastBar){
+    PROFILE_SCOPE(PROFILE_FREQ_VALUES);
+    computeFreqTargets(m_LeftOut, m_RightOut, m_CustomFreqSpacingTable, result.leftFreqTargets, result.rightFreqTargets, 
+        firstBar, lastBar);
+}
+
+void HopAnalyzer::computeSpectrogram(HopAnalysis& result, int firstBin, int lastBin){
+    PROFILE_SCOPE(PROFILE_FREQ_VALUES);
+    computeSpectrogramRow(m_LeftOut, m_RightOut, result.spectrum, firstBin, lastBin);
+}
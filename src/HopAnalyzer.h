@@ -0,0 +1,59 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+
+#include "VisualizerConfig.h"
+
+//everything one analysis hop contributes to the graphs, before any smoothing
+//hops are independent of each other, so they can be computed out of order or in parallel
+typedef struct{
+    float leftPeak;
+    float rightPeak;
+    float leftFreqTargets[NUM_GRAPH_SAMPLES];
+    float rightFreqTargets[NUM_GRAPH_SAMPLES];
+    //spectrogram row: level of every fft bin (both channels), 0 = SPECTROGRAM_RANGE_DB below full scale, 1 = full scale
+    float spectrum[SPECTROGRAM_BINS];
+} HopAnalysis;
+
+void generateCustomBins(float* freqTable);
+
+//gaussian-weighted magnitude of the fft bins under each graph bar in [firstBar, lastBar)
+void computeFreqTargets(fftw_complex* leftSamples, fftw_complex* rightSamples, float* freqSeparationTable, 
+    float* leftTargets, float* rightTargets, int firstBar = 0, int lastBar = NUM_GRAPH_SAMPLES);
+
+//spectrogram levels of the fft bins in [firstBin, lastBin), see HopAnalysis::spectrum
+void computeSpectrogramRow(fftw_complex* leftSamples, fftw_complex* rightSamples, float* row, 
+    int firstBin = 0, int lastBin = SPECTROGRAM_BINS);
+
+//peak + FFT of one analysis window, owns its own fft buffers and plans
+//one instance per thread: construct on the main thread (fftw planning is not thread-safe),
+//compute() may then run on any thread
+class HopAnalyzer{
+    private:
+        double* m_LeftIn;
+        fftw_complex* m_LeftOut;
+        double* m_RightIn;
+        fftw_complex* m_RightOut;
+        fftw_plan m_PlanLeft;
+        fftw_plan m_PlanRight;
+        float m_CustomFreqSpacingTable[NUM_GRAPH_SAMPLES+1];
+        //copy of the current window for the AuxComputations helpers, only used by computePeak
+        std::vector<float> m_Window;
+
+    public:
+        HopAnalyzer();
+        ~HopAnalyzer();
+
+        //analyzes count interleaved stereo samples (zero padded to NUM_FFT_SAMPLES frames)
+        void compute(const float* samples, size_t count, HopAnalysis& result);
+
+        //the stages of compute(), for running them as separate tasks:
+        //peak and both spectra are independent of each other, the targets need both spectra
+        //different stages (and the two channels) may run on different threads at the same time
+        void computePeak(const float* samples, size_t count, HopAnalysis& result);
+        //channel 0 = left, 1 = right
+        void computeSpectrum(const float* samples, size_t count, int channel);
+        void computeTargets(HopAnalysis& result, int firstBar, int lastBar);
+        void computeSpectrogram(HopAnalysis& result, int firstBin, int lastBin);
+};
@@ -1,5 +1,6 @@
 #include "ImgTexture.h"
 #include "ErrorHandler.h"
+#include "GLStateCache.h"
 #include "Renderer.h"
 #include "vendor/stb_image/stb_image.h"
 #include <iostream>
@@ -15,7 +16,7 @@ Texture::Texture(const std::string& path)
     
     //generate and bind a new texture
     GLCall(glGenTextures(1, &m_RendererID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    GLStateCache::Get().bindTexture2D(0, m_RendererID);
 
     //set all the parameters of the texture (required)
     //GL_TEXTURE_MIN_FILTER means minification (if image is larger than size to draw)
@@ -32,7 +33,7 @@ Texture::Texture(const std::string& path)
         //send image data to OpenGL
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
         //unbind the texture
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::Get().bindTexture2D(0, 0);
         //free the image buffer
         stbi_image_free(m_LocalBuffer);
     }
@@ -43,18 +44,33 @@ Texture::Texture(const std::string& path)
     }
 }
 
+Texture::Texture(int width, int height, const unsigned char* rgba)
+    : m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4){
+
+    GLCall(glGenTextures(1, &m_RendererID));
+    GLStateCache::Get().bindTexture2D(0, m_RendererID);
+    //texels are looked up by index, no blending between neighbours and no mipmaps
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    //rows of 4 byte texels are always 4 byte aligned, the default unpack alignment fits
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba));
+    GLStateCache::Get().bindTexture2D(0, 0);
+}
+
 Texture::~Texture(){
     GLCall(glDeleteTextures(1, &m_RendererID));
+    GLStateCache::Get().onDeleteTexture(m_RendererID);
 }
 
 void Texture::Bind(unsigned int slot) const{
     //bind the current texture to the specified slot (argument 1)
     //double check how many slots your system has 
     //(modern typically has 32, mobile typically has 8)
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    GLStateCache::Get().bindTexture2D(slot, m_RendererID);
 }
 
-void Texture::Unbind() const{
-    glBindTexture(GL_TEXTURE_2D, 0);
+void Texture::Unbind(unsigned int slot) const{
+    GLStateCache::Get().bindTexture2D(slot, 0);
 }
\ No newline at end of file
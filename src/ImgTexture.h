@@ -10,10 +10,12 @@ class Texture{
         int m_Width, m_Height, m_BPP;
     public:
         Texture(const std::string& path);
+        //rgba8 image from memory (e.g. the theme palettes), sampled without filtering
+        Texture(int width, int height, const unsigned char* rgba);
         ~Texture();
 
         void Bind(unsigned int slot = 0) const;
-        void Unbind() const;
+        void Unbind(unsigned int slot = 0) const;
 
         inline int Getwidth() const { return m_Width; }
         inline int GetHeight() const { return m_Height; }
@@ -1,5 +1,6 @@
 #include "IndexBuffer.h"
 #include "ErrorHandler.h"
+#include "GLStateCache.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
     : m_Count(count)
@@ -8,19 +9,20 @@ IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
     GLCall(glGenBuffers(1, &m_RendererID));
     //bind to buffer (select buffer), current buffer is an array (GL_ARRAY_BUFFER)
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLStateCache::Get().bindElementBuffer(m_RendererID);
     //set buffer data
     GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
 }
 
 IndexBuffer::~IndexBuffer(){
     GLCall(glDeleteBuffers(1, &m_RendererID));
+    GLStateCache::Get().onDeleteBuffer(m_RendererID);
 }
 
 void IndexBuffer::Bind() const{
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLStateCache::Get().bindElementBuffer(m_RendererID);
 }
 
 void IndexBuffer::Unbind() const{
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    GLStateCache::Get().bindElementBuffer(0);
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Layout.h"
+
+#include <algorithm>
+
+#include "vendor/glm/gtc/matrix_transform.hpp"
+
+Layout::Layout(){
+    update((int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, (int)WINDOW_WIDTH, (int)WINDOW_HEIGHT, 1.0f);
+}
+
+Layout::~Layout(){
+
+}
+
+void Layout::update(int framebufferWidth, int framebufferHeight, int windowWidth, int windowHeight, float contentScale){
+    //a minimized window reports 0x0, keep the transforms finite
+    m_Width = std::max(1, framebufferWidth);
+    m_Height = std::max(1, framebufferHeight);
+    m_ContentScale = contentScale > 0.0f ? contentScale : 1.0f;
+    m_PixelRatio = glm::vec2(windowWidth > 0 ? (float)m_Width / windowWidth : 1.0f, 
+        windowHeight > 0 ? (float)m_Height / windowHeight : 1.0f);
+
+    //largest uniform scale that fits the design, bars keep their proportions at any aspect ratio
+    const float graphScale = std::min(m_Width / WINDOW_WIDTH, m_Height / WINDOW_HEIGHT);
+    m_Anchors[LAYOUT_ANCHOR_GRAPHS] = glm::vec4(graphScale, graphScale, 
+        (m_Width - WINDOW_WIDTH * graphScale) / 2, (m_Height - WINDOW_HEIGHT * graphScale) / 2);
+
+    //buttons follow the display density (the content scale is in pixels per design unit on every platform),
+    //and shrink with the graphs once the window is smaller than the design
+    const float controlScale = std::min(m_ContentScale, graphScale);
+    //the top corners of the design stay in the top corners of the framebuffer
+    m_Anchors[LAYOUT_ANCHOR_TOP_LEFT] = glm::vec4(controlScale, controlScale, 
+        0.0f, m_Height - WINDOW_HEIGHT * controlScale);
+    m_Anchors[LAYOUT_ANCHOR_TOP_RIGHT] = glm::vec4(controlScale, controlScale, 
+        m_Width - WINDOW_WIDTH * controlScale, m_Height - WINDOW_HEIGHT * controlScale);
+}
+
+void Layout::fillFrameConstants(FrameConstants& constants) const{
+    constants.mvp = glm::ortho(0.0f, (float)m_Width, 0.0f, (float)m_Height, -1.0f, 1.0f);
+    for(int i = 0; i < LAYOUT_NUM_ANCHORS; i++) constants.anchors[i] = m_Anchors[i];
+}
+
+glm::vec2 Layout::toPixels(LayoutAnchor anchor, glm::vec2 design) const{
+    const glm::vec4& transform = m_Anchors[anchor];
+    return design * glm::vec2(transform.x, transform.y) + glm::vec2(transform.z, transform.w);
+}
+
+glm::vec2 Layout::windowToDesign(LayoutAnchor anchor, double x, double y) const{
+    const glm::vec4& transform = m_Anchors[anchor];
+    const glm::vec2 pixels((float)x * m_PixelRatio.x, m_Height - (float)y * m_PixelRatio.y);
+    return (pixels - glm::vec2(transform.z, transform.w)) / glm::vec2(transform.x, transform.y);
+}
+
+glm::vec2 Layout::designToWindow(LayoutAnchor anchor, glm::vec2 design) const{
+    const glm::vec2 pixels = toPixels(anchor, design);
+    return glm::vec2(pixels.x, m_Height - pixels.y) / m_PixelRatio;
+}
+
+float Layout::getWindowScale(LayoutAnchor anchor) const{
+    return m_Anchors[anchor].x / m_PixelRatio.x;
+}
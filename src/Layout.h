@@ -0,0 +1,43 @@
+#pragma once
+
+#include "FrameConstants.h"
+#include "VisualizerConfig.h"
+#include "vendor/glm/glm.hpp"
+
+//runtime layout of the window: where the geometry, authored once in design units (WINDOW_WIDTH x WINDOW_HEIGHT,
+//origin bottom left), lands in a framebuffer of any size; the graphs are scaled uniformly to fit and centered,
+//the buttons keep their size at the content scale of the monitor and stay in the top corners
+//a resize recomputes the projection and the anchor transforms of the frame constants, vertices are never regenerated
+class Layout{
+    private:
+        int m_Width, m_Height;
+        float m_ContentScale;
+        //framebuffer pixels per window coordinate on each axis (2 on macOS retina displays, 1 elsewhere)
+        glm::vec2 m_PixelRatio;
+        //design units to pixels per LayoutAnchor: xy = scale, zw = offset
+        glm::vec4 m_Anchors[LAYOUT_NUM_ANCHORS];
+
+    public:
+        //design size at scale 1, what the headless and multi-stream renders use
+        Layout();
+        ~Layout();
+
+        //framebuffer size in pixels, window size in screen coordinates, content scale of the window's monitor
+        void update(int framebufferWidth, int framebufferHeight, int windowWidth, int windowHeight, float contentScale);
+        //projection and anchor transforms, the rest of the constants is left alone
+        void fillFrameConstants(FrameConstants& constants) const;
+
+        //framebuffer pixels (origin bottom left) of a design position
+        glm::vec2 toPixels(LayoutAnchor anchor, glm::vec2 design) const;
+        //design position under window coordinates (cursor, ImGui; origin top left)
+        glm::vec2 windowToDesign(LayoutAnchor anchor, double x, double y) const;
+        //window coordinates (origin top left) of a design position
+        glm::vec2 designToWindow(LayoutAnchor anchor, glm::vec2 design) const;
+        //window coordinates per design unit of an anchor, sizes ImGui windows placed next to its geometry
+        //(LAYOUT_ANCHOR_TOP_LEFT: the ImGui font and style scale)
+        float getWindowScale(LayoutAnchor anchor) const;
+
+        inline int getWidth() const { return m_Width; }
+        inline int getHeight() const { return m_Height; }
+        inline float getContentScale() const { return m_ContentScale; }
+};
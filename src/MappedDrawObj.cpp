@@ -1,13 +1,15 @@
 #include "MappedDrawObj.h"
 
-MappedDrawObj::MappedDrawObj(float* positions, unsigned int* indices, size_t posLength, size_t indLength, VertexBufferLayout layout)
-    : va(), vb(positions, posLength * sizeof(float)), ib(indices, indLength){
+MappedDrawObj::MappedDrawObj(Vertex* vertices, unsigned int* indices, size_t vertLength, size_t indLength, VertexBufferLayout layout)
+    : va(), vb(vertices, vertLength * sizeof(Vertex)), ib(indices, indLength){
+    //the mapped pointer is written as an array of Vertex structs, so the layout has to match it
+    ASSERT(layout.GetStride() == sizeof(Vertex));
 
     va.AddBuffer(vb, layout);
     va.Unbind();
     vb.Bind();
     ib.Bind();
-    GLCall(mappedPositions = (float*) glMapBuffer(GL_ARRAY_BUFFER, GL_READ_WRITE));
+    GLCall(mappedVertices = (Vertex*) glMapBuffer(GL_ARRAY_BUFFER, GL_READ_WRITE));
     GLCall(mappedIndices = (unsigned int*) glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_READ_WRITE));
     vb.Unbind();
     ib.Unbind();
@@ -5,15 +5,16 @@
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "VertexBufferLayout.h"
+#include "Vertex.h"
 
 class MappedDrawObj{
     public:
         VertexArray va;
         VertexBuffer vb;
         IndexBuffer ib;
-        float* mappedPositions;
+        Vertex* mappedVertices;
         unsigned int* mappedIndices;
     public:
-        MappedDrawObj(float* positions, unsigned int* indices, size_t posLength, size_t indLength, VertexBufferLayout layout);
+        MappedDrawObj(Vertex* vertices, unsigned int* indices, size_t vertLength, size_t indLength, VertexBufferLayout layout);
         ~MappedDrawObj();
 };
\ No newline at end of file
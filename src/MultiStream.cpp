@@ -0,0 +1,319 @@
+#include "MultiStream.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ErrorHandler.h"
+#include "GLStateCache.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ShaderManager.h"
+#include "UniformBuffer.h"
+#include "ImgTexture.h"
+#include "MappedDrawObj.h"
+#include "AnalysisEngine.h"
+#include "AudioPlayer.h"
+#include "BarGraph.h"
+#include "SampleLine.h"
+#include "ColorThemes.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "FrameArena.h"
+#include "Layout.h"
+#include "Tracer.h"
+#include "Visualizer.h"
+#include "VisualizerConfig.h"
+#include "vendor/glm/glm.hpp"
+#include "vendor/glm/gtc/matrix_transform.hpp"
+#include "vendor/miniaudio/miniaudio.h"
+
+//background + amplitude graph + frequency graph + 2 decibel meters
+#define STREAM_CELL_QUADS (1 + 2*NUM_GRAPH_SAMPLES + 2)
+//a stream that fell further behind the clock skips ahead instead of catching up
+#define STREAM_MAX_BACKLOG_HOPS 4
+
+//one monitored feed: decoder, analysis engine and the graphs of its grid cell
+//a cell only touches its own graphs and its own range of the shared buffers, so cells can run on any thread
+class StreamCell{
+    private:
+        ma_decoder m_Decoder;
+        bool m_Open;
+        bool m_Ended;
+        //the cell keeps its own theme, the shader colors its bars from it whatever the frame theme is
+        const ColorThemes::Theme* m_Theme;
+        AnalysisEngine m_Engine;
+        std::vector<float> m_HopSamples;
+
+        unsigned int m_FirstQuad;
+        float m_Scale;
+        SampleLine m_Background;
+        BarGraph m_AmpGraph;
+        BarGraph m_FreqGraph;
+        SampleLine m_LeftMeter;
+        SampleLine m_RightMeter;
+
+    public:
+        //the cell shows the full window layout scaled by scale with its lower left corner at (x, y)
+        StreamCell(unsigned int firstQuad, float x, float y, float scale, const ColorThemes::Theme* theme)
+            : m_Open(false), m_Ended(false), m_Theme(theme), m_HopSamples(ANALYSIS_HOP_SAMPLES, 0.0f),
+            m_FirstQuad(firstQuad), m_Scale(scale),
+            m_Background(firstQuad, x, y, WINDOW_HEIGHT * scale, WINDOW_WIDTH * scale, 0.0f, 0.0f, 0.0f, 1.0f),
+            m_AmpGraph(NUM_GRAPH_SAMPLES, x + WINDOW_MARGIN * scale, y + WINDOW_HEIGHT/2 * scale, 
+                SAMPLE_WIDTH * scale, (SAMPLE_WIDTH + 2*SAMPLE_MARGIN) * scale),
+            m_FreqGraph(NUM_GRAPH_SAMPLES, x + WINDOW_MARGIN * scale, y + WINDOW_HEIGHT/2 * scale, 
+                SAMPLE_WIDTH * scale, (SAMPLE_WIDTH + 2*SAMPLE_MARGIN) * scale),
+            m_LeftMeter(firstQuad + 1 + 2*NUM_GRAPH_SAMPLES, x + (DECIBEL_METER_XPOS + 5) * scale, 
+                y + (DECIBEL_METER_YPOS + 35) * scale, 20 * scale, DECIBEL_METER_MAX_LENGTH * scale, 0.85f, 0.85f, 0.85f, 0.7f),
+            m_RightMeter(firstQuad + 2 + 2*NUM_GRAPH_SAMPLES, x + (DECIBEL_METER_XPOS + 5) * scale, 
+                y + (DECIBEL_METER_YPOS + 5) * scale, 20 * scale, DECIBEL_METER_MAX_LENGTH * scale, 0.85f, 0.85f, 0.85f, 0.7f){
+            AuxComputations::RGBAColor bg = m_Theme->getBG();
+            m_Background.changeColor(bg.r, bg.g, bg.b, bg.a);
+            m_AmpGraph.setHeightScale(scale);
+            m_FreqGraph.setHeightScale(scale);
+            for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
+                m_AmpGraph.setBar(i, 2.0f, 2.0f);
+                m_AmpGraph.setPaletteColor(i, PALETTE_SECONDARY, i, m_Theme->getIndex());
+                m_FreqGraph.setBar(i, 2.0f, 2.0f);
+                m_FreqGraph.setPaletteColor(i, PALETTE_PRIMARY, i, m_Theme->getIndex());
+            }
+            m_Engine.reset(m_FreqGraph.getLeftHeights(), m_FreqGraph.getRightHeights());
+        }
+
+        ~StreamCell(){
+            if(m_Open) ma_decoder_uninit(&m_Decoder);
+        }
+
+        bool open(const std::string& path){
+            m_Open = createDecoder(m_Decoder, path.c_str()) == 0;
+            m_Ended = !m_Open;
+            return m_Open;
+        }
+
+        void fillIndices(unsigned int* indices){
+            unsigned int quad = m_FirstQuad;
+            m_Background.fillIndices(indices, NUM_INDEX_POINTS * quad++);
+            m_AmpGraph.fillIndices(indices, NUM_INDEX_POINTS * quad, quad);
+            quad += NUM_GRAPH_SAMPLES;
+            m_FreqGraph.fillIndices(indices, NUM_INDEX_POINTS * quad, quad);
+            quad += NUM_GRAPH_SAMPLES;
+            m_LeftMeter.fillIndices(indices, NUM_INDEX_POINTS * quad++);
+            m_RightMeter.fillIndices(indices, NUM_INDEX_POINTS * quad++);
+        }
+
+        //decodes and analyzes hops (in order), skipped hops are decoded past without analysis
+        void advance(size_t hops, size_t skippedHops){
+            TRACE_SCOPE("stream hops");
+            if(m_Ended) return;
+            if(skippedHops > 0){
+                ma_uint64 cursor = 0;
+                ma_decoder_get_cursor_in_pcm_frames(&m_Decoder, &cursor);
+                ma_decoder_seek_to_pcm_frame(&m_Decoder, cursor + skippedHops * ANALYSIS_HOP_SAMPLES / 2);
+            }
+            for(size_t hop = 0; hop < hops; hop++){
+                ma_uint64 framesRead = 0;
+                {
+                    PROFILE_SCOPE(PROFILE_DECODE);
+                    ma_decoder_read_pcm_frames(&m_Decoder, m_HopSamples.data(), ANALYSIS_HOP_SAMPLES / 2, &framesRead);
+                }
+                if(framesRead < ANALYSIS_HOP_SAMPLES / 2){
+                    m_Ended = true;
+                    return;
+                }
+                const FrameResult& frame = m_Engine.process(m_HopSamples.data(), ANALYSIS_HOP_SAMPLES / 2);
+                shiftGraphLeft(m_AmpGraph, frame.leftLevel, frame.rightLevel);
+                m_FreqGraph.setHeights(frame.leftFreqHeights, frame.rightFreqHeights);
+                setMeterLevel(m_LeftMeter, frame.leftMeter, DECIBEL_METER_MAX_LENGTH * m_Scale);
+                setMeterLevel(m_RightMeter, frame.rightMeter, DECIBEL_METER_MAX_LENGTH * m_Scale);
+            }
+        }
+
+        //writes the cell's vertices into its range of the shared vertex buffer
+        void upload(Vertex* vertices, float alpha){
+            PROFILE_SCOPE(PROFILE_VERTEX_FILL);
+            unsigned int quad = m_FirstQuad;
+            m_Background.fillVertices(vertices, NUM_VERTICES_PER_SAMPLE * quad++);
+            m_AmpGraph.upload(vertices, NUM_VERTICES_PER_SAMPLE * quad);
+            quad += NUM_GRAPH_SAMPLES;
+            m_FreqGraph.upload(vertices, NUM_VERTICES_PER_SAMPLE * quad, alpha);
+            quad += NUM_GRAPH_SAMPLES;
+            m_LeftMeter.fillVertices(vertices, NUM_VERTICES_PER_SAMPLE * quad++);
+            m_RightMeter.fillVertices(vertices, NUM_VERTICES_PER_SAMPLE * quad++);
+        }
+
+};
+
+//what every stream task of one frame needs
+typedef struct{
+    std::vector<std::unique_ptr<StreamCell>>* cells;
+    Vertex* vertices;
+    size_t hopsDue;
+    size_t hopsSkipped;
+    float alpha;
+} StreamFrame;
+
+static void RunStreamFrame(void* context, size_t index){
+    StreamFrame* frame = (StreamFrame*) context;
+    StreamCell* cell = (*frame->cells)[index].get();
+    cell->advance(frame->hopsDue, frame->hopsSkipped);
+    cell->upload(frame->vertices, frame->alpha);
+}
+
+int RunMultiStream(const MultiStreamOptions& options){
+    TRACE_THREAD_NAME("render loop");
+    const size_t numStreams = options.inputPaths.size();
+    if(numStreams == 0){
+        std::cout << "No streams given" << std::endl;
+        return -1;
+    }
+
+    if(!glfwInit()) return -1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    #ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    #endif
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    #if GL_CHECK_ERRORS
+    //debug builds report GL errors through the debug output callback instead of glGetError round-trips
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+    #endif
+    GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Audio Visualizer (multi-stream)", nullptr, nullptr);
+    if(!window){
+        std::cout << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+    if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)){
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    #if GL_CHECK_ERRORS
+    //synchronous: a message arrives inside the failing call, so it names the right GLCall
+    if(!EnableGLDebugOutput((GLADloadproc)glfwGetProcAddress, true)){
+        std::cerr << "GL debug output unavailable, GLCall falls back to glGetError" << std::endl;
+    }
+    #endif
+    //a new context starts with default state, whatever the cache remembers belongs to an older one
+    GLStateCache::Get().invalidate();
+    GLStateCache::Get().setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::Get().setBlend(true);
+    ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress);
+
+    //as square a grid as possible, cells keep the aspect ratio of the full window
+    const unsigned int cols = (unsigned int)ceil(sqrt((double)numStreams));
+    const unsigned int rows = (unsigned int)((numStreams + cols - 1) / cols);
+    const float scale = std::min(1.0f / cols, 1.0f / rows);
+    const float cellWidth = WINDOW_WIDTH / cols;
+    const float cellHeight = WINDOW_HEIGHT / rows;
+
+    {
+        //fftw planning is not thread-safe, so every engine is created here
+        std::vector<ColorThemes::Theme> themeTable;
+        ColorThemes::InitializeThemes(themeTable);
+        const size_t firstTheme = (size_t)ColorThemes::ResolveTheme(themeTable, options.themeIndex);
+        std::vector<std::unique_ptr<StreamCell>> cells;
+        size_t numOpened = 0;
+        for(size_t i = 0; i < numStreams; i++){
+            const unsigned int col = (unsigned int)(i % cols);
+            const unsigned int row = (unsigned int)(i / cols);
+            //first stream top left
+            const float x = col * cellWidth + (cellWidth - WINDOW_WIDTH * scale) / 2;
+            const float y = (rows - 1 - row) * cellHeight + (cellHeight - WINDOW_HEIGHT * scale) / 2;
+            const ColorThemes::Theme* theme = &themeTable[(firstTheme + i) % themeTable.size()];
+            cells.push_back(std::unique_ptr<StreamCell>(new StreamCell((unsigned int)i * STREAM_CELL_QUADS, x, y, scale, theme)));
+            if(cells.back()->open(options.inputPaths[i])){
+                numOpened++;
+                std::cout << "Stream " << i << " (row " << row << ", column " << col << "): " << options.inputPaths[i] << std::endl;
+            }
+            else{
+                std::cout << "Failed to open audio file: " << options.inputPaths[i] << std::endl;
+            }
+        }
+
+        if(numOpened == 0){
+            glfwDestroyWindow(window);
+            glfwTerminate();
+            return -1;
+        }
+
+        //every cell in one buffer: one upload and one draw call per frame for all streams
+        MappedDrawObj grid(nullptr, nullptr, NUM_VERTICES_PER_SAMPLE * STREAM_CELL_QUADS * numStreams, 
+            NUM_INDEX_POINTS * STREAM_CELL_QUADS * numStreams, Visualizer::CreateVertexLayout());
+        for(size_t i = 0; i < numStreams; i++){
+            cells[i]->fillIndices(grid.mappedIndices);
+            cells[i]->upload(grid.mappedVertices, 1.0f);
+        }
+
+        Shader shader("./res/shaders/shader.glsl");
+        std::vector<unsigned char> paletteTexels;
+        ColorThemes::PackPalettes(themeTable, paletteTexels);
+        Texture paletteTexture(PALETTE_PERIOD, 2 * (int)themeTable.size(), paletteTexels.data());
+        Renderer renderer;
+        //cells have their own themes and levels, the shared constants only carry the mvp and the time
+        FrameConstants frameConstants;
+        //cells are placed in the vertices, the design maps 1:1 to the (fixed size) window
+        Layout().fillFrameConstants(frameConstants);
+        frameConstants.theme = glm::vec4(0.0f);
+        frameConstants.levels = glm::vec4(0.0f);
+        frameConstants.backgroundColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        frameConstants.textColor = glm::vec4(0.0f);
+        frameConstants.buttonColor = glm::vec4(0.0f);
+        frameConstants.playButtonColor = glm::vec4(0.0f);
+        UniformBuffer frameConstantsBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+        unsigned long long frameNumber = 0;
+        double previousFrameTime = 0.0;
+        ThreadPool pool(options.threads, options.pinThreads);
+        std::cout << "Analyzing " << numStreams << " streams on " << pool.getNumThreads() << " threads" << std::endl;
+
+        const double startTime = glfwGetTime();
+        size_t hopsDone = 0;
+        while(!glfwWindowShouldClose(window)){
+            TRACE_SCOPE("frame");
+            FrameArena::Get().reset();
+            Profiler::Get().beginFrame();
+            GLStateCache::Get().beginFrame();
+            const double frameTime = glfwGetTime() - startTime;
+            const double clock = frameTime * ANALYSIS_RATE;
+            const size_t hopsTarget = (size_t)clock;
+            size_t hopsDue = hopsTarget - hopsDone;
+            size_t hopsSkipped = 0;
+            if(hopsDue > STREAM_MAX_BACKLOG_HOPS){
+                hopsSkipped = hopsDue - STREAM_MAX_BACKLOG_HOPS;
+                hopsDue = STREAM_MAX_BACKLOG_HOPS;
+            }
+            hopsDone = hopsTarget;
+            //part of the next hop that has already elapsed, interpolates the frequency bars
+            const float alpha = (float)(clock - hopsTarget);
+
+            //one task per stream covering its due hops (hops of one stream depend on each other)
+            StreamFrame frame = {&cells, grid.mappedVertices, hopsDue, hopsSkipped, alpha};
+            TaskGroup group;
+            pool.run(group, RunStreamFrame, &frame, numStreams);
+            pool.wait(group);
+
+            renderer.Clear(0.0f, 0.0f, 0.0f, 1.0f);
+            frameConstants.time = glm::vec4(frameTime, frameTime - previousFrameTime, alpha, (float)frameNumber++);
+            previousFrameTime = frameTime;
+            frameConstantsBuffer.Update(&frameConstants, sizeof(frameConstants));
+            shader.Bind();
+            paletteTexture.Bind(PALETTE_TEXTURE_UNIT);
+            renderer.Draw(grid.va, grid.ib, shader);
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
+    }
+    if(Tracer::IsEnabled()) Tracer::Dump();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
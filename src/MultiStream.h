@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+typedef struct{
+    std::vector<std::string> inputPaths;
+    //worker threads for the per-stream analysis, 0 = one per hardware thread
+    unsigned int threads;
+    //binds every worker thread to its own core
+    bool pinThreads;
+    //theme of the first stream (as HeadlessOptions::themeIndex), the others continue through the theme list
+    int themeIndex;
+} MultiStreamOptions;
+
+//monitors several tracks at once: one AnalysisEngine per stream, analyzed in parallel on a thread pool
+//and drawn as a grid of cells in one window (one vertex buffer, one draw call for every stream)
+//streams follow the wall clock instead of an audio device, nothing is played back
+int RunMultiStream(const MultiStreamOptions& options);
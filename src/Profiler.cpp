@@ -0,0 +1,143 @@
+#include "Profiler.h"
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+static const char* s_StageNames[PROFILE_NUM_STAGES] = {
+    "Decode", "Ring drain", "Peak", "FFT", "Freq values", "Vertex fill", "Draw calls", "Frame"
+};
+
+static const char* s_GpuStageNames[PROFILE_GPU_NUM_STAGES] = {
+    "GPU visualizer", "GPU UI"
+};
+
+//the overlay asks for percentiles every frame, the partially sorted copy lives in the frame arena
+static float percentileOf(const std::vector<float>& values, size_t count, float p){
+    if(count == 0) return 0.0f;
+    float* sorted = FrameArena::Get().allocate<float>(count);
+    std::copy(values.begin(), values.begin() + count, sorted);
+    size_t index = (size_t)(p * (count - 1) + 0.5f);
+    std::nth_element(sorted, sorted + index, sorted + count);
+    return sorted[index];
+}
+
+Profiler::Profiler()
+    : m_GpuReady(false), m_Origin(std::chrono::steady_clock::now()), m_FrameStart(m_Origin), m_Frames(0){
+    for(int i = 0; i < PROFILE_NUM_STAGES; i++){
+        m_Current[i] = 0;
+        m_Cpu[i] = {std::vector<float>(PROFILER_HISTORY_FRAMES, 0.0f), 0, 0};
+    }
+    for(int i = 0; i < PROFILE_GPU_NUM_STAGES; i++){
+        m_Gpu[i] = {std::vector<float>(PROFILER_HISTORY_FRAMES, 0.0f), 0, 0};
+        for(int q = 0; q < PROFILER_GPU_QUERIES; q++){
+            m_GpuTimers[i].queries[q] = 0;
+            m_GpuTimers[i].pending[q] = false;
+        }
+        m_GpuTimers[i].next = 0;
+        m_GpuTimers[i].active = -1;
+    }
+    m_FrameStartTimes.resize(PROFILER_HISTORY_FRAMES, 0.0);
+}
+
+Profiler& Profiler::Get(){
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::push(History& history, float value){
+    history.values[history.head] = value;
+    history.head = (history.head + 1) % history.values.size();
+    if(history.count < history.values.size()) history.count++;
+}
+
+void Profiler::addSample(ProfileStage stage, long long nanoseconds){
+    m_Current[stage].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void Profiler::beginFrame(){
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(m_Frames > 0){
+        addSample(PROFILE_FRAME, std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_FrameStart).count());
+        m_FrameStartTimes[m_Cpu[0].head] = std::chrono::duration<double, std::micro>(m_FrameStart - m_Origin).count();
+        for(int i = 0; i < PROFILE_NUM_STAGES; i++){
+            push(m_Cpu[i], m_Current[i].exchange(0) / 1e6f);
+        }
+    }
+    else{
+        for(int i = 0; i < PROFILE_NUM_STAGES; i++) m_Current[i] = 0;
+    }
+    m_FrameStart = now;
+    m_Frames++;
+}
+
+float Profiler::getPercentile(ProfileStage stage, float p) const{
+    return percentileOf(m_Cpu[stage].values, m_Cpu[stage].count, p);
+}
+
+float Profiler::getGpuPercentile(ProfileGpuStage stage, float p) const{
+    return percentileOf(m_Gpu[stage].values, m_Gpu[stage].count, p);
+}
+
+const char* Profiler::GetStageName(ProfileStage stage){
+    return s_StageNames[stage];
+}
+
+const char* Profiler::GetGpuStageName(ProfileGpuStage stage){
+    return s_GpuStageNames[stage];
+}
+
+bool Profiler::exportJSON(const std::string& path) const{
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == NULL){
+        std::cerr << "Failed to write profile to " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "{\n  \"frames\": %llu,\n  \"stages\": {\n", m_Frames);
+    for(int i = 0; i < PROFILE_NUM_STAGES + PROFILE_GPU_NUM_STAGES; i++){
+        const bool gpu = i >= PROFILE_NUM_STAGES;
+        const History& history = gpu ? m_Gpu[i - PROFILE_NUM_STAGES] : m_Cpu[i];
+        const char* name = gpu ? s_GpuStageNames[i - PROFILE_NUM_STAGES] : s_StageNames[i];
+        double sum = 0.0;
+        float maxValue = 0.0f;
+        for(size_t f = 0; f < history.count; f++){
+            sum += history.values[f];
+            maxValue = std::max(maxValue, history.values[f]);
+        }
+        fprintf(file, "    \"%s\": {\"samples\": %zu, \"p50_ms\": %.4f, \"p99_ms\": %.4f, \"mean_ms\": %.4f, \"max_ms\": %.4f}%s\n", 
+            name, history.count, percentileOf(history.values, history.count, 0.5f), 
+            percentileOf(history.values, history.count, 0.99f), history.count > 0 ? sum / history.count : 0.0, 
+            maxValue, i + 1 < PROFILE_NUM_STAGES + PROFILE_GPU_NUM_STAGES ? "," : "");
+    }
+    fprintf(file, "  }\n}\n");
+    fclose(file);
+    std::cerr << "Profile written to " << path << std::endl;
+    return true;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) const{
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == NULL){
+        std::cerr << "Failed to write trace to " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    //cpu histories and frame starts advance together, so an index is the same frame in all of them
+    const History& frames = m_Cpu[0];
+    for(size_t f = 0; f < frames.count; f++){
+        const size_t index = (frames.head + frames.values.size() - frames.count + f) % frames.values.size();
+        fprintf(file, "%s{\"name\":\"stages\",\"ph\":\"C\",\"ts\":%.1f,\"pid\":1,\"tid\":1,\"args\":{", 
+            first ? "" : ",\n", m_FrameStartTimes[index]);
+        for(int i = 0; i < PROFILE_NUM_STAGES; i++){
+            fprintf(file, "%s\"%s\":%.4f", i == 0 ? "" : ",", s_StageNames[i], m_Cpu[i].values[index]);
+        }
+        fprintf(file, "}}");
+        first = false;
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    std::cerr << "Trace written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+//frames kept for percentiles, histograms and export
+#define PROFILER_HISTORY_FRAMES 240
+//GL_TIME_ELAPSED queries per GPU stage, results are read a few frames late
+#define PROFILER_GPU_QUERIES 4
+
+//CPU stages, a stage may be timed several times per frame (and from several threads), the frame sums them
+typedef enum{
+    PROFILE_DECODE = 0,
+    PROFILE_RING_DRAIN,
+    PROFILE_PEAK,
+    PROFILE_FFT,
+    PROFILE_FREQ_VALUES,
+    PROFILE_VERTEX_FILL,
+    PROFILE_DRAW,
+    PROFILE_FRAME,
+    PROFILE_NUM_STAGES
+} ProfileStage;
+
+typedef enum{
+    PROFILE_GPU_VISUALIZER = 0,
+    PROFILE_GPU_UI,
+    PROFILE_GPU_NUM_STAGES
+} ProfileGpuStage;
+
+//per-stage timings of the last PROFILER_HISTORY_FRAMES frames
+class Profiler{
+    private:
+        typedef struct{
+            std::vector<float> values;
+            size_t head;
+            size_t count;
+        } History;
+
+        typedef struct{
+            unsigned int queries[PROFILER_GPU_QUERIES];
+            bool pending[PROFILER_GPU_QUERIES];
+            size_t next;
+            //query currently between begin and end, -1 if none
+            int active;
+        } GpuTimer;
+
+        //nanoseconds accumulated during the current frame
+        std::atomic<long long> m_Current[PROFILE_NUM_STAGES];
+        History m_Cpu[PROFILE_NUM_STAGES];
+        History m_Gpu[PROFILE_GPU_NUM_STAGES];
+        GpuTimer m_GpuTimers[PROFILE_GPU_NUM_STAGES];
+        bool m_GpuReady;
+        //frame starts in microseconds since the profiler was created (chrome trace timestamps),
+        //advances together with the cpu histories
+        std::vector<double> m_FrameStartTimes;
+        std::chrono::steady_clock::time_point m_Origin;
+        std::chrono::steady_clock::time_point m_FrameStart;
+        unsigned long long m_Frames;
+
+        Profiler();
+        static void push(History& history, float value);
+        //reads the finished queries of a stage, before the stage issues a new one
+        void collectGpuResults(ProfileGpuStage stage);
+
+    public:
+        static Profiler& Get();
+
+        //thread-safe, adds a duration to the current frame of a stage
+        void addSample(ProfileStage stage, long long nanoseconds);
+        //closes the current frame (including PROFILE_FRAME) and starts the next one, main thread only
+        void beginFrame();
+
+        //GPU timers need a current context, without initGpu() the gpu calls do nothing
+        void initGpu();
+        void destroyGpu();
+        void beginGpu(ProfileGpuStage stage);
+        void endGpu(ProfileGpuStage stage);
+
+        //milliseconds, p in [0, 1]
+        float getPercentile(ProfileStage stage, float p) const;
+        float getGpuPercentile(ProfileGpuStage stage, float p) const;
+        static const char* GetStageName(ProfileStage stage);
+        static const char* GetGpuStageName(ProfileGpuStage stage);
+
+        //ImGui window with a histogram and p50/p99 per stage
+        void drawOverlay();
+        //summary per stage (p50, p99, mean, max in ms)
+        bool exportJSON(const std::string& path) const;
+        //per-frame counter events, loads in chrome://tracing or Perfetto
+        bool exportChromeTrace(const std::string& path) const;
+};
+
+//times the enclosing block into a CPU stage
+class ProfileScope{
+    private:
+        ProfileStage m_Stage;
+        std::chrono::steady_clock::time_point m_Start;
+    public:
+        ProfileScope(ProfileStage stage)
+            : m_Stage(stage), m_Start(std::chrono::steady_clock::now()) {}
+        ~ProfileScope(){
+            Profiler::Get().addSample(m_Stage, 
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Start).count());
+        }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(stage) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
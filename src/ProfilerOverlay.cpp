@@ -0,0 +1,96 @@
+#include "Profiler.h"
+#include "ErrorHandler.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+
+#include "vendor/imgui/imgui.h"
+
+//parts of the profiler that need a GL context (timer queries) or ImGui, kept out of Profiler.cpp
+//so the analysis library can be profiled without linking any graphics code
+
+void Profiler::initGpu(){
+    if(m_GpuReady) return;
+    for(int i = 0; i < PROFILE_GPU_NUM_STAGES; i++){
+        GLCall(glGenQueries(PROFILER_GPU_QUERIES, m_GpuTimers[i].queries));
+    }
+    m_GpuReady = true;
+}
+
+void Profiler::destroyGpu(){
+    if(!m_GpuReady) return;
+    for(int i = 0; i < PROFILE_GPU_NUM_STAGES; i++){
+        GLCall(glDeleteQueries(PROFILER_GPU_QUERIES, m_GpuTimers[i].queries));
+        for(int q = 0; q < PROFILER_GPU_QUERIES; q++) m_GpuTimers[i].pending[q] = false;
+        m_GpuTimers[i].active = -1;
+    }
+    m_GpuReady = false;
+}
+
+void Profiler::beginGpu(ProfileGpuStage stage){
+    if(!m_GpuReady) return;
+    collectGpuResults(stage);
+    GpuTimer& timer = m_GpuTimers[stage];
+    //every query still waiting for the GPU, skip this frame instead of stalling
+    if(timer.pending[timer.next]) return;
+    GLCall(glBeginQuery(GL_TIME_ELAPSED, timer.queries[timer.next]));
+    timer.active = (int)timer.next;
+}
+
+void Profiler::endGpu(ProfileGpuStage stage){
+    if(!m_GpuReady) return;
+    GpuTimer& timer = m_GpuTimers[stage];
+    if(timer.active < 0) return;
+    GLCall(glEndQuery(GL_TIME_ELAPSED));
+    timer.pending[timer.active] = true;
+    timer.next = (timer.next + 1) % PROFILER_GPU_QUERIES;
+    timer.active = -1;
+}
+
+void Profiler::collectGpuResults(ProfileGpuStage stage){
+    GpuTimer& timer = m_GpuTimers[stage];
+    //oldest first so the history stays in frame order
+    for(int q = 0; q < PROFILER_GPU_QUERIES; q++){
+        const size_t index = (timer.next + q) % PROFILER_GPU_QUERIES;
+        if(!timer.pending[index]) continue;
+        GLint available = 0;
+        GLCall(glGetQueryObjectiv(timer.queries[index], GL_QUERY_RESULT_AVAILABLE, &available));
+        if(!available) break;
+        GLuint64 elapsed = 0;
+        GLCall(glGetQueryObjectui64v(timer.queries[index], GL_QUERY_RESULT, &elapsed));
+        push(m_Gpu[stage], elapsed / 1e6f);
+        timer.pending[index] = false;
+    }
+}
+
+void Profiler::drawOverlay(){
+    ImGui::SetNextWindowSize(ImVec2(420, 0), ImGuiCond_Once);
+    ImGui::Begin("Profiler");
+    ImGui::Text("%-16s %7s %7s %7s", "stage (ms)", "last", "p50", "p99");
+    for(int i = 0; i < PROFILE_NUM_STAGES + PROFILE_GPU_NUM_STAGES; i++){
+        const bool gpu = i >= PROFILE_NUM_STAGES;
+        const History& history = gpu ? m_Gpu[i - PROFILE_NUM_STAGES] : m_Cpu[i];
+        const char* name = gpu ? GetGpuStageName((ProfileGpuStage)(i - PROFILE_NUM_STAGES)) : GetStageName((ProfileStage)i);
+        const size_t last = (history.head + history.values.size() - 1) % history.values.size();
+        const float p50 = gpu ? getGpuPercentile((ProfileGpuStage)(i - PROFILE_NUM_STAGES), 0.5f) : getPercentile((ProfileStage)i, 0.5f);
+        const float p99 = gpu ? getGpuPercentile((ProfileGpuStage)(i - PROFILE_NUM_STAGES), 0.99f) : getPercentile((ProfileStage)i, 0.99f);
+        ImGui::Text("%-16s %7.3f %7.3f %7.3f", name, history.count > 0 ? history.values[last] : 0.0f, p50, p99);
+        ImGui::SameLine();
+        ImGui::PushID(i);
+        //oldest frame on the left; scaled to the p99 so a single spike does not flatten the rest
+        ImGui::PlotHistogram("##history", history.values.data(), (int)history.count, 
+            history.count < history.values.size() ? 0 : (int)history.head, NULL, 0.0f, std::max(p99, 0.001f), ImVec2(120, 14));
+        ImGui::PopID();
+    }
+    //binds of the previous frame that reached GL vs the ones the state cache skipped
+    const GLStateCache& stateCache = GLStateCache::Get();
+    ImGui::Text("%-16s %7s %7s", "GL state", "issued", "avoided");
+    for(int i = 0; i < GLSTATE_NUM_KINDS; i++){
+        ImGui::Text("%-16s %7llu %7llu", GLStateCache::GetKindName((GLStateKind)i), 
+            stateCache.getLastIssued((GLStateKind)i), stateCache.getLastAvoided((GLStateKind)i));
+    }
+    if(ImGui::Button("Export JSON")) exportJSON("profile.json");
+    ImGui::SameLine();
+    if(ImGui::Button("Export Chrome trace")) exportChromeTrace("profile.trace.json");
+    ImGui::End();
+}
@@ -1,7 +1,9 @@
 #include "Renderer.h"
 #include "ErrorHandler.h"
+#include "Profiler.h"
 
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const{
+    PROFILE_SCOPE(PROFILE_DRAW);
     shader.Bind();
     va.Bind();
     ib.Bind();
@@ -48,7 +48,14 @@ class RingBuffer {
             return ((m_Head + 1) % m_Capacity) == m_Tail.load(std::memory_order_acquire);
         }
 
+        //number of items waiting to be popped (handles the head wrapping around before the tail)
         size_t getSize(){
-            return m_Head - m_Tail.load(std::memory_order_acquire);
+            size_t tail = m_Tail.load(std::memory_order_acquire);
+            return (m_Head + m_Capacity - tail) % m_Capacity;
+        }
+
+        //number of items push() still accepts, one slot always stays empty to tell full from empty
+        size_t getFreeSpace(){
+            return m_Capacity - 1 - getSize();
         }
 };
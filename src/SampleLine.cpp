@@ -1,22 +1,19 @@
 #include "SampleLine.h"
 
 #include <iostream>
+#include <cstring>
 
 SampleLine::SampleLine(unsigned int id, float basex, float basey, float heightLeft, float heightRight, float width, float r, float g, float b, float a){
     m_ID = id;
 
     m_Coords[0] = basex;
     m_Coords[1] = basey - heightRight;
-    m_Coords[2] = 1.0f;
-    m_Coords[3] = basex + width;
-    m_Coords[4] = basey - heightRight;
-    m_Coords[5] = 1.0f;
-    m_Coords[6] = basex + width;
+    m_Coords[2] = basex + width;
+    m_Coords[3] = basey - heightRight;
+    m_Coords[4] = basex + width;
+    m_Coords[5] = basey + heightLeft;
+    m_Coords[6] = basex;
     m_Coords[7] = basey + heightLeft;
-    m_Coords[8] = 1.0f;
-    m_Coords[9] = basex;
-    m_Coords[10] = basey + heightLeft;
-    m_Coords[11] = 1.0f;
 
     m_Colors[0] = r;
     m_Colors[1] = g;
@@ -36,16 +33,12 @@ SampleLine::SampleLine(unsigned int id, float basex, float basey, float height,
 
     m_Coords[0] = basex;
     m_Coords[1] = basey;
-    m_Coords[2] = 1.0f;
-    m_Coords[3] = basex + width;
-    m_Coords[4] = basey;
-    m_Coords[5] = 1.0f;
-    m_Coords[6] = basex + width;
+    m_Coords[2] = basex + width;
+    m_Coords[3] = basey;
+    m_Coords[4] = basex + width;
+    m_Coords[5] = basey + height;
+    m_Coords[6] = basex;
     m_Coords[7] = basey + height;
-    m_Coords[8] = 1.0f;
-    m_Coords[9] = basex;
-    m_Coords[10] = basey + height;
-    m_Coords[11] = 1.0f;
 
     m_Colors[0] = r;
     m_Colors[1] = g;
@@ -71,14 +64,18 @@ void SampleLine::changeColor(float r, float g, float b, float a){
     m_Colors[3] = a;
 }
 
-const void SampleLine::fillVertices(float* target, int offset){
-    const float vertices[28] = {
-        m_Coords[0], m_Coords[1], m_Coords[2], m_Colors[0], m_Colors[1], m_Colors[2], m_Colors[3],
-        m_Coords[3], m_Coords[4], m_Coords[5], m_Colors[0], m_Colors[1], m_Colors[2], m_Colors[3],
-        m_Coords[6], m_Coords[7], m_Coords[8], m_Colors[0], m_Colors[1], m_Colors[2], m_Colors[3],
-        m_Coords[9], m_Coords[10], m_Coords[11], m_Colors[0], m_Colors[1], m_Colors[2], m_Colors[3]
+const void SampleLine::fillVertices(Vertex* target, int offset){
+    const unsigned char r = PackColorChannel(m_Colors[0]);
+    const unsigned char g = PackColorChannel(m_Colors[1]);
+    const unsigned char b = PackColorChannel(m_Colors[2]);
+    const unsigned char a = PackColorChannel(m_Colors[3]);
+    const Vertex vertices[4] = {
+        {m_Coords[0], m_Coords[1], r, g, b, a},
+        {m_Coords[2], m_Coords[3], r, g, b, a},
+        {m_Coords[4], m_Coords[5], r, g, b, a},
+        {m_Coords[6], m_Coords[7], r, g, b, a}
     };
-    std::memcpy(target + offset, vertices, 28 * sizeof(float));
+    std::memcpy(target + offset, vertices, 4 * sizeof(Vertex));
 }
 
 const void SampleLine::fillIndices(unsigned int* target, int offset){
@@ -101,27 +98,27 @@ void SampleLine::changeID(unsigned int id){
 void SampleLine::changeXPos(float newBaseX){
     const float width = getWidth();
     m_Coords[0] = newBaseX;
-    m_Coords[3] = newBaseX + width;
-    m_Coords[6] = newBaseX + width;
-    m_Coords[9] = newBaseX;
+    m_Coords[2] = newBaseX + width;
+    m_Coords[4] = newBaseX + width;
+    m_Coords[6] = newBaseX;
 }
 
 void SampleLine::changeYPos(float newBaseY){
     const float height = getHeight();
     m_Coords[1] = newBaseY;
-    m_Coords[4] = newBaseY;
+    m_Coords[3] = newBaseY;
+    m_Coords[5] = newBaseY + height;
     m_Coords[7] = newBaseY + height;
-    m_Coords[10] = newBaseY + height;
 }
 
 void SampleLine::changeWidth(float newWidth){
-    m_Coords[3] = m_Coords[0] + newWidth;
-    m_Coords[6] = m_Coords[0] + newWidth;
+    m_Coords[2] = m_Coords[0] + newWidth;
+    m_Coords[4] = m_Coords[0] + newWidth;
 }
 
 void SampleLine::changeHeight(float newHeight){
+    m_Coords[5] = m_Coords[1] + newHeight;
     m_Coords[7] = m_Coords[1] + newHeight;
-    m_Coords[10] = m_Coords[1] + newHeight;
 }
 
 void SampleLine::changeColors(float newR, float newG, float newB, float newA){
@@ -2,23 +2,18 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "vendor/glm/glm.hpp"
 
-struct ShaderProgramSource{
-    std::string VertexSource;
-    std::string FragmentSource;
-};
-
-enum ShaderType{
-    NONE = -1, VERTEX = 0, FRAGMENT = 1
-};
-
+//program built from one res/shaders file through the ShaderManager
 class Shader{
     private:
         std::string m_Filepath;
         unsigned int m_RendererID;
-        //caching for uniforms
-        std::unordered_map<std::string, int> m_UniformLocationCache;
+        //uniform handles index these, a handle stays valid when the program is rebuilt
+        std::vector<std::string> m_UniformNames;
+        std::vector<int> m_UniformLocations;
+        std::unordered_map<std::string, int> m_UniformHandles;
     public:
         Shader(const std::string& filepath);
         ~Shader();
@@ -26,13 +21,22 @@ class Shader{
         void Bind() const;
         void Unbind() const;
 
+        //integer handle of a uniform, resolve once and pass it to the setters every frame
+        int GetUniformHandle(const std::string& name);
+
         //set uniforms
+        void SetUniform1i(int handle, int value);
+        void SetUniform4f(int handle, float v0, float v1, float v2, float v3);
+        void SetUniformMat4f(int handle, const glm::mat4& matrix);
+        //by name, looks the handle up first
         void SetUniform1i(const std::string& name, int value);
         void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
         void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+
+        //rebuilds the program from the file, keeps the current one if it does not build
+        //uniform values are reset with the program, set them again before the next draw
+        bool Reload();
+        inline const std::string& GetFilepath() const { return m_Filepath; }
     private:
         int GetUniformLocation(const std::string& name);
-        unsigned int CompileShader(unsigned int type, const std::string& source);
-        int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
-        struct ShaderProgramSource ParseShader(const std::string& filepath);
-};
\ No newline at end of file
+};
@@ -0,0 +1,390 @@
+#include "ShaderManager.h"
+#include "Shader.h"
+#include "ErrorHandler.h"
+#include "FrameConstants.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifdef _WIN32
+    #include <direct.h>
+#else
+    #include <sys/stat.h>
+#endif
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+//GL_ARB_get_program_binary / GL 4.1 tokens, the loader only covers GL 3.3 core
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+
+//bump when the layout of a cache file changes, older files then miss
+#define SHADER_CACHE_VERSION 1
+#define FNV_OFFSET_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+//header of a cache file, followed by length bytes of program binary
+typedef struct{
+    char magic[4];
+    unsigned int version;
+    unsigned long long key;
+    unsigned int format;
+    unsigned int length;
+} ShaderCacheHeader;
+
+static const char s_CacheMagic[4] = {'A', 'V', 'S', 'B'};
+
+static unsigned long long hashBytes(const std::string& bytes, unsigned long long hash){
+    for(size_t i = 0; i < bytes.size(); i++){
+        hash ^= (unsigned char)bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static std::string glString(GLenum name){
+    const char* value = (const char*)glGetString(name);
+    return value ? value : "";
+}
+
+#ifdef __linux__
+static std::string directoryOf(const std::string& filepath){
+    size_t slash = filepath.find_last_of("/\\");
+    return slash == std::string::npos ? "." : filepath.substr(0, slash);
+}
+#endif
+
+static std::string fileNameOf(const std::string& filepath){
+    size_t slash = filepath.find_last_of("/\\");
+    return slash == std::string::npos ? filepath : filepath.substr(slash + 1);
+}
+
+//creates every missing directory of path, true if it exists afterwards
+static bool createDirectories(const std::string& path){
+    for(size_t end = 0; end != std::string::npos;){
+        end = path.find_first_of("/\\", end + 1);
+        std::string prefix = path.substr(0, end);
+        if(prefix.empty() || prefix == ".") continue;
+        #ifdef _WIN32
+        int result = _mkdir(prefix.c_str());
+        #else
+        int result = mkdir(prefix.c_str(), 0755);
+        #endif
+        if(result != 0 && errno != EEXIST) return false;
+    }
+    return true;
+}
+
+//splits a "#shader vertex / #shader fragment" file into its stages
+static ShaderProgramSource parseShader(const std::string& text){
+    std::string sources[2];
+    ShaderType type = NONE;
+    for(size_t start = 0; start < text.size();){
+        size_t end = text.find('\n', start);
+        if(end == std::string::npos) end = text.size();
+        const std::string line = text.substr(start, end - start);
+        if(line.find("#shader") != std::string::npos){
+            if(line.find("vertex") != std::string::npos){
+                type = VERTEX;
+            }else if(line.find("fragment") != std::string::npos){
+                type = FRAGMENT;
+            }
+        }
+        else if(type != NONE){
+            sources[(int)type].append(line).append(1, '\n');
+        }
+        start = end + 1;
+    }
+    ShaderProgramSource returnVal = { sources[0], sources[1] };
+    return returnVal;
+}
+
+static unsigned int compileShader(unsigned int type, const std::string& source){
+    GLCall(unsigned int id = glCreateShader(type));
+    const char* src = source.c_str(); //equivalent to &source[0];
+    //set source code for shader, nullptr means that it assumes the string is null-terminated,
+    //go through the whole length of the string
+    GLCall(glShaderSource(id, 1, &src, nullptr));
+    GLCall(glCompileShader(id));
+
+    int result;
+    GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+    //shader couldn't compile, return error message and return 0
+    if(result == GL_FALSE){
+        int length;
+        GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(length + 1, '\0');
+        GLCall(glGetShaderInfoLog(id, length, &length, message.data()));
+        std::cerr << "Failed to compile " <<
+            (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader" << std::endl;
+        std::cerr << message.data() << std::endl;
+        GLCall(glDeleteShader(id));
+        return 0;
+    }
+    return id;
+}
+
+//retrievableHint: program parameter entry point if the binary will be read back, nullptr otherwise
+static unsigned int createProgram(const ShaderProgramSource& source, void (APIENTRYP retrievableHint)(GLuint, GLenum, GLint)){
+    unsigned int vs = compileShader(GL_VERTEX_SHADER, source.VertexSource);
+    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, source.FragmentSource);
+    if(vs == 0 || fs == 0){
+        if(vs != 0){
+            GLCall(glDeleteShader(vs));
+        }
+        if(fs != 0){
+            GLCall(glDeleteShader(fs));
+        }
+        return 0;
+    }
+    GLCall(unsigned int program = glCreateProgram());
+    //attach shaders to program
+    GLCall(glAttachShader(program, vs));
+    GLCall(glAttachShader(program, fs));
+    if(retrievableHint){
+        GLCall(retrievableHint(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+    GLCall(glLinkProgram(program));
+    //remove intermediate shader objects
+    GLCall(glDeleteShader(vs));
+    GLCall(glDeleteShader(fs));
+
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if(linked == GL_FALSE){
+        int length;
+        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        std::vector<char> message(length + 1, '\0');
+        GLCall(glGetProgramInfoLog(program, length, &length, message.data()));
+        std::cerr << "Failed to link shader program" << std::endl;
+        std::cerr << message.data() << std::endl;
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+    GLCall(glValidateProgram(program));
+    //return program id
+    return program;
+}
+
+//attaches the per-frame constants block of a program (if it has one) to the shared binding point
+//block bindings are reset by every link and by glProgramBinary, so this runs for each loaded program
+static void bindFrameConstants(unsigned int program){
+    GLCall(unsigned int block = glGetUniformBlockIndex(program, FRAME_CONSTANTS_BLOCK));
+    if(block != GL_INVALID_INDEX){
+        GLCall(glUniformBlockBinding(program, block, FRAME_CONSTANTS_BINDING));
+    }
+}
+
+//the file name keeps the cache readable, the hash of the whole path separates equally named shaders of different directories
+static std::string cachePath(const std::string& directory, const std::string& filepath){
+    char pathHash[17];
+    std::snprintf(pathHash, sizeof(pathHash), "%016llx", hashBytes(filepath, FNV_OFFSET_BASIS));
+    return directory + "/" + fileNameOf(filepath) + "." + pathHash + ".bin";
+}
+
+ShaderManager::ShaderManager()
+    : m_GetProgramBinary(nullptr), m_ProgramBinary(nullptr), m_ProgramParameteri(nullptr), m_Notify(-1)
+{
+}
+
+ShaderManager::~ShaderManager(){
+    #ifdef __linux__
+    if(m_Notify >= 0) close(m_Notify);
+    #endif
+}
+
+ShaderManager& ShaderManager::Get(){
+    static ShaderManager manager;
+    return manager;
+}
+
+void ShaderManager::init(GLADloadproc load, const std::string& cacheDirectory){
+    m_CacheDirectory.clear();
+    m_BinaryFormats.clear();
+    if(cacheDirectory.empty()) return;
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    const bool core = major > 4 || (major == 4 && minor >= 1);
+    if(!core && !HasGLExtension("GL_ARB_get_program_binary")) return;
+    //drivers may expose the entry points but no format (binaries can never be restored)
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if(formats <= 0) return;
+    m_BinaryFormats.resize(formats);
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, m_BinaryFormats.data());
+
+    m_GetProgramBinary = (GetProgramBinaryProc)load("glGetProgramBinary");
+    m_ProgramBinary = (ProgramBinaryProc)load("glProgramBinary");
+    m_ProgramParameteri = (ProgramParameteriProc)load("glProgramParameteri");
+    if(!m_GetProgramBinary || !m_ProgramBinary || !m_ProgramParameteri) return;
+    if(!createDirectories(cacheDirectory)){
+        std::cerr << "Cannot create shader cache directory " << cacheDirectory << ", shaders are compiled every start" << std::endl;
+        return;
+    }
+    m_Driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+    m_CacheDirectory = cacheDirectory;
+}
+
+unsigned int ShaderManager::loadProgram(const std::string& filepath){
+    //read in one go, only a cache miss splits the file into its stages
+    std::ifstream stream(filepath, std::ios::binary);
+    if(!stream){
+        std::cerr << "Failed to open shader " << filepath << std::endl;
+        return 0;
+    }
+    std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    unsigned long long key = 0;
+    if(hasBinaryCache()){
+        key = hashBytes(text, hashBytes(m_Driver, FNV_OFFSET_BASIS));
+        unsigned int program = loadCachedProgram(filepath, key);
+        if(program != 0){
+            bindFrameConstants(program);
+            return program;
+        }
+    }
+    unsigned int program = createProgram(parseShader(text), hasBinaryCache() ? m_ProgramParameteri : nullptr);
+    if(program == 0) return 0;
+    if(hasBinaryCache()) storeCachedProgram(filepath, key, program);
+    bindFrameConstants(program);
+    return program;
+}
+
+unsigned int ShaderManager::loadCachedProgram(const std::string& filepath, unsigned long long key){
+    std::ifstream stream(cachePath(m_CacheDirectory, filepath), std::ios::binary);
+    if(!stream) return 0;
+    ShaderCacheHeader header;
+    if(!stream.read((char*)&header, sizeof(header))) return 0;
+    if(std::memcmp(header.magic, s_CacheMagic, sizeof(s_CacheMagic)) != 0 || header.version != SHADER_CACHE_VERSION ||
+        header.key != key || header.length == 0){
+        return 0;
+    }
+    if(std::find(m_BinaryFormats.begin(), m_BinaryFormats.end(), (GLint)header.format) == m_BinaryFormats.end()) return 0;
+    std::vector<char> binary(header.length);
+    if(!stream.read(binary.data(), header.length)) return 0;
+
+    GLCall(unsigned int program = glCreateProgram());
+    GLCall(m_ProgramBinary(program, header.format, binary.data(), header.length));
+    //drivers may reject their own binaries (e.g. an update that kept the version string), that is a failed link
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if(linked == GL_FALSE){
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+    return program;
+}
+
+void ShaderManager::storeCachedProgram(const std::string& filepath, unsigned long long key, unsigned int program){
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if(length <= 0) return;
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    GLCall(m_GetProgramBinary(program, length, &written, &format, binary.data()));
+    if(written <= 0) return;
+
+    ShaderCacheHeader header;
+    std::memcpy(header.magic, s_CacheMagic, sizeof(s_CacheMagic));
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = (unsigned int)written;
+    //written next to the cache file and renamed, a crash or a second instance never leaves a torn binary
+    const std::string path = cachePath(m_CacheDirectory, filepath);
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        stream.write((const char*)&header, sizeof(header));
+        stream.write(binary.data(), written);
+        if(!stream){
+            std::remove(temporary.c_str());
+            return;
+        }
+    }
+    //rename does not replace an existing file on windows
+    if(std::rename(temporary.c_str(), path.c_str()) != 0){
+        std::remove(path.c_str());
+        if(std::rename(temporary.c_str(), path.c_str()) != 0) std::remove(temporary.c_str());
+    }
+}
+
+void ShaderManager::registerShader(Shader* shader){
+    m_Shaders.push_back(shader);
+    if(m_Notify >= 0) watch(shader->GetFilepath());
+}
+
+void ShaderManager::unregisterShader(Shader* shader){
+    m_Shaders.erase(std::remove(m_Shaders.begin(), m_Shaders.end(), shader), m_Shaders.end());
+}
+
+bool ShaderManager::enableHotReload(){
+    #ifdef __linux__
+    if(m_Notify >= 0) return true;
+    m_Notify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(m_Notify < 0) return false;
+    for(size_t i = 0; i < m_Shaders.size(); i++) watch(m_Shaders[i]->GetFilepath());
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+void ShaderManager::watch(const std::string& filepath){
+    #ifdef __linux__
+    const std::string directory = directoryOf(filepath);
+    for(std::unordered_map<int, std::string>::iterator it = m_Watches.begin(); it != m_Watches.end(); ++it){
+        if(it->second == directory) return;
+    }
+    //editors either rewrite the file (close after write) or save a copy and rename it over the original
+    int watchDescriptor = inotify_add_watch(m_Notify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if(watchDescriptor < 0){
+        std::cerr << "Cannot watch " << directory << " for shader changes" << std::endl;
+        return;
+    }
+    m_Watches[watchDescriptor] = directory;
+    #else
+    (void)filepath;
+    #endif
+}
+
+void ShaderManager::pollReload(){
+    #ifdef __linux__
+    if(m_Notify < 0) return;
+    //one save usually raises several events, each changed file is rebuilt once
+    std::vector<std::string> changed;
+    alignas(struct inotify_event) char buffer[4096];
+    while(true){
+        ssize_t bytes = read(m_Notify, buffer, sizeof(buffer));
+        if(bytes <= 0) break;
+        for(char* event = buffer; event < buffer + bytes;){
+            const struct inotify_event* notification = (const struct inotify_event*)event;
+            std::unordered_map<int, std::string>::iterator directory = m_Watches.find(notification->wd);
+            if(directory != m_Watches.end() && notification->len > 0){
+                const std::string path = directory->second + "/" + notification->name;
+                if(std::find(changed.begin(), changed.end(), path) == changed.end()) changed.push_back(path);
+            }
+            event += sizeof(struct inotify_event) + notification->len;
+        }
+    }
+    for(size_t i = 0; i < m_Shaders.size(); i++){
+        const std::string& filepath = m_Shaders[i]->GetFilepath();
+        const std::string path = directoryOf(filepath) + "/" + fileNameOf(filepath);
+        if(std::find(changed.begin(), changed.end(), path) == changed.end()) continue;
+        if(m_Shaders[i]->Reload()) std::cerr << "Reloaded shader " << filepath << std::endl;
+        else std::cerr << "Shader " << filepath << " does not build, keeping the previous program" << std::endl;
+    }
+    #endif
+}
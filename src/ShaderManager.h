@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Shader;
+
+struct ShaderProgramSource{
+    std::string VertexSource;
+    std::string FragmentSource;
+};
+
+enum ShaderType{
+    NONE = -1, VERTEX = 0, FRAGMENT = 1
+};
+
+//default directory for linked program binaries, removed together with the build objects
+#define SHADER_CACHE_DIRECTORY "./binaries/shader_cache"
+
+//builds the programs of res/shaders and keeps their linked binaries on disk (glGetProgramBinary), so a later
+//start with the same source and driver skips compiling and linking; binaries are keyed by a hash of the source
+//and the GL vendor/renderer/version strings, a driver update or an edited shader misses the cache and recompiles
+//with hot reload enabled (Linux, inotify) shaders whose file is saved are rebuilt between frames
+//one manager per process, for the context current on the render thread
+class ShaderManager{
+    private:
+        typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length,
+            GLenum* binaryFormat, void* binary);
+        typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+        typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+        //empty if the binary cache is off (not initialized, disabled or unsupported by the context)
+        std::string m_CacheDirectory;
+        GetProgramBinaryProc m_GetProgramBinary;
+        ProgramBinaryProc m_ProgramBinary;
+        ProgramParameteriProc m_ProgramParameteri;
+        //formats glProgramBinary accepts, a binary in any other format would raise GL_INVALID_ENUM
+        std::vector<GLint> m_BinaryFormats;
+        //vendor, renderer and version of the context, part of every cache key
+        std::string m_Driver;
+
+        //shaders rebuilt when their file changes
+        std::vector<Shader*> m_Shaders;
+        //inotify descriptor (-1 if hot reload is off) and the watched directories by watch descriptor
+        int m_Notify;
+        std::unordered_map<int, std::string> m_Watches;
+
+        ShaderManager();
+        ~ShaderManager();
+        void watch(const std::string& filepath);
+        unsigned int loadCachedProgram(const std::string& filepath, unsigned long long key);
+        void storeCachedProgram(const std::string& filepath, unsigned long long key, unsigned int program);
+
+    public:
+        static ShaderManager& Get();
+
+        //detects program binary support (GL 4.1 or GL_ARB_get_program_binary) of the current context,
+        //an empty cacheDirectory turns the binary cache off; call after each context creation
+        void init(GLADloadproc load, const std::string& cacheDirectory = SHADER_CACHE_DIRECTORY);
+        //linked program of a "#shader vertex / #shader fragment" file, from the cache if possible
+        //returns 0 (and prints the compile or link log) if the file is missing or does not build
+        unsigned int loadProgram(const std::string& filepath);
+
+        //watches the directories of all registered shaders, false if inotify is unavailable
+        bool enableHotReload();
+        //rebuilds every registered shader whose file was written since the last call, call between frames
+        //a shader that fails to build keeps its previous program
+        void pollReload();
+        void registerShader(Shader* shader);
+        void unregisterShader(Shader* shader);
+
+        inline bool hasBinaryCache() const { return !m_CacheDirectory.empty(); }
+};
@@ -0,0 +1,123 @@
+#include "Spectrogram.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "ErrorHandler.h"
+#include "GLStateCache.h"
+#include "Visualizer.h"
+
+//rows cleared per upload, bounds the size of the zero buffer
+#define SPECTROGRAM_CLEAR_ROWS 64
+
+//stops of a perceptually ordered colormap (magma): level, rgb
+static const float s_ColormapStops[][4] = {
+    {0.000f,   0.0f,   0.0f,   4.0f},
+    {0.125f,  28.0f,  16.0f,  68.0f},
+    {0.250f,  79.0f,  18.0f, 123.0f},
+    {0.375f, 129.0f,  37.0f, 129.0f},
+    {0.500f, 181.0f,  54.0f, 122.0f},
+    {0.625f, 229.0f,  80.0f, 100.0f},
+    {0.750f, 251.0f, 135.0f,  97.0f},
+    {0.875f, 254.0f, 194.0f, 135.0f},
+    {1.000f, 252.0f, 253.0f, 191.0f}
+};
+
+//rgba8 entries for levels 0 to 1, linear between the stops
+static std::vector<unsigned char> bakeColormap(){
+    std::vector<unsigned char> entries(4 * COLORMAP_SIZE);
+    const int numStops = sizeof(s_ColormapStops) / sizeof(s_ColormapStops[0]);
+    int stop = 0;
+    for(int i = 0; i < COLORMAP_SIZE; i++){
+        const float level = (float)i / (COLORMAP_SIZE - 1);
+        while(stop < numStops - 2 && level > s_ColormapStops[stop + 1][0]) stop++;
+        const float* from = s_ColormapStops[stop];
+        const float* to = s_ColormapStops[stop + 1];
+        const float t = (level - from[0]) / (to[0] - from[0]);
+        for(int c = 0; c < 3; c++) entries[4*i + c] = (unsigned char)(from[c + 1] + t * (to[c + 1] - from[c + 1]) + 0.5f);
+        entries[4*i + 3] = 255;
+    }
+    return entries;
+}
+
+//the texture coordinates of the corners travel in the red and green color bytes
+static std::vector<Vertex> makeQuad(float x, float y, float width, float height){
+    std::vector<Vertex> vertices = {
+        {x        , y         , 0  , 0  , 0, 255},
+        {x + width, y         , 255, 0  , 0, 255},
+        {x + width, y + height, 255, 255, 0, 255},
+        {x        , y + height, 0  , 255, 0, 255},
+    };
+    return vertices;
+}
+
+static unsigned int s_QuadIndices[6] = {0, 1, 2, 2, 3, 0};
+
+Spectrogram::Spectrogram(float x, float y, float width, float height)
+    : m_Texture(0), m_Rows(SPECTROGRAM_HISTORY_SECONDS * ANALYSIS_RATE), m_Head(0), m_VisibleRows(0),
+    m_Colormap(COLORMAP_SIZE, 1, bakeColormap().data()),
+    m_Shader("./res/shaders/spectrogram.glsl"),
+    m_Quad(makeQuad(x, y, width, height).data(), s_QuadIndices, 4, 6, Visualizer::CreateVertexLayout()){
+
+    int maxSize = 0;
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize));
+    if(maxSize > 0 && m_Rows > maxSize){
+        std::cout << "Spectrogram history limited to " << maxSize / ANALYSIS_RATE << " s by the maximum texture size" << std::endl;
+        m_Rows = maxSize;
+    }
+    m_VisibleRows = m_Rows;
+
+    GLCall(glGenTextures(1, &m_Texture));
+    GLStateCache::Get().bindTexture2D(SPECTROGRAM_TEXTURE_UNIT, m_Texture);
+    //linear between neighbouring bins, the shader picks whole rows so the newest and oldest hop never blend
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    //rows before the first one wrap around to the end of the ring
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, SPECTROGRAM_BINS, m_Rows, 0, GL_RED, GL_FLOAT, nullptr));
+    GLStateCache::Get().bindTexture2D(SPECTROGRAM_TEXTURE_UNIT, 0);
+    clear();
+
+    m_ViewUniform = m_Shader.GetUniformHandle("u_View");
+    m_HistoryUniform = m_Shader.GetUniformHandle("u_History");
+    m_ColormapUniform = m_Shader.GetUniformHandle("u_Colormap");
+}
+
+Spectrogram::~Spectrogram(){
+    GLCall(glDeleteTextures(1, &m_Texture));
+    GLStateCache::Get().onDeleteTexture(m_Texture);
+}
+
+void Spectrogram::addRow(const float* levels){
+    GLStateCache::Get().bindTexture2D(SPECTROGRAM_TEXTURE_UNIT, m_Texture);
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_Head, SPECTROGRAM_BINS, 1, GL_RED, GL_FLOAT, levels));
+    m_Head = (m_Head + 1) % m_Rows;
+}
+
+void Spectrogram::clear(){
+    //level 0 is the first colormap entry, rows of bytes convert to it without a float buffer of the whole ring
+    std::vector<unsigned char> zeros(SPECTROGRAM_BINS * SPECTROGRAM_CLEAR_ROWS, 0);
+    GLStateCache::Get().bindTexture2D(SPECTROGRAM_TEXTURE_UNIT, m_Texture);
+    for(int row = 0; row < m_Rows; row += SPECTROGRAM_CLEAR_ROWS){
+        const int rows = std::min(SPECTROGRAM_CLEAR_ROWS, m_Rows - row);
+        GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, SPECTROGRAM_BINS, rows, GL_RED, GL_UNSIGNED_BYTE, zeros.data()));
+    }
+    m_Head = 0;
+}
+
+void Spectrogram::setVisibleSeconds(float seconds){
+    m_VisibleRows = std::min(std::max((int)(seconds * ANALYSIS_RATE), 2), m_Rows);
+}
+
+void Spectrogram::draw(const Renderer& renderer){
+    m_Shader.Bind();
+    GLStateCache::Get().bindTexture2D(SPECTROGRAM_TEXTURE_UNIT, m_Texture);
+    m_Colormap.Bind(COLORMAP_TEXTURE_UNIT);
+    //set every frame, a rebuilt program starts with every sampler on unit 0
+    m_Shader.SetUniform1i(m_HistoryUniform, SPECTROGRAM_TEXTURE_UNIT);
+    m_Shader.SetUniform1i(m_ColormapUniform, COLORMAP_TEXTURE_UNIT);
+    m_Shader.SetUniform4f(m_ViewUniform, (float)((m_Head + m_Rows - 1) % m_Rows), (float)m_VisibleRows, (float)m_Rows, 
+        MIN_FREQ / MAX_FREQ);
+    renderer.Draw(m_Quad.va, m_Quad.ib, m_Shader);
+}
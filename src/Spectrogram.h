@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "VisualizerConfig.h"
+#include "ImgTexture.h"
+#include "MappedDrawObj.h"
+#include "Renderer.h"
+#include "Shader.h"
+
+//texture units of the spectrogram history and its colormap, next to PALETTE_TEXTURE_UNIT (Vertex.h)
+#define SPECTROGRAM_TEXTURE_UNIT 1
+#define COLORMAP_TEXTURE_UNIT 2
+//entries of the baked colormap (level 0 to 1)
+#define COLORMAP_SIZE 256
+
+//scrolling spectrogram (waterfall) of the analysis hops: newest hop at the right edge, frequency upwards on a log scale
+//the history is a ring of texture rows (GL_R16F, SPECTROGRAM_BINS wide, one row per hop); adding a hop uploads a single
+//row with glTexSubImage2D and drawing is one quad whose fragment shader reads the ring and looks the level up in a
+//colormap, so neither depends on how much history is kept
+//the quad is given in design units and follows the graph anchor of the layout
+//requires a current OpenGL context for its whole lifetime
+class Spectrogram{
+    private:
+        unsigned int m_Texture;
+        //rows of the ring, SPECTROGRAM_HISTORY_SECONDS of hops unless the context limits the texture size
+        int m_Rows;
+        //row the next hop is written to
+        int m_Head;
+        //most recent rows stretched across the quad
+        int m_VisibleRows;
+        Texture m_Colormap;
+        Shader m_Shader;
+        MappedDrawObj m_Quad;
+        int m_ViewUniform;
+        int m_HistoryUniform;
+        int m_ColormapUniform;
+
+    public:
+        Spectrogram(float x, float y, float width, float height);
+        ~Spectrogram();
+
+        //appends one hop (SPECTROGRAM_BINS levels, FrameResult::spectrum), the oldest row is overwritten
+        void addRow(const float* levels);
+        //silences the whole history (e.g. when a new track is loaded)
+        void clear();
+        //length of the shown history, clamped to what the ring holds
+        void setVisibleSeconds(float seconds);
+        //binds its own program and textures
+        void draw(const Renderer& renderer);
+
+        inline float getHistorySeconds() const { return (float)m_Rows / ANALYSIS_RATE; }
+        inline float getVisibleSeconds() const { return (float)m_VisibleRows / ANALYSIS_RATE; }
+};
@@ -0,0 +1,157 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "Tracer.h"
+
+//pool and queue of the worker running on this thread, null/-1 on threads that are not pool workers
+static thread_local const ThreadPool* t_WorkerPool = nullptr;
+static thread_local int t_WorkerQueue = -1;
+
+static void pinCurrentThread(unsigned int core){
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0){
+        std::cerr << "Failed to pin pool worker to core " << core << std::endl;
+    }
+#elif defined(_WIN32)
+    if(SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) == 0){
+        std::cerr << "Failed to pin pool worker to core " << core << std::endl;
+    }
+#else
+    //macOS only has affinity hints between threads, not core pinning
+    (void)core;
+#endif
+}
+
+ThreadPool::ThreadPool(unsigned int numThreads, bool pinThreads)
+    : m_Queued(0), m_NextQueue(0), m_Stopping(false){
+    if(numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+    for(unsigned int i = 0; i < numThreads; i++){
+        WorkQueue* queue = new WorkQueue();
+        queue->head = 0;
+        queue->count = 0;
+        m_Queues.push_back(queue);
+    }
+    for(unsigned int i = 0; i < numThreads; i++){
+        m_Workers.push_back(std::thread(&ThreadPool::workerLoop, this, i, pinThreads));
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stopping = true;
+    }
+    m_TaskReady.notify_all();
+    for(size_t i = 0; i < m_Workers.size(); i++) m_Workers[i].join();
+    for(size_t i = 0; i < m_Queues.size(); i++) delete m_Queues[i];
+}
+
+int ThreadPool::ownQueue() const{
+    return t_WorkerPool == this ? t_WorkerQueue : -1;
+}
+
+void ThreadPool::execute(const Task& task){
+    task.function(task.context, task.index);
+    task.group->m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool ThreadPool::push(unsigned int queue, const Task& task){
+    WorkQueue& q = *m_Queues[queue];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(q.count == THREAD_POOL_QUEUE_TASKS) return false;
+        q.tasks[(q.head + q.count) % THREAD_POOL_QUEUE_TASKS] = task;
+        q.count++;
+    }
+    m_Queued.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool ThreadPool::popOwn(unsigned int queue, Task& task){
+    WorkQueue& q = *m_Queues[queue];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if(q.count == 0) return false;
+    //newest first: its data is most likely still in this core's cache
+    q.count--;
+    task = q.tasks[(q.head + q.count) % THREAD_POOL_QUEUE_TASKS];
+    m_Queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::steal(unsigned int thief, Task& task){
+    const unsigned int numQueues = (unsigned int)m_Queues.size();
+    for(unsigned int i = 1; i <= numQueues; i++){
+        WorkQueue& q = *m_Queues[(thief + i) % numQueues];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(q.count == 0) continue;
+        //oldest first: the largest remaining piece of work of the victim
+        task = q.tasks[q.head];
+        q.head = (q.head + 1) % THREAD_POOL_QUEUE_TASKS;
+        q.count--;
+        m_Queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::runOne(unsigned int thief){
+    Task task;
+    if(ownQueue() >= 0 && popOwn((unsigned int)ownQueue(), task)){
+        execute(task);
+        return true;
+    }
+    if(steal(thief, task)){
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned int index, bool pin){
+    TRACE_THREAD_NAME("pool worker");
+    t_WorkerPool = this;
+    t_WorkerQueue = (int)index;
+    if(pin) pinCurrentThread(index % std::max(1u, std::thread::hardware_concurrency()));
+    while(true){
+        if(runOne(index)) continue;
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_TaskReady.wait(lock, [this](){ return m_Stopping || m_Queued.load(std::memory_order_acquire) > 0; });
+        if(m_Stopping) return;
+    }
+}
+
+void ThreadPool::run(TaskGroup& group, TaskFunction function, void* context, size_t count){
+    group.m_Pending.fetch_add(count, std::memory_order_acq_rel);
+    for(size_t i = 0; i < count; i++){
+        Task task = {function, context, i, &group};
+        //workers keep subtasks local, other threads spread their tasks over all queues
+        const unsigned int queue = ownQueue() >= 0 ? (unsigned int)ownQueue() 
+            : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+        if(!push(queue, task)) execute(task);
+    }
+    {
+        //the lock orders the notification after a worker's predicate check
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    if(count == 1) m_TaskReady.notify_one();
+    else m_TaskReady.notify_all();
+}
+
+void ThreadPool::wait(TaskGroup& group){
+    const unsigned int thief = ownQueue() >= 0 ? (unsigned int)ownQueue() : 0;
+    while(!group.isDone()){
+        //help instead of blocking, the remaining tasks may be queued behind other work
+        if(!runOne(thief)) std::this_thread::yield();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//tasks each worker queue holds, run() executes a task inline when the queue is full
+#define THREAD_POOL_QUEUE_TASKS 1024
+
+//a task receives its context pointer and its index within one run() call
+typedef void (*TaskFunction)(void* context, size_t index);
+
+//counts the unfinished tasks of one job, tasks may add more tasks to their own group (task graphs)
+class TaskGroup{
+    private:
+        std::atomic<size_t> m_Pending;
+        friend class ThreadPool;
+    public:
+        TaskGroup() : m_Pending(0) {}
+        inline bool isDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+};
+
+//work-stealing pool: every worker owns a queue, runs its newest task first and steals the oldest task
+//of another worker when its own queue is empty; threads calling wait() execute tasks too
+//tasks are plain function pointers + context, so submitting never allocates
+class ThreadPool{
+    private:
+        typedef struct{
+            TaskFunction function;
+            void* context;
+            size_t index;
+            TaskGroup* group;
+        } Task;
+
+        //ring of tasks, the owner pushes and pops at the tail, thieves take from the head
+        typedef struct{
+            std::mutex mutex;
+            Task tasks[THREAD_POOL_QUEUE_TASKS];
+            size_t head;
+            size_t count;
+        } WorkQueue;
+
+        std::vector<std::thread> m_Workers;
+        std::vector<WorkQueue*> m_Queues;
+        //queued (not yet started) tasks over all queues, idle workers sleep while it is 0
+        std::atomic<size_t> m_Queued;
+        std::atomic<unsigned int> m_NextQueue;
+        std::mutex m_SleepMutex;
+        std::condition_variable m_TaskReady;
+        bool m_Stopping;
+
+        void workerLoop(unsigned int index, bool pin);
+        //queue of the calling thread if it is a worker of this pool, -1 otherwise
+        int ownQueue() const;
+        bool push(unsigned int queue, const Task& task);
+        bool popOwn(unsigned int queue, Task& task);
+        bool steal(unsigned int thief, Task& task);
+        //runs one queued task if there is any, thief is the caller's queue (or any value for non-workers)
+        bool runOne(unsigned int thief);
+        static void execute(const Task& task);
+
+    public:
+        //0 threads = one per hardware thread, pinThreads binds worker i to core i (where supported)
+        ThreadPool(unsigned int numThreads, bool pinThreads = false);
+        ~ThreadPool();
+
+        //queues function(context, index) for index in [0, count) as separate tasks of group
+        void run(TaskGroup& group, TaskFunction function, void* context, size_t count = 1);
+        //executes queued tasks until every task of group (including tasks they added) has finished
+        void wait(TaskGroup& group);
+
+        inline unsigned int getNumThreads() const { return (unsigned int)m_Workers.size(); }
+};
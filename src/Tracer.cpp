@@ -0,0 +1,189 @@
+#include "Tracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+typedef struct{
+    const char* name;
+    //'B' begin, 'E' end, 'C' counter
+    char phase;
+    long long timestamp;
+    double value;
+} TraceEvent;
+
+//written only by the thread that currently owns it; head is published with release so dump() sees complete events
+//events is null until tracing is first enabled (a reserved buffer costs nothing while tracing stays off),
+//published with release so the owning thread sees the allocated ring
+struct ThreadTrace{
+    std::atomic<TraceEvent*> events;
+    std::atomic<unsigned long long> head;
+    std::atomic<const char*> threadName;
+    unsigned int id;
+};
+
+std::atomic<bool> Tracer::s_Enabled(false);
+
+static std::string s_Path = "trace.json";
+static const std::chrono::steady_clock::time_point s_Origin = std::chrono::steady_clock::now();
+//buffers are kept until exit so their events stay readable after a thread ends;
+//a finished thread hands its buffer to the next new thread (short-lived workers would otherwise pile up buffers)
+static std::mutex s_RegistryMutex;
+static std::vector<ThreadTrace*> s_Threads;
+static std::vector<ThreadTrace*> s_ReleasedThreads;
+
+typedef struct ThreadTraceHandle{
+    ThreadTrace* trace;
+    ~ThreadTraceHandle(){
+        if(trace == nullptr) return;
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        s_ReleasedThreads.push_back(trace);
+    }
+} ThreadTraceHandle;
+
+//the buffer of the calling thread; trivially destructible, so touching it never registers a thread exit handler
+static thread_local ThreadTrace* t_Trace = nullptr;
+//only set for buffers taken by threadTrace(), a bound (reserved) buffer is released by its owner
+static thread_local ThreadTraceHandle t_Handle = {nullptr};
+
+//a released buffer or a new one, call with s_RegistryMutex held
+static ThreadTrace* takeThreadTrace(){
+    if(!s_ReleasedThreads.empty()){
+        ThreadTrace* trace = s_ReleasedThreads.back();
+        s_ReleasedThreads.pop_back();
+        return trace;
+    }
+    ThreadTrace* trace = new ThreadTrace();
+    trace->events = nullptr;
+    trace->head = 0;
+    trace->threadName = nullptr;
+    trace->id = (unsigned int)s_Threads.size() + 1;
+    s_Threads.push_back(trace);
+    return trace;
+}
+
+//call with s_RegistryMutex held
+static void allocateEvents(ThreadTrace* trace){
+    if(trace->events.load(std::memory_order_relaxed) != nullptr) return;
+    trace->events.store(new TraceEvent[TRACER_EVENTS_PER_THREAD](), std::memory_order_release);
+}
+
+static ThreadTrace* threadTrace(){
+    if(t_Trace != nullptr) return t_Trace;
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    t_Trace = takeThreadTrace();
+    allocateEvents(t_Trace);
+    t_Handle.trace = t_Trace;
+    return t_Trace;
+}
+
+static inline void record(const char* name, char phase, double value){
+    ThreadTrace* trace = threadTrace();
+    //a reserved buffer bound before tracing was ever enabled has no ring yet
+    TraceEvent* events = trace->events.load(std::memory_order_acquire);
+    if(events == nullptr) return;
+    const unsigned long long head = trace->head.load(std::memory_order_relaxed);
+    TraceEvent& event = events[head % TRACER_EVENTS_PER_THREAD];
+    event.name = name;
+    event.phase = phase;
+    event.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_Origin).count();
+    event.value = value;
+    trace->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::Enable(const std::string& path){
+    {
+        //reserved buffers get their ring on the first enable, not on the (realtime) threads that own them
+        std::lock_guard<std::mutex> lock(s_RegistryMutex);
+        for(size_t t = 0; t < s_Threads.size(); t++) allocateEvents(s_Threads[t]);
+    }
+    s_Path = path;
+    s_Enabled = true;
+}
+
+void Tracer::Disable(){
+    s_Enabled = false;
+}
+
+const std::string& Tracer::GetPath(){
+    return s_Path;
+}
+
+void Tracer::Begin(const char* name){
+    record(name, 'B', 0.0);
+}
+
+void Tracer::End(const char* name){
+    record(name, 'E', 0.0);
+}
+
+void Tracer::Counter(const char* name, double value){
+    record(name, 'C', value);
+}
+
+void Tracer::SetThreadName(const char* name){
+    threadTrace()->threadName.store(name, std::memory_order_relaxed);
+}
+
+ThreadTrace* Tracer::ReserveThread(){
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    ThreadTrace* trace = takeThreadTrace();
+    if(IsEnabled()) allocateEvents(trace);
+    return trace;
+}
+
+void Tracer::BindThread(ThreadTrace* trace){
+    if(t_Trace == nullptr) t_Trace = trace;
+}
+
+void Tracer::ReleaseThread(ThreadTrace* trace){
+    if(trace == nullptr) return;
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    s_ReleasedThreads.push_back(trace);
+}
+
+bool Tracer::Dump(){
+    FILE* file = fopen(s_Path.c_str(), "w");
+    if(file == NULL){
+        std::cerr << "Failed to write trace to " << s_Path << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s_RegistryMutex);
+    fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    unsigned long long written = 0;
+    for(size_t t = 0; t < s_Threads.size(); t++){
+        ThreadTrace* trace = s_Threads[t];
+        const char* threadName = trace->threadName.load(std::memory_order_relaxed);
+        if(threadName != nullptr){
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", 
+                first ? "" : ",\n", trace->id, threadName);
+            first = false;
+        }
+        const unsigned long long head = trace->head.load(std::memory_order_acquire);
+        const TraceEvent* events = trace->events.load(std::memory_order_acquire);
+        if(events == nullptr) continue;
+        //the owning thread keeps writing while we read, so skip the part of the ring it could reach next
+        unsigned long long start = 0;
+        if(head > TRACER_EVENTS_PER_THREAD) start = head - TRACER_EVENTS_PER_THREAD + TRACER_EVENTS_PER_THREAD / 4;
+        for(unsigned long long i = start; i < head; i++){
+            const TraceEvent& event = events[i % TRACER_EVENTS_PER_THREAD];
+            if(event.phase == 'C'){
+                fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%g}}", 
+                    first ? "" : ",\n", event.name, event.timestamp / 1000.0, trace->id, event.value);
+            }
+            else{
+                fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", 
+                    first ? "" : ",\n", event.name, event.phase, event.timestamp / 1000.0, trace->id);
+            }
+            first = false;
+            written++;
+        }
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    std::cerr << "Trace with " << written << " events written to " << s_Path << std::endl;
+    return true;
+}
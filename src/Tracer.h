@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+struct ThreadTrace;
+
+//events each thread can hold before the oldest ones are overwritten
+#define TRACER_EVENTS_PER_THREAD (1 << 16)
+
+//timeline tracing in the Chrome trace event format (chrome://tracing, ui.perfetto.dev)
+//every thread writes into its own ring of events without locks, dump() merges them into one JSON file
+//when tracing is disabled every TRACE_* macro costs a single branch
+class Tracer{
+    public:
+        static std::atomic<bool> s_Enabled;
+
+        static void Enable(const std::string& path);
+        static void Disable();
+        static inline bool IsEnabled() { return s_Enabled.load(std::memory_order_relaxed); }
+        //writes every thread's events to the path given to Enable()
+        static bool Dump();
+        static const std::string& GetPath();
+
+        //names must be string literals (only the pointer is stored)
+        static void Begin(const char* name);
+        static void End(const char* name);
+        static void Counter(const char* name, double value);
+        //label of the calling thread in the trace viewer
+        static void SetThreadName(const char* name);
+
+        //a thread's buffer is allocated (under a lock) the first time it records an event; threads that must not
+        //allocate or lock, like audio device callbacks, get a buffer reserved by their owner before they start
+        //and bind it as their first tracing call (no allocation, no lock); the event ring of a reserved buffer is
+        //allocated when tracing is first enabled, until then its events are dropped
+        static ThreadTrace* ReserveThread();
+        static void BindThread(ThreadTrace* trace);
+        //hands a reserved buffer to later threads, once the thread that bound it has stopped
+        static void ReleaseThread(ThreadTrace* trace);
+};
+
+class TraceScope{
+    private:
+        const char* m_Name;
+    public:
+        TraceScope(const char* name)
+            : m_Name(Tracer::IsEnabled() ? name : nullptr){
+            if(m_Name) Tracer::Begin(m_Name);
+        }
+        ~TraceScope(){
+            if(m_Name) Tracer::End(m_Name);
+        }
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+//do/while so a following else cannot attach to the macro's if
+#define TRACE_BEGIN(name) do{ if(Tracer::IsEnabled()) Tracer::Begin(name); }while(0)
+#define TRACE_END(name) do{ if(Tracer::IsEnabled()) Tracer::End(name); }while(0)
+#define TRACE_COUNTER(name, value) do{ if(Tracer::IsEnabled()) Tracer::Counter(name, value); }while(0)
+#define TRACE_THREAD_NAME(name) do{ if(Tracer::IsEnabled()) Tracer::SetThreadName(name); }while(0)
+#define TRACE_BIND_THREAD(trace) do{ if(Tracer::IsEnabled()) Tracer::BindThread(trace); }while(0)
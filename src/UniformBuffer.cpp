@@ -0,0 +1,28 @@
+#include "UniformBuffer.h"
+#include "Renderer.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding)
+    : m_Size(size), m_Binding(binding)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    //the generic uniform buffer binding is not tracked by the state cache, only this class uses it
+    GLCall(glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID));
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+    GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID));
+}
+
+UniformBuffer::~UniformBuffer(){
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::Update(const void* data, unsigned int size){
+    ASSERT(size == m_Size);
+    GLCall(glBindBuffer(GL_UNIFORM_BUFFER, m_RendererID));
+    //orphan the previous contents, draws of the last frame that still read them do not stall the upload
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW));
+    GLCall(glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data));
+}
+
+void UniformBuffer::Bind() const{
+    GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID));
+}
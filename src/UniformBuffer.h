@@ -0,0 +1,20 @@
+#pragma once
+
+//uniform block storage bound to a fixed binding point, every program whose block uses that point reads it
+class UniformBuffer
+{
+    private:
+        unsigned int m_RendererID;
+        unsigned int m_Size;
+        unsigned int m_Binding;
+    public:
+        UniformBuffer(unsigned int size, unsigned int binding);
+        ~UniformBuffer();
+
+        //replaces the whole contents, size must match the constructor size
+        void Update(const void* data, unsigned int size);
+        //attaches the buffer to its binding point again (e.g. after other code used the same point)
+        void Bind() const;
+
+        inline unsigned int GetBinding() const { return m_Binding; }
+};
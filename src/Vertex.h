@@ -0,0 +1,34 @@
+#pragma once
+
+//compact vertex format: 2D position (z is always constant) + normalized RGBA8 color
+//12 bytes per vertex instead of 28 (float xyz + float rgba)
+struct Vertex{
+    float x;
+    float y;
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+};
+
+static_assert(sizeof(Vertex) == 12, "Vertex must stay tightly packed (2 floats + 4 bytes)");
+
+//converts a [0, 1] color channel into a normalized byte (clamped, rounded to nearest)
+inline unsigned char PackColorChannel(float value){
+    if(value <= 0.0f) return 0;
+    if(value >= 1.0f) return 255;
+    return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+//theme palettes the bar shader looks up per vertex (primary: frequency graph, secondary: amplitude graph)
+//a palette color is stored in the color bytes as r/g = phase (low/high byte), b = palette + 2 * (theme + 1), a = 0
+//theme -1 follows the theme of the frame constants, otherwise it is a fixed ColorThemes::Theme index;
+//a literal color with zero alpha is invisible anyway, so the marker takes no color away
+#define PALETTE_PRIMARY 0
+#define PALETTE_SECONDARY 1
+#define PALETTE_FRAME_THEME -1
+//palette phases repeat after this many bars, also the number of baked entries per palette
+#define PALETTE_PERIOD 720
+//texture unit of the palette texture (ColorThemes::PackPalettes), unit 0 is also the value a sampler starts with,
+//so a rebuilt program reads the palettes without setting its sampler again
+#define PALETTE_TEXTURE_UNIT 0
@@ -1,5 +1,6 @@
 #include "VertexArray.h"
 #include "ErrorHandler.h"
+#include "GLStateCache.h"
 
 VertexArray::VertexArray(){
     GLCall(glGenVertexArrays(1, &m_RendererID)); 
@@ -7,6 +8,7 @@ VertexArray::VertexArray(){
 
 VertexArray::~VertexArray(){
     GLCall(glDeleteVertexArrays(1, &m_RendererID));
+    GLStateCache::Get().onDeleteVertexArray(m_RendererID);
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout){
@@ -29,9 +31,9 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 }
 
 void VertexArray::Bind() const{
-    GLCall(glBindVertexArray(m_RendererID));
+    GLStateCache::Get().bindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const{
-    GLCall(glBindVertexArray(0));
+    GLStateCache::Get().bindVertexArray(0);
 }
\ No newline at end of file
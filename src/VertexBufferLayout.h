@@ -35,27 +35,28 @@ class VertexBufferLayout{
             std::runtime_error("VBL Unsupported Type Pushed Error");
         }
 
-        template<>
-        void Push<float>(unsigned int count){
-            VertexBufferElement vbe = {GL_FLOAT, count, GL_FALSE};
-            m_Elements.push_back(vbe);
-            m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
-        }
-
-        template<>
-        void Push<unsigned int>(unsigned int count){
-            VertexBufferElement vbe = {GL_UNSIGNED_INT, count, GL_FALSE};
-            m_Elements.push_back(vbe);
-            m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
-        }
-
-        template<>
-        void Push<unsigned char>(unsigned int count){
-            VertexBufferElement vbe = {GL_UNSIGNED_BYTE, count, GL_TRUE};
-            m_Elements.push_back(vbe);
-            m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
-        }
-
-        inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
+        inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
         inline unsigned int GetStride() const { return m_Stride; }
-};
\ No newline at end of file
+};
+
+//explicit specializations live at namespace scope (in-class ones are rejected by GCC)
+template<>
+inline void VertexBufferLayout::Push<float>(unsigned int count){
+    VertexBufferElement vbe = {GL_FLOAT, count, GL_FALSE};
+    m_Elements.push_back(vbe);
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_FLOAT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned int>(unsigned int count){
+    VertexBufferElement vbe = {GL_UNSIGNED_INT, count, GL_FALSE};
+    m_Elements.push_back(vbe);
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT);
+}
+
+template<>
+inline void VertexBufferLayout::Push<unsigned char>(unsigned int count){
+    VertexBufferElement vbe = {GL_UNSIGNED_BYTE, count, GL_TRUE};
+    m_Elements.push_back(vbe);
+    m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
+}
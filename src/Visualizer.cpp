@@ -0,0 +1,219 @@
+#include "Visualizer.h"
+
+#include <cmath>
+
+#include "AuxComputations.h"
+#include "Profiler.h"
+
+void generateGraph(BarGraph& graph, unsigned int* indices, double* funcTable){
+    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
+        graph.setBar(i, 4 + MAX_AMPLITUDE_HEIGHT * funcTable[(int)(SCALING_FACTOR*i)%360], 0.0f);
+        graph.setPaletteColor(i, PALETTE_SECONDARY, i);
+    }
+    graph.fillIndices(indices, 0, 0);
+}
+
+void generateFreqGraph(BarGraph& freqGraph, unsigned int* indices, double* funcTable){
+    for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
+        freqGraph.setBar(i, 4 + MAX_AMPLITUDE_HEIGHT * funcTable[(int)(SCALING_FACTOR*i)%360], 0.0f);
+        freqGraph.setPaletteColor(i, PALETTE_PRIMARY, i);
+    }
+    freqGraph.fillIndices(indices, 0, 0);
+}
+
+void shiftGraphLeft(BarGraph& graph, float leftSample, float rightSample){
+    //update all graph bars and shift left, new sample becomes the last bar (next phase of the palette)
+    graph.shiftLeft(2 + MAX_AMPLITUDE_HEIGHT * leftSample, 2 + MAX_AMPLITUDE_HEIGHT * rightSample);
+}
+
+void updateFreqValues(BarGraph& freqGraph, fftw_complex* leftSamples, fftw_complex* rightSamples, float* freqSeparationTable){
+    float leftTargets[NUM_GRAPH_SAMPLES];
+    float rightTargets[NUM_GRAPH_SAMPLES];
+    computeFreqTargets(leftSamples, rightSamples, freqSeparationTable, leftTargets, rightTargets);
+    //calculate smoothed values (exponential smoothing) over all bars at once
+    freqGraph.smoothTowards(leftTargets, rightTargets, 0.85f, 2.0f);
+}
+
+void setMeterLevel(SampleLine& meter, float level, float maxLength){
+    meter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
+    if(level >= 0.05f) meter.changeColor(0.0f, 0.9f, 0.0f, 0.8f);
+    if(level >= 0.5f) meter.changeColor(0.9f, 0.9f, 0.0f, 0.8f);
+    if(level >= 0.75f) meter.changeColor(0.9f, 0.0f, 0.0f, 0.8f);
+    if(level >= 0.99f) meter.changeColor(0.9f, 0.9f, 0.9f, 0.8f);
+    meter.changeWidth(level*maxLength);
+}
+
+void adjustDecibelMeters(Vertex* positions, unsigned int* indices, SampleLine& leftDBMeter, SampleLine& rightDBMeter, float leftLevel, float rightLevel){
+    setMeterLevel(leftDBMeter, leftLevel, DECIBEL_METER_MAX_LENGTH);
+    leftDBMeter.fillVertices(positions, NUM_VERTICES_PER_SAMPLE*4);
+    leftDBMeter.fillIndices(indices, NUM_INDEX_POINTS*4);
+
+    setMeterLevel(rightDBMeter, rightLevel, DECIBEL_METER_MAX_LENGTH);
+    rightDBMeter.fillVertices(positions, NUM_VERTICES_PER_SAMPLE*5);
+    rightDBMeter.fillIndices(indices, NUM_INDEX_POINTS*5);
+}
+
+void addSeparatorLine(size_t offset, Vertex* positions, unsigned int* indices){
+    SampleLine separator(offset, WINDOW_MARGIN, WINDOW_HEIGHT/2 - 1, 2, 
+        WINDOW_WIDTH - 2*WINDOW_MARGIN - SAMPLE_MARGIN, 0.5f, 0.5f, 0.5f, 1.0f);
+
+    separator.fillVertices(positions, NUM_VERTICES_PER_SAMPLE*(offset));
+    separator.fillIndices(indices, NUM_INDEX_POINTS*(offset));
+}
+
+Visualizer::Visualizer(ColorThemes::Theme* theme)
+    : m_Theme(theme),
+    m_AmpGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN),
+    m_FreqGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN),
+    //buffers start uninitialized and are filled through the mapped pointers below
+    m_AmpGraphObj(nullptr, nullptr, NUM_VERTICES_PER_SAMPLE * (NUM_GRAPH_SAMPLES + 1), 
+        NUM_INDEX_POINTS * (NUM_GRAPH_SAMPLES + 1), CreateVertexLayout()),
+    m_DBMeterObj(nullptr, nullptr, NUM_VERTICES_PER_SAMPLE * 6, NUM_INDEX_POINTS * 6, CreateVertexLayout()),
+    m_FreqGraphObj(nullptr, nullptr, NUM_VERTICES_PER_SAMPLE * NUM_GRAPH_SAMPLES, 
+        NUM_INDEX_POINTS * NUM_GRAPH_SAMPLES, CreateVertexLayout()),
+    m_LeftDecibelMeter(4, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 5 + 30, 
+        20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f),
+    m_RightDecibelMeter(5, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 5, 
+        20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f),
+    m_Levels(0.0f, 0.0f, 0.01f, 0.01f){
+
+    for(int i = 0; i < 360; i++){
+        m_SinTable[i] = sin(i * M_PI/180);
+        m_CosTable[i] = cos(i * M_PI/180);
+        m_TanTable[i] = tan(i * M_PI/180);
+    }
+    m_FuncTable = m_SinTable;
+
+    //start setting up main graph
+    generateGraph(m_AmpGraph, m_AmpGraphObj.mappedIndices, m_FuncTable);
+    m_AmpGraph.upload(m_AmpGraphObj.mappedVertices, 0);
+    addSeparatorLine(NUM_GRAPH_SAMPLES, m_AmpGraphObj.mappedVertices, m_AmpGraphObj.mappedIndices);
+    //end setting up main graph
+
+    //start setting up decibel meter
+    Vertex* dbPositions = m_DBMeterObj.mappedVertices;
+    unsigned int* dbIndices = m_DBMeterObj.mappedIndices;
+    int dbIterator = 0;
+    float dbXPos = DECIBEL_METER_XPOS;
+    float dbYPos = DECIBEL_METER_YPOS;
+
+    SampleLine blackOutline(dbIterator, dbXPos - 5, dbYPos - 5, 
+        70, DECIBEL_METER_MAX_LENGTH + 10 + 10, 
+        0.0f, 0.0f, 0.0f, 1.0f);
+    blackOutline.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    blackOutline.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+
+    SampleLine greenSegment(dbIterator, dbXPos, dbYPos, 
+        60, DECIBEL_METER_MAX_LENGTH/2 + 10, 
+        0.0f, 0.7f, 0.0f, 1.0f);
+    greenSegment.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    greenSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+
+    SampleLine yellowSegment(dbIterator, dbXPos + DECIBEL_METER_MAX_LENGTH/2, dbYPos, 
+        60, DECIBEL_METER_MAX_LENGTH/4 + 10, 
+        0.7f, 0.7f, 0.0f, 1.0f);
+    yellowSegment.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    yellowSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+
+    SampleLine redSegment(dbIterator, dbXPos + ((DECIBEL_METER_MAX_LENGTH * 3) / 4), dbYPos, 
+        60, DECIBEL_METER_MAX_LENGTH/4 + 10, 
+        0.7f, 0.0f, 0.0f, 1.0f);
+    redSegment.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    redSegment.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+
+    m_LeftDecibelMeter.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    m_LeftDecibelMeter.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+
+    m_RightDecibelMeter.fillVertices(dbPositions, NUM_VERTICES_PER_SAMPLE*dbIterator);
+    m_RightDecibelMeter.fillIndices(dbIndices, NUM_INDEX_POINTS*dbIterator);
+    dbIterator++;
+    //end setting up decibel meter
+
+    //start setting up frequency graph
+    generateFreqGraph(m_FreqGraph, m_FreqGraphObj.mappedIndices, m_FuncTable);
+    m_FreqGraph.upload(m_FreqGraphObj.mappedVertices, 0);
+    //end setting up frequency graph
+}
+
+Visualizer::~Visualizer(){
+
+}
+
+VertexBufferLayout Visualizer::CreateVertexLayout(){
+    VertexBufferLayout layout;
+    //vertex position coords (xy)
+    layout.Push<float>(2);
+    //color coords (rgba, normalized bytes)
+    layout.Push<unsigned char>(4);
+    return layout;
+}
+
+void Visualizer::update(const FrameResult& frame){
+    if(frame.hops == 0) return;
+    shiftGraphLeft(m_AmpGraph, frame.leftLevel, frame.rightLevel);
+    adjustDecibelMeters(m_DBMeterObj.mappedVertices, m_DBMeterObj.mappedIndices, 
+        m_LeftDecibelMeter, m_RightDecibelMeter, frame.leftMeter, frame.rightMeter);
+    m_FreqGraph.setHeights(frame.leftFreqHeights, frame.rightFreqHeights);
+    m_Levels = glm::vec4(frame.leftLevel, frame.rightLevel, frame.leftMeter, frame.rightMeter);
+}
+
+void Visualizer::update(const PipelineFrame& frame){
+    if(frame.hops == 0) return;
+    for(size_t i = 0; i < frame.hops; i++){
+        shiftGraphLeft(m_AmpGraph, frame.leftLevels[i], frame.rightLevels[i]);
+    }
+    adjustDecibelMeters(m_DBMeterObj.mappedVertices, m_DBMeterObj.mappedIndices, 
+        m_LeftDecibelMeter, m_RightDecibelMeter, frame.result.leftMeter, frame.result.rightMeter);
+    m_FreqGraph.setHeights(frame.result.leftFreqHeights, frame.result.rightFreqHeights);
+    m_Levels = glm::vec4(frame.result.leftLevel, frame.result.rightLevel, frame.result.leftMeter, frame.result.rightMeter);
+}
+
+void Visualizer::reset(ColorThemes::Theme* theme){
+    m_Theme = theme;
+    //reset all graphs
+    generateGraph(m_AmpGraph, m_AmpGraphObj.mappedIndices, m_FuncTable);
+    generateFreqGraph(m_FreqGraph, m_FreqGraphObj.mappedIndices, m_FuncTable);
+    //reset decibel meters
+    m_LeftDecibelMeter.changeWidth(DECIBEL_METER_MAX_LENGTH);
+    m_LeftDecibelMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
+    m_LeftDecibelMeter.fillVertices(m_DBMeterObj.mappedVertices, NUM_VERTICES_PER_SAMPLE*4);
+    m_RightDecibelMeter.changeWidth(DECIBEL_METER_MAX_LENGTH);
+    m_RightDecibelMeter.changeColor(0.85f, 0.85f, 0.85f, 0.7f);
+    m_RightDecibelMeter.fillVertices(m_DBMeterObj.mappedVertices, NUM_VERTICES_PER_SAMPLE*5);
+    m_Levels = glm::vec4(0.0f, 0.0f, 0.01f, 0.01f);
+}
+
+void Visualizer::setTheme(ColorThemes::Theme* theme){
+    //bar colors follow the theme index in the frame constants, no vertex changes
+    m_Theme = theme;
+}
+
+void Visualizer::draw(const Renderer& renderer, const Shader& shader, float alpha){
+    {
+        PROFILE_SCOPE(PROFILE_VERTEX_FILL);
+        //generate bar geometry from the graph models only at upload time
+        m_AmpGraph.upload(m_AmpGraphObj.mappedVertices, 0);
+        m_FreqGraph.upload(m_FreqGraphObj.mappedVertices, 0, alpha);
+    }
+    renderer.Draw(m_AmpGraphObj.va, m_AmpGraphObj.ib, shader);
+    renderer.Draw(m_DBMeterObj.va, m_DBMeterObj.ib, shader);
+    renderer.Draw(m_FreqGraphObj.va, m_FreqGraphObj.ib, shader);
+}
+
+static glm::vec4 toVec4(const AuxComputations::RGBAColor& color){
+    return glm::vec4(color.r, color.g, color.b, color.a);
+}
+
+void Visualizer::fillFrameConstants(FrameConstants& constants) const{
+    constants.levels = m_Levels;
+    constants.theme = glm::vec4((float)m_Theme->getIndex(), 0.0f, 0.0f, 0.0f);
+    constants.backgroundColor = toVec4(m_Theme->getBG());
+    constants.textColor = toVec4(m_Theme->getText());
+    constants.buttonColor = toVec4(m_Theme->getButton());
+    constants.playButtonColor = toVec4(m_Theme->getPlayButton());
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <fftw3.h>
+#include <vector>
+
+#include "VisualizerConfig.h"
+#include "AnalysisEngine.h"
+#include "AnalysisPipeline.h"
+#include "BarGraph.h"
+#include "SampleLine.h"
+#include "MappedDrawObj.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ColorThemes.h"
+#include "FrameConstants.h"
+
+//idle shapes of the graphs, bars are colored from the secondary (amplitude) and primary (frequency) theme palettes
+void generateGraph(BarGraph& graph, unsigned int* indices, double* funcTable);
+
+void generateFreqGraph(BarGraph& freqGraph, unsigned int* indices, double* funcTable);
+
+void shiftGraphLeft(BarGraph& graph, float leftSample, float rightSample);
+
+void updateFreqValues(BarGraph& freqGraph, fftw_complex* leftSamples, fftw_complex* rightSamples, float* freqSeparationTable);
+
+//colors a decibel meter by its fill level (0.01-1) and sets its length, maxLength is the length of a full meter
+void setMeterLevel(SampleLine& meter, float level, float maxLength);
+
+void adjustDecibelMeters(Vertex* positions, unsigned int* indices, SampleLine& leftDBMeter, SampleLine& rightDBMeter, float leftLevel, float rightLevel);
+
+void addSeparatorLine(size_t offset, Vertex* positions, unsigned int* indices);
+
+//amplitude graph, decibel meters and frequency graph drawn from AnalysisEngine results
+//shared by the interactive window and headless rendering so both produce the same picture
+//requires a current OpenGL context for its whole lifetime
+class Visualizer{
+    private:
+        ColorThemes::Theme* m_Theme;
+
+        double m_SinTable[360];
+        double m_CosTable[360];
+        double m_TanTable[360];
+        //IMPORTANT: sets the function for drawing heights
+        double* m_FuncTable;
+
+        BarGraph m_AmpGraph;
+        BarGraph m_FreqGraph;
+        MappedDrawObj m_AmpGraphObj;
+        MappedDrawObj m_DBMeterObj;
+        MappedDrawObj m_FreqGraphObj;
+        SampleLine m_LeftDecibelMeter;
+        SampleLine m_RightDecibelMeter;
+        //levels and meter fills after the last hop, for the frame constants
+        glm::vec4 m_Levels;
+
+    public:
+        Visualizer(ColorThemes::Theme* theme);
+        ~Visualizer();
+
+        //layout of the Vertex struct, used for every draw object
+        static VertexBufferLayout CreateVertexLayout();
+
+        //adds one analysis hop to the graphs (nothing happens if the frame completed no hop)
+        void update(const FrameResult& frame);
+        //adds every hop of a pipelined frame to the amplitude graph and shows the state after the last one
+        void update(const PipelineFrame& frame);
+        //regenerates both graphs and resets the meters (e.g. when a new track is loaded)
+        void reset(ColorThemes::Theme* theme);
+        //recolors both graphs with a new theme (the shader looks bar colors up, so this is O(1))
+        void setTheme(ColorThemes::Theme* theme);
+        //uploads the graph geometry and draws graphs and meters, alpha interpolates the frequency graph
+        void draw(const Renderer& renderer, const Shader& shader, float alpha);
+        //sets the audio levels and theme colors of the per-frame constants, mvp and time are up to the caller
+        void fillFrameConstants(FrameConstants& constants) const;
+
+        //idle shape of the frequency graph, an AnalysisEngine can start its smoothing from it
+        inline const BarGraph& getFreqGraph() const { return m_FreqGraph; }
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+//layout and analysis constants shared by the interactive window and headless rendering
+//geometry is authored in design units: a WINDOW_WIDTH x WINDOW_HEIGHT canvas, origin bottom left; the window opens
+//at this size (times the content scale) and Layout maps the canvas to whatever size it is resized to
+#define WINDOW_WIDTH 1080.0f
+#define WINDOW_HEIGHT 720.0f
+#define SAMPLE_WIDTH 2
+#define SAMPLE_MARGIN 1
+#define NUM_FFT_SAMPLES 4096
+//256 regular amplitude samples
+#define NUM_GRAPH_SAMPLES 256
+#define WINDOW_MARGIN (((int)WINDOW_WIDTH - NUM_GRAPH_SAMPLES*(SAMPLE_WIDTH + 2*SAMPLE_MARGIN)) / 2)
+//2 triangles, 3 indices each
+#define NUM_INDEX_POINTS (2*3)
+//4 vertices (xy position + packed rgba color, see Vertex.h), 1 SampleLine object
+#define NUM_VERTICES_PER_SAMPLE 4
+#define MAX_AMPLITUDE_HEIGHT 200
+#define AUDIO_SAMPLE_RATE 48000
+//analysis runs on fixed hops of the audio clock, independent of the display refresh rate
+#define ANALYSIS_RATE 60
+//interleaved stereo samples consumed per analysis hop
+#define ANALYSIS_HOP_SAMPLES (2 * AUDIO_SAMPLE_RATE / ANALYSIS_RATE)
+//interleaved samples analyzed per hop (the most recent part of the hop)
+#define ANALYSIS_WINDOW_SAMPLES (AUDIO_SAMPLE_RATE / ANALYSIS_RATE)
+#define DECIBEL_METER_MAX_LENGTH 400
+#define DECIBEL_METER_XPOS ((float) WINDOW_MARGIN)
+#define DECIBEL_METER_YPOS (WINDOW_MARGIN + 10.0f)
+#define MIN_FREQ 20.0f
+//Nyquist frequency; can only determine up to half the sample rate frequency
+#define MAX_FREQ ((float) AUDIO_SAMPLE_RATE/2)
+#define BIN_WIDTH_FREQ_RANGE (((float) AUDIO_SAMPLE_RATE) / NUM_FFT_SAMPLES)
+//a spectrogram row holds every fft bin below the Nyquist frequency (full FFT resolution)
+#define SPECTROGRAM_BINS (NUM_FFT_SAMPLES / 2)
+//levels down to this far below full scale are spread over the colormap, quieter bins get its first color
+#define SPECTROGRAM_RANGE_DB 90.0f
+//history kept by the spectrogram, one row per analysis hop
+#define SPECTROGRAM_HISTORY_SECONDS 120
+#define NUM_HALVES 4
+#define SCALING_FACTOR (360/(((float)NUM_GRAPH_SAMPLES/NUM_HALVES) * 2))
+#define HERTZ_PARTITIONS_INIT {MIN_FREQ, 60, 200, 1000, 2000, MAX_FREQ} //divides into important frequency ranges
+#define BIN_PARTITIONS_INIT {1, 48, 100, 72, 35} //Adds to NUM_GRAPH_SAMPLES (256)
@@ -0,0 +1,112 @@
+#include "AllocCounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<bool> s_Counting(false);
+static std::atomic<size_t> s_Allocations(0);
+
+static inline void countAllocation(){
+    if(s_Counting.load(std::memory_order_relaxed)) s_Allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocCounter::Start(){
+    s_Allocations.store(0);
+    s_Counting.store(true);
+}
+
+size_t AllocCounter::Stop(){
+    s_Counting.store(false);
+    return s_Allocations.load();
+}
+
+#if defined(__GLIBC__)
+
+//glibc exports its allocator under these names as well, so the replacements below never recurse
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size){
+        countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size){
+        countAllocation();
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size){
+        countAllocation();
+        return __libc_realloc(pointer, size);
+    }
+
+    void* memalign(size_t alignment, size_t size){
+        countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size){
+        countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size){
+        countAllocation();
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer ? 0 : ENOMEM;
+    }
+}
+
+bool AllocCounter::CountsMalloc(){
+    return true;
+}
+
+#else
+
+void* operator new(size_t size){
+    countAllocation();
+    void* pointer = std::malloc(size ? size : 1);
+    if(!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](size_t size){
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept{
+    countAllocation();
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept{
+    std::free(pointer);
+}
+
+bool AllocCounter::CountsMalloc(){
+    return false;
+}
+
+#endif
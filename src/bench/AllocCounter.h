@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+
+//counts heap allocations of the whole process (every thread) between Start() and Stop()
+//on glibc malloc, calloc, realloc and the aligned variants are interposed and forwarded to the libc allocator, which
+//also covers operator new; elsewhere only the global operator new/new[] are replaced
+//linked into the benchmarks only, the app and the tests keep the plain allocator
+namespace AllocCounter{
+    void Start();
+    //allocations since Start()
+    size_t Stop();
+    //false if this platform only counts operator new
+    bool CountsMalloc();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//minimum measured time per repetition, iterations are doubled until a batch takes this long
+#define BENCH_MIN_BATCH_SECONDS 0.05
+#define BENCH_REPETITIONS 5
+
+//keeps the optimizer from dropping benchmarked work whose result is otherwise unused
+template<typename T>
+inline void BenchKeep(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+//times fn() and prints one JSON object per line:
+//{"name": ..., "iterations": ..., "ns_per_iter": median, "min_ns_per_iter": ..., "items_per_second": ...}
+//itemsPerIteration scales the throughput (e.g. samples per call), unit names what an item is
+//returns the median ns per iteration
+template<typename Fn>
+double RunBenchmark(const std::string& name, double itemsPerIteration, const char* unit, Fn fn){
+    typedef std::chrono::steady_clock Clock;
+    //warm up caches and find a batch size that is long enough to time reliably
+    size_t iterations = 1;
+    while(true){
+        Clock::time_point start = Clock::now();
+        for(size_t i = 0; i < iterations; i++) fn();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if(seconds >= BENCH_MIN_BATCH_SECONDS || iterations >= (1ull << 30)) break;
+        iterations *= 2;
+    }
+    std::vector<double> nsPerIteration;
+    for(int r = 0; r < BENCH_REPETITIONS; r++){
+        Clock::time_point start = Clock::now();
+        for(size_t i = 0; i < iterations; i++) fn();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        nsPerIteration.push_back(seconds * 1e9 / iterations);
+    }
+    std::sort(nsPerIteration.begin(), nsPerIteration.end());
+    const double median = nsPerIteration[nsPerIteration.size() / 2];
+    printf("{\"name\": \"%s\", \"iterations\": %zu, \"ns_per_iter\": %.2f, \"min_ns_per_iter\": %.2f, "
+        "\"items_per_second\": %.6g, \"unit\": \"%s\"}\n", 
+        name.c_str(), iterations, median, nsPerIteration[0], itemsPerIteration * 1e9 / median, unit);
+    fflush(stdout);
+    return median;
+}
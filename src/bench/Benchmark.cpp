@@ -0,0 +1,557 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fftw3.h>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "BenchHarness.h"
+#include "AllocCounter.h"
+#include "../RingBuffer.hpp"
+#include "../AuxComputations.h"
+#include "../BarGraph.h"
+#include "../SampleLine.h"
+#include "../AnalysisEngine.h"
+#include "../HopAnalyzer.h"
+#include "../Visualizer.h"
+#include "../VisualizerConfig.h"
+#include "../ColorThemes.h"
+#include "../ThreadPool.h"
+#include "../Headless.h"
+#include "../MappedDrawObj.h"
+#include "../Shader.h"
+#include "../ShaderManager.h"
+#include "../UniformBuffer.h"
+#include "../ErrorHandler.h"
+#include "../GLStateCache.h"
+#include "../Layout.h"
+#include "../Profiler.h"
+#include "../FrameArena.h"
+#include "../vendor/glm/gtc/matrix_transform.hpp"
+#include "../vendor/miniaudio/miniaudio.h"
+
+//CPU benchmarks, one JSON object per line on stdout; the gl/ benchmarks need an offscreen context (OSMesa or EGL)
+//usage: Benchmark [--filter <substring>] [--seconds <audio seconds for the end-to-end run>] [--egl]
+
+static std::string s_Filter;
+
+static bool selected(const std::string& name){
+    return s_Filter.empty() || name.find(s_Filter) != std::string::npos;
+}
+
+//deterministic stereo test signal: a few sines plus white noise, interleaved
+static std::vector<float> makeSignal(size_t frames){
+    std::vector<float> samples(2 * frames);
+    unsigned int seed = 12345;
+    for(size_t i = 0; i < frames; i++){
+        const double t = (double)i / AUDIO_SAMPLE_RATE;
+        seed = seed * 1664525u + 1013904223u;
+        const float noise = ((seed >> 8) / 16777216.0f - 0.5f) * 0.1f;
+        const float tone = (float)(0.4 * sin(2 * M_PI * 110.0 * t) + 0.2 * sin(2 * M_PI * 1250.0 * t) 
+            + 0.1 * sin(2 * M_PI * 7000.0 * t));
+        samples[2*i] = tone + noise;
+        samples[2*i + 1] = 0.8f * tone - noise;
+    }
+    return samples;
+}
+
+//32-bit float stereo WAV in memory, decoded by miniaudio like a file on disk
+static std::vector<unsigned char> makeWav(const std::vector<float>& samples){
+    const unsigned int dataSize = (unsigned int)(samples.size() * sizeof(float));
+    std::vector<unsigned char> wav(44 + dataSize);
+    unsigned char* p = wav.data();
+    auto put32 = [&p](unsigned int v){ std::memcpy(p, &v, 4); p += 4; };
+    auto put16 = [&p](unsigned short v){ std::memcpy(p, &v, 2); p += 2; };
+    std::memcpy(p, "RIFF", 4); p += 4;
+    put32(36 + dataSize);
+    std::memcpy(p, "WAVEfmt ", 8); p += 8;
+    put32(16);
+    put16(3); //IEEE float
+    put16(2);
+    put32(AUDIO_SAMPLE_RATE);
+    put32(AUDIO_SAMPLE_RATE * 2 * sizeof(float));
+    put16(2 * sizeof(float));
+    put16(32);
+    std::memcpy(p, "data", 4); p += 4;
+    put32(dataSize);
+    std::memcpy(p, samples.data(), dataSize);
+    return wav;
+}
+
+static void benchRingBuffer(){
+    if(!selected("ringbuffer")) return;
+    const size_t block = 4096;
+    RingBuffer<float> ringBuffer(1 << 16);
+    RunBenchmark("ringbuffer/push_pop_4096", block, "samples", [&](){
+        for(size_t i = 0; i < block; i++) ringBuffer.push((float)i);
+        float value = 0.0f;
+        for(size_t i = 0; i < block; i++) ringBuffer.pop(value);
+        BenchKeep(value);
+    });
+    std::vector<float> samples(ANALYSIS_WINDOW_SAMPLES, 0.0f);
+    RunBenchmark("ringbuffer/fill_array_window", ANALYSIS_WINDOW_SAMPLES, "samples", [&](){
+        for(size_t i = 0; i < ANALYSIS_WINDOW_SAMPLES; i++) ringBuffer.push((float)i);
+        AuxComputations::fillArrayWithSamples(ringBuffer, samples, ANALYSIS_WINDOW_SAMPLES);
+        BenchKeep(samples[0]);
+    });
+}
+
+static void benchFFT(){
+    std::vector<float> signal = makeSignal(65536);
+    for(int n = 1024; n <= 65536; n *= 2){
+        const std::string size = std::to_string(n);
+        if(selected("fft/double/" + size)){
+            double* in = (double*) fftw_malloc(n * sizeof(double));
+            fftw_complex* out = (fftw_complex*) fftw_malloc((n/2 + 1) * sizeof(fftw_complex));
+            fftw_plan plan = fftw_plan_dft_r2c_1d(n, in, out, FFTW_ESTIMATE);
+            for(int i = 0; i < n; i++) in[i] = signal[2*i];
+            RunBenchmark("fft/double/" + size, n, "samples", [&](){
+                fftw_execute(plan);
+                BenchKeep(out[1][0]);
+            });
+            fftw_destroy_plan(plan);
+            fftw_free(in);
+            fftw_free(out);
+        }
+        if(selected("fft/float/" + size)){
+            float* in = (float*) fftwf_malloc(n * sizeof(float));
+            fftwf_complex* out = (fftwf_complex*) fftwf_malloc((n/2 + 1) * sizeof(fftwf_complex));
+            fftwf_plan plan = fftwf_plan_dft_r2c_1d(n, in, out, FFTW_ESTIMATE);
+            for(int i = 0; i < n; i++) in[i] = signal[2*i];
+            RunBenchmark("fft/float/" + size, n, "samples", [&](){
+                fftwf_execute(plan);
+                BenchKeep(out[1][0]);
+            });
+            fftwf_destroy_plan(plan);
+            fftwf_free(in);
+            fftwf_free(out);
+        }
+    }
+}
+
+static void benchAnalysis(){
+    std::vector<float> window = makeSignal(ANALYSIS_WINDOW_SAMPLES / 2);
+    if(selected("analysis/peak")){
+        RunBenchmark("analysis/peak_stereo_window", window.size(), "samples", [&](){
+            float left = 0.0f, right = 0.0f;
+            AuxComputations::computePeakValueStereo(window, window.size(), left, right);
+            BenchKeep(left);
+            BenchKeep(right);
+        });
+    }
+    if(selected("analysis/rms")){
+        RunBenchmark("analysis/rms_stereo_window", window.size(), "samples", [&](){
+            float left = 0.0f, right = 0.0f;
+            AuxComputations::computeRMSValueStereo(window, window.size(), left, right);
+            BenchKeep(left);
+            BenchKeep(right);
+        });
+    }
+    if(selected("analysis/hop")){
+        HopAnalyzer analyzer;
+        HopAnalysis hop;
+        RunBenchmark("analysis/hop_peak_fft_bars", 1, "hops", [&](){
+            analyzer.compute(window.data(), window.size(), hop);
+            BenchKeep(hop.leftFreqTargets[0]);
+        });
+    }
+    if(selected("analysis/update_freq_values")){
+        //spectrum of the test signal, mapped onto the graph bars every iteration
+        double* in = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
+        fftw_complex* left = (fftw_complex*) fftw_malloc((NUM_FFT_SAMPLES/2 + 1) * sizeof(fftw_complex));
+        fftw_complex* right = (fftw_complex*) fftw_malloc((NUM_FFT_SAMPLES/2 + 1) * sizeof(fftw_complex));
+        std::vector<float> signal = makeSignal(NUM_FFT_SAMPLES);
+        fftw_plan plan = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, in, left, FFTW_ESTIMATE);
+        for(int i = 0; i < NUM_FFT_SAMPLES; i++) in[i] = signal[2*i];
+        fftw_execute(plan);
+        std::memcpy(right, left, (NUM_FFT_SAMPLES/2 + 1) * sizeof(fftw_complex));
+        float freqTable[NUM_GRAPH_SAMPLES + 1];
+        generateCustomBins(freqTable);
+        BarGraph freqGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+        RunBenchmark("analysis/update_freq_values", NUM_GRAPH_SAMPLES, "bars", [&](){
+            updateFreqValues(freqGraph, left, right, freqTable);
+            BenchKeep(freqGraph.getLeftHeights()[0]);
+        });
+        fftw_destroy_plan(plan);
+        fftw_free(in);
+        fftw_free(left);
+        fftw_free(right);
+    }
+}
+
+static void benchGeometry(){
+    std::vector<Vertex> vertices(NUM_VERTICES_PER_SAMPLE * (NUM_GRAPH_SAMPLES + 1));
+    std::vector<unsigned int> indices(NUM_INDEX_POINTS * (NUM_GRAPH_SAMPLES + 1));
+    if(selected("geometry/sampleline")){
+        std::vector<SampleLine> lines;
+        for(int i = 0; i < NUM_GRAPH_SAMPLES; i++){
+            lines.push_back(SampleLine(i, WINDOW_MARGIN + i * (SAMPLE_WIDTH + 2*SAMPLE_MARGIN), WINDOW_HEIGHT/2, 
+                50.0f, 30.0f, SAMPLE_WIDTH, 0.2f, 0.4f, 0.6f, 1.0f));
+        }
+        RunBenchmark("geometry/sampleline_fill_vertices", NUM_GRAPH_SAMPLES, "bars", [&](){
+            for(int i = 0; i < NUM_GRAPH_SAMPLES; i++) lines[i].fillVertices(vertices.data(), NUM_VERTICES_PER_SAMPLE * i);
+            BenchKeep(vertices[0].x);
+        });
+    }
+    BarGraph graph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    if(selected("geometry/bargraph_fill")){
+        RunBenchmark("geometry/bargraph_fill_vertices", NUM_GRAPH_SAMPLES, "bars", [&](){
+            graph.fillVertices(vertices.data(), 0, 0.5f);
+            BenchKeep(vertices[0].y);
+        });
+    }
+    if(selected("geometry/shift")){
+        float sample = 0.0f;
+        RunBenchmark("geometry/shift_graph_left", 1, "shifts", [&](){
+            sample = sample > 1.0f ? 0.0f : sample + 0.01f;
+            shiftGraphLeft(graph, sample, sample);
+            BenchKeep(graph.getLeftHeights()[0]);
+        });
+    }
+}
+
+//startup cost of the data-driven themes: parsing res/themes and baking every palette,
+//and one palette converted color by color vs with the batch kernel
+static void benchThemes(){
+    if(selected("themes/hsb")){
+        std::vector<float> hues(PALETTE_PERIOD), saturations(PALETTE_PERIOD, 0.6f), brightnesses(PALETTE_PERIOD, 0.7f);
+        std::vector<float> alphas(PALETTE_PERIOD, 1.0f);
+        for(int n = 0; n < PALETTE_PERIOD; n++) hues[n] = 1.40625f * n;
+        std::vector<unsigned char> entries(4 * PALETTE_PERIOD);
+        RunBenchmark("themes/hsb_scalar", PALETTE_PERIOD, "colors", [&](){
+            for(int n = 0; n < PALETTE_PERIOD; n++){
+                AuxComputations::RGBAColor color;
+                color.a = alphas[n];
+                AuxComputations::HSBtoRGBA((int)hues[n], saturations[n], brightnesses[n], color);
+                entries[4*n + 0] = PackColorChannel(color.r);
+                entries[4*n + 1] = PackColorChannel(color.g);
+                entries[4*n + 2] = PackColorChannel(color.b);
+                entries[4*n + 3] = PackColorChannel(color.a);
+            }
+            BenchKeep(entries[4]);
+        });
+        RunBenchmark("themes/hsb_batch", PALETTE_PERIOD, "colors", [&](){
+            AuxComputations::HSBtoRGBA8Batch(hues.data(), saturations.data(), brightnesses.data(), alphas.data(),
+                PALETTE_PERIOD, entries.data());
+            BenchKeep(entries[4]);
+        });
+    }
+    if(!selected("themes/load")) return;
+    std::vector<ColorThemes::Theme> themeTable;
+    ColorThemes::InitializeThemes(themeTable);
+    RunBenchmark("themes/load_and_bake", themeTable.size(), "themes", [&](){
+        ColorThemes::InitializeThemes(themeTable);
+        BenchKeep(themeTable[0].getPaletteEntry(PALETTE_SECONDARY, 0)[0]);
+    });
+}
+
+//decode -> hop analysis -> smoothing -> vertices, everything the app does per frame except GL
+static void benchEndToEnd(double seconds){
+    if(!selected("end_to_end")) return;
+    std::vector<unsigned char> wav = makeWav(makeSignal((size_t)(seconds * AUDIO_SAMPLE_RATE)));
+    AnalysisEngine engine;
+    BarGraph ampGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    BarGraph freqGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    SampleLine leftMeter(4, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 35, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    SampleLine rightMeter(5, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 5, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    std::vector<Vertex> graphVertices(2 * NUM_VERTICES_PER_SAMPLE * NUM_GRAPH_SAMPLES);
+    Vertex meterVertices[NUM_VERTICES_PER_SAMPLE * 6];
+    unsigned int meterIndices[NUM_INDEX_POINTS * 6];
+    std::vector<float> hopSamples(ANALYSIS_HOP_SAMPLES);
+
+    RunBenchmark("end_to_end/decode_analyze_fill_" + std::to_string((int)seconds) + "s", seconds, "audio_seconds", [&](){
+        ma_decoder decoder;
+        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, AUDIO_SAMPLE_RATE);
+        if(ma_decoder_init_memory(wav.data(), wav.size(), &config, &decoder) != MA_SUCCESS){
+            printf("{\"error\": \"failed to decode the synthetic wav\"}\n");
+            exit(1);
+        }
+        engine.reset();
+        while(true){
+            ma_uint64 framesRead = 0;
+            ma_decoder_read_pcm_frames(&decoder, hopSamples.data(), ANALYSIS_HOP_SAMPLES / 2, &framesRead);
+            if(framesRead < ANALYSIS_HOP_SAMPLES / 2) break;
+            const FrameResult& frame = engine.process(hopSamples.data(), ANALYSIS_HOP_SAMPLES / 2);
+            //same sequence as Visualizer::update
+            shiftGraphLeft(ampGraph, frame.leftLevel, frame.rightLevel);
+            adjustDecibelMeters(meterVertices, meterIndices, leftMeter, rightMeter, frame.leftMeter, frame.rightMeter);
+            freqGraph.setHeights(frame.leftFreqHeights, frame.rightFreqHeights);
+            ampGraph.fillVertices(graphVertices.data(), 0);
+            freqGraph.fillVertices(graphVertices.data(), NUM_VERTICES_PER_SAMPLE * NUM_GRAPH_SAMPLES);
+        }
+        BenchKeep(graphVertices[0].y);
+        ma_decoder_uninit(&decoder);
+    });
+}
+
+//frames run before counting, until every buffer reached its steady-state size
+#define ALLOC_WARMUP_FRAMES 120
+#define ALLOC_COUNTED_FRAMES 600
+
+//heap allocations of the per-frame CPU work once the loop is warm: audio ring buffer -> hop analysis (inline and on a
+//thread pool) -> smoothing -> vertices, plus the profiler and the frame arena; anything above 0 fails the run
+static void benchSteadyStateAllocations(){
+    if(!selected("alloc/steady_state")) return;
+    const size_t frames = ALLOC_WARMUP_FRAMES + ALLOC_COUNTED_FRAMES;
+    std::vector<float> signal = makeSignal(frames * ANALYSIS_HOP_SAMPLES / 2);
+    RingBuffer<float> ringBuffer(4 * ANALYSIS_HOP_SAMPLES);
+    std::vector<float> hopSamples(ANALYSIS_HOP_SAMPLES);
+    AnalysisEngine engine;
+    ThreadPool pool(2);
+    BarGraph ampGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    BarGraph freqGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    SampleLine leftMeter(4, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 35, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    SampleLine rightMeter(5, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 5, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    std::vector<Vertex> graphVertices(2 * NUM_VERTICES_PER_SAMPLE * NUM_GRAPH_SAMPLES);
+    Vertex meterVertices[NUM_VERTICES_PER_SAMPLE * 6];
+    unsigned int meterIndices[NUM_INDEX_POINTS * 6];
+
+    float overlay = 0.0f;
+    for(size_t i = 0; i < frames; i++){
+        if(i == ALLOC_WARMUP_FRAMES) AllocCounter::Start();
+        //same order as the window loop: arena and profiler first, then the hop and the geometry
+        FrameArena::Get().reset();
+        Profiler::Get().beginFrame();
+        {
+            ProfileScope scope(PROFILE_VERTEX_FILL);
+            const float* hop = signal.data() + i * ANALYSIS_HOP_SAMPLES;
+            for(size_t s = 0; s < ANALYSIS_HOP_SAMPLES; s++) ringBuffer.push(hop[s]);
+            AuxComputations::fillArrayWithSamples(ringBuffer, hopSamples, ANALYSIS_HOP_SAMPLES);
+            //every other frame on the pool, so both paths of the engine are covered
+            engine.setThreadPool(i % 2 ? &pool : nullptr);
+            const FrameResult& frame = engine.process(hopSamples.data(), ANALYSIS_HOP_SAMPLES / 2);
+            shiftGraphLeft(ampGraph, frame.leftLevel, frame.rightLevel);
+            adjustDecibelMeters(meterVertices, meterIndices, leftMeter, rightMeter, frame.leftMeter, frame.rightMeter);
+            freqGraph.setHeights(frame.leftFreqHeights, frame.rightFreqHeights);
+            ampGraph.fillVertices(graphVertices.data(), 0);
+            freqGraph.fillVertices(graphVertices.data(), NUM_VERTICES_PER_SAMPLE * NUM_GRAPH_SAMPLES);
+        }
+        //what the profiler overlay reads every frame
+        overlay += Profiler::Get().getPercentile(PROFILE_VERTEX_FILL, 0.5f) + Profiler::Get().getPercentile(PROFILE_FRAME, 0.99f);
+    }
+    const size_t allocations = AllocCounter::Stop();
+    engine.setThreadPool(nullptr);
+    BenchKeep(overlay);
+    BenchKeep(graphVertices[0].y);
+    printf("{\"name\": \"alloc/steady_state_frame\", \"frames\": %d, \"allocations\": %zu, \"counts_malloc\": %s}\n",
+        ALLOC_COUNTED_FRAMES, allocations, AllocCounter::CountsMalloc() ? "true" : "false");
+    fflush(stdout);
+    if(allocations > 0){
+        printf("{\"error\": \"the steady-state frame loop allocated %zu times\"}\n", allocations);
+        exit(1);
+    }
+}
+
+typedef struct{
+    std::vector<std::unique_ptr<AnalysisEngine>>* engines;
+    const float* hopSamples;
+} MultiStreamHop;
+
+static void processStreamHop(void* context, size_t index){
+    MultiStreamHop* hop = (MultiStreamHop*) context;
+    (*hop->engines)[index]->process(hop->hopSamples, ANALYSIS_HOP_SAMPLES / 2);
+}
+
+//K streams analyzed on a thread pool, one task per stream per hop; hops/s should grow with K up to the core count
+static void benchMultiStream(){
+    if(!selected("multi_stream")) return;
+    const size_t hopsPerStream = 60;
+    std::vector<float> signal = makeSignal(hopsPerStream * ANALYSIS_HOP_SAMPLES / 2);
+    ThreadPool pool(0);
+    for(size_t numStreams = 1; numStreams <= 2 * pool.getNumThreads() && numStreams <= 64; numStreams *= 2){
+        std::vector<std::unique_ptr<AnalysisEngine>> engines;
+        for(size_t i = 0; i < numStreams; i++) engines.push_back(std::unique_ptr<AnalysisEngine>(new AnalysisEngine()));
+        RunBenchmark("multi_stream/" + std::to_string(numStreams) + "_streams_" + std::to_string(pool.getNumThreads()) + "_threads", 
+            (double)(numStreams * hopsPerStream), "hops", [&](){
+            for(size_t hop = 0; hop < hopsPerStream; hop++){
+                MultiStreamHop context = {&engines, signal.data() + hop * ANALYSIS_HOP_SAMPLES};
+                TaskGroup group;
+                pool.run(group, processStreamHop, &context, numStreams);
+                pool.wait(group);
+            }
+            BenchKeep(engines[0]->getResult().leftMeter);
+        });
+    }
+}
+
+//one stream, every hop as a task graph (peak + per-channel FFTs, then bar ranges) vs everything on one thread
+static void benchHopTaskGraph(){
+    if(!selected("analysis/hop_task_graph")) return;
+    const size_t hops = 60;
+    std::vector<float> signal = makeSignal(hops * ANALYSIS_HOP_SAMPLES / 2);
+    AnalysisEngine engine;
+    RunBenchmark("analysis/hop_task_graph_single_threaded", (double)hops, "hops", [&](){
+        engine.process(signal.data(), signal.size() / 2);
+        BenchKeep(engine.getResult().leftMeter);
+    });
+    for(unsigned int threads = 1; threads <= 4; threads *= 2){
+        ThreadPool pool(threads);
+        engine.setThreadPool(&pool);
+        RunBenchmark("analysis/hop_task_graph_" + std::to_string(threads) + "_workers", (double)hops, "hops", [&](){
+            engine.process(signal.data(), signal.size() / 2);
+            BenchKeep(engine.getResult().leftMeter);
+        });
+        engine.setThreadPool(nullptr);
+    }
+}
+
+//a debug build without debug output wraps every GLCall in a glGetError drain before and after the call
+#define BENCH_GLCALL(checked, x) if(checked) GLClearError();\
+    x;\
+    if(checked) GLLogCall(#x, __FILE__, __LINE__)
+
+//GL calls of one UniformBuffer::Update (bind, orphan, upload)
+#define BENCH_UBO_UPDATE_CALLS 3
+
+//the GL calls of one window frame: clear, frame constants upload and a Renderer::Draw (program, vao, ibo, draw) per object
+//binds go through the state cache, checkedBinds is the number of them that reach GL (and would be checked)
+template<bool Checked>
+static void drawWindowFrame(Shader& shader, UniformBuffer& constantsBuffer, const FrameConstants& constants,
+    std::vector<std::unique_ptr<MappedDrawObj>>& objects, size_t checkedBinds){
+    BENCH_GLCALL(Checked, glClearColor(0.1f, 0.1f, 0.1f, 1.0f));
+    BENCH_GLCALL(Checked, glClear(GL_COLOR_BUFFER_BIT));
+    BENCH_GLCALL(Checked, constantsBuffer.Update(&constants, sizeof(constants)));
+    //the other calls of the upload are checked with the binds
+    checkedBinds += BENCH_UBO_UPDATE_CALLS - 1;
+    shader.Bind();
+    for(size_t i = 0; i < objects.size(); i++){
+        shader.Bind();
+        objects[i]->va.Bind();
+        objects[i]->ib.Bind();
+        BENCH_GLCALL(Checked, glDrawElements(GL_TRIANGLES, objects[i]->ib.GetCount(), GL_UNSIGNED_INT, nullptr));
+    }
+    for(size_t i = 0; Checked && i < checkedBinds; i++){
+        GLClearError();
+        GLLogCall("bind", __FILE__, __LINE__);
+    }
+    glFlush();
+}
+
+//per-frame CPU cost of the glGetError checks that release builds compile out (GL_CHECK_ERRORS=0)
+//on hardware drivers every glGetError can wait for the driver thread, software contexts show the lower bound
+static void benchGLErrorChecks(bool useEGL){
+    if(!selected("gl/error_checks")) return;
+    GLFWwindow* window;
+    if(!CreateOffscreenContext(useEGL, window)){
+        printf("{\"name\": \"gl/error_checks\", \"skipped\": \"no offscreen GL context\"}\n");
+        return;
+    }
+    GLStateCache::Get().invalidate();
+    ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress, "");
+    {
+        //same objects as the window: amplitude graph, decibel meters, frequency graph, border, play/pause, file, record
+        const size_t objectQuads[] = {NUM_GRAPH_SAMPLES, 6, NUM_GRAPH_SAMPLES, 4, 2, 3, 3};
+        VertexBufferLayout layout = Visualizer::CreateVertexLayout();
+        std::vector<std::unique_ptr<MappedDrawObj>> objects;
+        for(size_t i = 0; i < sizeof(objectQuads) / sizeof(objectQuads[0]); i++){
+            std::vector<Vertex> vertices(NUM_VERTICES_PER_SAMPLE * objectQuads[i]);
+            std::vector<unsigned int> indices(NUM_INDEX_POINTS * objectQuads[i], 0);
+            for(size_t q = 0; q < objectQuads[i]; q++){
+                SampleLine quad(q, WINDOW_MARGIN + q, WINDOW_MARGIN, 10.0f, 10.0f, 0.5f, 0.5f, 0.5f, 1.0f);
+                quad.fillVertices(vertices.data(), NUM_VERTICES_PER_SAMPLE * q);
+                quad.fillIndices(indices.data(), NUM_INDEX_POINTS * q);
+            }
+            objects.push_back(std::unique_ptr<MappedDrawObj>(new MappedDrawObj(vertices.data(), indices.data(), 
+                vertices.size(), indices.size(), layout)));
+        }
+        Shader shader("./res/shaders/shader.glsl");
+        FrameConstants constants;
+        Layout().fillFrameConstants(constants);
+        UniformBuffer constantsBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+
+        //steady state: binds that still reach GL after the state cache has seen a full frame
+        drawWindowFrame<false>(shader, constantsBuffer, constants, objects, 0);
+        GLStateCache::Get().beginFrame();
+        drawWindowFrame<false>(shader, constantsBuffer, constants, objects, 0);
+        GLStateCache::Get().beginFrame();
+        size_t binds = 0, bindsAvoided = 0;
+        for(int i = 0; i < GLSTATE_NUM_KINDS; i++){
+            binds += GLStateCache::Get().getLastIssued((GLStateKind)i);
+            bindsAvoided += GLStateCache::Get().getLastAvoided((GLStateKind)i);
+        }
+        const size_t callsPerFrame = 2 + BENCH_UBO_UPDATE_CALLS + objects.size() + binds;
+
+        const double unchecked = RunBenchmark("gl/error_checks_off_frame", 1, "frames", [&](){
+            drawWindowFrame<false>(shader, constantsBuffer, constants, objects, binds);
+        });
+        const double checked = RunBenchmark("gl/error_checks_on_frame", 1, "frames", [&](){
+            drawWindowFrame<true>(shader, constantsBuffer, constants, objects, binds);
+        });
+        printf("{\"name\": \"gl/error_checks_saved_per_frame\", \"gl_calls_per_frame\": %zu, \"binds_avoided_per_frame\": %zu, "
+            "\"ns_per_frame\": %.2f, \"ns_per_call\": %.2f}\n", callsPerFrame, bindsAvoided, checked - unchecked, 
+            (checked - unchecked) / callsPerFrame);
+        fflush(stdout);
+    }
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+//startup cost of the window shader compiled from source vs restored from the program binary cache,
+//and the per-frame upload of the constants every program shares
+static void benchShaderCache(bool useEGL){
+    if(!selected("gl/shader")) return;
+    GLFWwindow* window;
+    if(!CreateOffscreenContext(useEGL, window)){
+        printf("{\"name\": \"gl/shader\", \"skipped\": \"no offscreen GL context\"}\n");
+        return;
+    }
+    GLStateCache::Get().invalidate();
+    {
+        const std::string filepath = "./res/shaders/shader.glsl";
+        ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress, "");
+        RunBenchmark("gl/shader_compile", 1, "programs", [&](){
+            unsigned int program = ShaderManager::Get().loadProgram(filepath);
+            glDeleteProgram(program);
+        });
+        ShaderManager::Get().init((GLADloadproc)glfwGetProcAddress, SHADER_CACHE_DIRECTORY "/bench");
+        if(ShaderManager::Get().hasBinaryCache()){
+            //first load compiles and stores the binary
+            glDeleteProgram(ShaderManager::Get().loadProgram(filepath));
+            RunBenchmark("gl/shader_cached", 1, "programs", [&](){
+                unsigned int program = ShaderManager::Get().loadProgram(filepath);
+                glDeleteProgram(program);
+            });
+        }
+        else{
+            printf("{\"name\": \"gl/shader_cached\", \"skipped\": \"no program binary support\"}\n");
+        }
+
+        FrameConstants constants;
+        Layout().fillFrameConstants(constants);
+        UniformBuffer constantsBuffer(sizeof(FrameConstants), FRAME_CONSTANTS_BINDING);
+        RunBenchmark("gl/frame_constants_upload", 1, "uploads", [&](){
+            constantsBuffer.Update(&constants, sizeof(constants));
+        });
+        fflush(stdout);
+    }
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+int main(int argc, char** argv){
+    double seconds = 10.0;
+    bool useEGL = false;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--filter" && i + 1 < argc) s_Filter = argv[++i];
+        else if(arg == "--seconds" && i + 1 < argc) seconds = std::max(1.0, atof(argv[++i]));
+        else if(arg == "--egl") useEGL = true;
+    }
+
+    benchRingBuffer();
+    benchFFT();
+    benchAnalysis();
+    benchGeometry();
+    benchThemes();
+    benchEndToEnd(seconds);
+    benchSteadyStateAllocations();
+    benchHopTaskGraph();
+    benchMultiStream();
+    benchGLErrorChecks(useEGL);
+    benchShaderCache(useEGL);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "GoldenFile.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+void GoldenFile::add(const std::string& key, double value){
+    if(m_Series.find(key) == m_Series.end()) m_Order.push_back(key);
+    m_Series[key].push_back(value);
+}
+
+void GoldenFile::add(const std::string& key, const float* values, size_t count){
+    for(size_t i = 0; i < count; i++) add(key, values[i]);
+}
+
+bool GoldenFile::read(const std::string& path){
+    std::ifstream file(path);
+    if(!file.is_open()) return false;
+    std::string line;
+    while(std::getline(file, line)){
+        if(line.empty() || line[0] == '#') continue;
+        std::istringstream stream(line);
+        std::string key;
+        stream >> key;
+        double value;
+        while(stream >> value) add(key, value);
+    }
+    return true;
+}
+
+bool GoldenFile::write(const std::string& path, const std::string& header) const{
+    FILE* file = fopen(path.c_str(), "w");
+    if(file == NULL) return false;
+    fprintf(file, "# %s\n", header.c_str());
+    for(size_t k = 0; k < m_Order.size(); k++){
+        const std::vector<double>& values = m_Series.at(m_Order[k]);
+        fprintf(file, "%s", m_Order[k].c_str());
+        //9 significant digits round-trip a float exactly
+        for(size_t i = 0; i < values.size(); i++) fprintf(file, " %.9g", values[i]);
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    return true;
+}
+
+bool GoldenFile::compare(const GoldenFile& expected, double absTol, double relTol, std::vector<std::string>& errors, 
+    size_t maxErrors) const{
+    bool matches = true;
+    for(size_t k = 0; k < expected.m_Order.size(); k++){
+        const std::string& key = expected.m_Order[k];
+        const std::vector<double>& want = expected.m_Series.at(key);
+        std::map<std::string, std::vector<double>>::const_iterator found = m_Series.find(key);
+        if(found == m_Series.end() || found->second.size() != want.size()){
+            matches = false;
+            if(errors.size() < maxErrors) errors.push_back(key + ": missing or wrong length");
+            continue;
+        }
+        const std::vector<double>& got = found->second;
+        for(size_t i = 0; i < want.size(); i++){
+            if(std::fabs(got[i] - want[i]) <= absTol + relTol * std::fabs(want[i])) continue;
+            matches = false;
+            if(errors.size() < maxErrors){
+                char message[256];
+                snprintf(message, sizeof(message), "%s[%zu]: expected %.9g, got %.9g", key.c_str(), i, want[i], got[i]);
+                errors.push_back(message);
+            }
+        }
+    }
+    return matches;
+}
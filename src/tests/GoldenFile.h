@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+//named series of values compared against a text file ("<key> <v0> <v1> ..." per line, '#' starts a comment)
+class GoldenFile{
+    private:
+        std::map<std::string, std::vector<double>> m_Series;
+        //keys in insertion order so written files stay stable
+        std::vector<std::string> m_Order;
+
+    public:
+        void add(const std::string& key, double value);
+        void add(const std::string& key, const float* values, size_t count);
+
+        bool read(const std::string& path);
+        bool write(const std::string& path, const std::string& header) const;
+
+        //every key of expected has to exist here with the same length and |a - b| <= absTol + relTol * |b|
+        //mismatches are appended to errors (at most maxErrors)
+        bool compare(const GoldenFile& expected, double absTol, double relTol, std::vector<std::string>& errors, 
+            size_t maxErrors = 10) const;
+};
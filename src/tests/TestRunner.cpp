@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fftw3.h>
+
+#include "GoldenFile.h"
+#include "TestSignals.h"
+#include "../RingBuffer.hpp"
+#include "../AuxComputations.h"
+#include "../Vertex.h"
+#include "../AnalysisEngine.h"
+#include "../AnalysisPipeline.h"
+#include "../ThreadPool.h"
+#include "../BarGraph.h"
+#include "../SampleLine.h"
+#include "../HopAnalyzer.h"
+#include "../Visualizer.h"
+#include "../VisualizerConfig.h"
+
+//golden-output tests for the analysis pipeline (no window, no GL context)
+//usage: TestRunner [--golden <dir>] [--update]
+//--update rewrites the golden files from the current code, only do that for intended output changes
+
+//15 hops of audio, bar heights are recorded after these hops
+#define TEST_SIGNAL_FRAMES (15 * ANALYSIS_HOP_SAMPLES / 2)
+static const int s_SnapshotHops[] = {4, 9, 14};
+//fft bins whose magnitudes are recorded every hop (~12 Hz to ~20 kHz)
+static const int s_FFTBins[] = {1, 10, 21, 85, 170, 426, 853, 1706};
+
+//values are floats that went through transcendental functions and an FFT, so allow small platform differences
+#define GOLDEN_ABS_TOLERANCE 1e-4
+#define GOLDEN_REL_TOLERANCE 1e-3
+
+static int s_Failures = 0;
+
+static void check(bool condition, const std::string& test, const std::string& message){
+    if(condition) return;
+    std::cout << "[FAIL] " << test << ": " << message << std::endl;
+    s_Failures++;
+}
+
+//runs every analysis stage over one signal the way the render loop does and records the outputs
+static void runPipeline(const TestSignals::Signal& signal, GoldenFile& output){
+    const std::string test = "pipeline/" + signal.name;
+
+    RingBuffer<float> ringBuffer(signal.samples.size() + 1);
+    for(size_t i = 0; i < signal.samples.size(); i++) ringBuffer.push(signal.samples[i]);
+
+    double* leftIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
+    double* rightIn = (double*) fftw_malloc(NUM_FFT_SAMPLES * sizeof(double));
+    fftw_complex* leftOut = (fftw_complex*) fftw_malloc((NUM_FFT_SAMPLES/2 + 1) * sizeof(fftw_complex));
+    fftw_complex* rightOut = (fftw_complex*) fftw_malloc((NUM_FFT_SAMPLES/2 + 1) * sizeof(fftw_complex));
+    fftw_plan planLeft = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, leftIn, leftOut, FFTW_ESTIMATE);
+    fftw_plan planRight = fftw_plan_dft_r2c_1d(NUM_FFT_SAMPLES, rightIn, rightOut, FFTW_ESTIMATE);
+    float freqTable[NUM_GRAPH_SAMPLES + 1];
+    generateCustomBins(freqTable);
+
+    BarGraph freqGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+    //the same hops through HopAnalyzer must give exactly the same bars
+    HopAnalyzer analyzer;
+    HopAnalysis hop;
+    BarGraph analyzerGraph(NUM_GRAPH_SAMPLES, WINDOW_MARGIN, WINDOW_HEIGHT/2, SAMPLE_WIDTH, SAMPLE_WIDTH + 2*SAMPLE_MARGIN);
+
+    SampleLine leftMeter(4, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 35, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    SampleLine rightMeter(5, DECIBEL_METER_XPOS + 5, DECIBEL_METER_YPOS + 5, 20, DECIBEL_METER_MAX_LENGTH, 0.85f, 0.85f, 0.85f, 0.7f);
+    Vertex meterVertices[NUM_VERTICES_PER_SAMPLE * 6];
+    unsigned int meterIndices[NUM_INDEX_POINTS * 6];
+    float prevLeftSample = 0.0f, prevRightSample = 0.0f, prevLeftMeter = 1.0f, prevRightMeter = 1.0f;
+
+    const size_t numHops = signal.samples.size() / ANALYSIS_HOP_SAMPLES;
+    size_t snapshot = 0;
+    for(size_t hopIndex = 0; hopIndex < numHops; hopIndex++){
+        //fillArrayWithSamples: the window is the most recent part of the hop, bit exact
+        for(int i = 0; i < ANALYSIS_HOP_SAMPLES - ANALYSIS_WINDOW_SAMPLES; i++){
+            float temp;
+            ringBuffer.pop(temp);
+        }
+        std::vector<float> arraySamples(ANALYSIS_WINDOW_SAMPLES, 0.0f);
+        AuxComputations::fillArrayWithSamples(ringBuffer, arraySamples, ANALYSIS_WINDOW_SAMPLES);
+        const size_t windowStart = hopIndex * ANALYSIS_HOP_SAMPLES + ANALYSIS_HOP_SAMPLES - ANALYSIS_WINDOW_SAMPLES;
+        check(std::memcmp(arraySamples.data(), &signal.samples[windowStart], ANALYSIS_WINDOW_SAMPLES * sizeof(float)) == 0, 
+            test, "fillArrayWithSamples returned different samples at hop " + std::to_string(hopIndex));
+
+        //computePeakValueStereo
+        float leftPeak = 0.0f, rightPeak = 0.0f;
+        AuxComputations::computePeakValueStereo(arraySamples, ANALYSIS_WINDOW_SAMPLES, leftPeak, rightPeak);
+        output.add("peak_left", leftPeak);
+        output.add("peak_right", rightPeak);
+
+        //FFT of the zero padded window
+        std::fill(leftIn, leftIn + NUM_FFT_SAMPLES, 0.0);
+        std::fill(rightIn, rightIn + NUM_FFT_SAMPLES, 0.0);
+        for(int i = 0; i < ANALYSIS_WINDOW_SAMPLES / 2; i++){
+            leftIn[i] = arraySamples[2*i];
+            rightIn[i] = arraySamples[2*i + 1];
+        }
+        fftw_execute(planLeft);
+        fftw_execute(planRight);
+        for(size_t b = 0; b < sizeof(s_FFTBins) / sizeof(s_FFTBins[0]); b++){
+            const int bin = s_FFTBins[b];
+            output.add("fft_mag_left", sqrt(leftOut[bin][0] * leftOut[bin][0] + leftOut[bin][1] * leftOut[bin][1]));
+            output.add("fft_mag_right", sqrt(rightOut[bin][0] * rightOut[bin][0] + rightOut[bin][1] * rightOut[bin][1]));
+        }
+
+        //updateFreqValues
+        updateFreqValues(freqGraph, leftOut, rightOut, freqTable);
+        analyzer.compute(arraySamples.data(), ANALYSIS_WINDOW_SAMPLES, hop);
+        analyzerGraph.smoothTowards(hop.leftFreqTargets, hop.rightFreqTargets, 0.85f, 2.0f);
+        check(hop.leftPeak == leftPeak && hop.rightPeak == rightPeak, test, 
+            "HopAnalyzer peak differs at hop " + std::to_string(hopIndex));
+        check(std::memcmp(analyzerGraph.getLeftHeights(), freqGraph.getLeftHeights(), NUM_GRAPH_SAMPLES * sizeof(float)) == 0 
+            && std::memcmp(analyzerGraph.getRightHeights(), freqGraph.getRightHeights(), NUM_GRAPH_SAMPLES * sizeof(float)) == 0, 
+            test, "HopAnalyzer bars differ from updateFreqValues at hop " + std::to_string(hopIndex));
+        if(snapshot < sizeof(s_SnapshotHops) / sizeof(s_SnapshotHops[0]) && (int)hopIndex == s_SnapshotHops[snapshot]){
+            const std::string suffix = "_hop" + std::to_string(hopIndex);
+            output.add("bars_left" + suffix, freqGraph.getLeftHeights(), NUM_GRAPH_SAMPLES);
+            output.add("bars_right" + suffix, freqGraph.getRightHeights(), NUM_GRAPH_SAMPLES);
+            snapshot++;
+        }
+
+        //adjustDecibelMeters, fed with the smoothed peaks like Visualizer::apply
+        float leftSample = AuxComputations::expSmooth(prevLeftSample, leftPeak, 0.3f);
+        float rightSample = AuxComputations::expSmooth(prevRightSample, rightPeak, 0.3f);
+        prevLeftSample = leftSample;
+        prevRightSample = rightSample;
+        float leftDB, rightDB;
+        AuxComputations::computeDecibelLevels(leftSample, rightSample, leftDB, rightDB);
+        output.add("dbfs_left", leftDB);
+        output.add("dbfs_right", rightDB);
+        const float leftLevel = smoothMeterLevel(prevLeftMeter, leftDB);
+        const float rightLevel = smoothMeterLevel(prevRightMeter, rightDB);
+        adjustDecibelMeters(meterVertices, meterIndices, leftMeter, rightMeter, leftLevel, rightLevel);
+        prevLeftMeter = leftLevel;
+        prevRightMeter = rightLevel;
+        output.add("meter_left", leftLevel);
+        output.add("meter_right", rightLevel);
+        output.add("meter_width_left", leftMeter.getWidth());
+        output.add("meter_width_right", rightMeter.getWidth());
+    }
+
+    //the engine fed with uneven chunks has to end up in exactly the same state as the explicit path
+    AnalysisEngine engine;
+    size_t offset = 0;
+    for(size_t chunk = 1; offset < numHops * ANALYSIS_HOP_SAMPLES; chunk = chunk * 3 % 1009 + 1){
+        const size_t frames = std::min(chunk, (numHops * ANALYSIS_HOP_SAMPLES - offset) / 2);
+        engine.process(&signal.samples[offset], frames);
+        offset += 2 * frames;
+    }
+    const FrameResult& result = engine.getResult();
+    check(result.hopIndex == numHops, test, "AnalysisEngine completed " + std::to_string(result.hopIndex) + " hops");
+    check(result.leftLevel == prevLeftSample && result.rightLevel == prevRightSample 
+        && result.leftMeter == prevLeftMeter && result.rightMeter == prevRightMeter, test, "AnalysisEngine levels differ");
+    check(std::memcmp(result.leftFreqHeights, freqGraph.getLeftHeights(), NUM_GRAPH_SAMPLES * sizeof(float)) == 0 
+        && std::memcmp(result.rightFreqHeights, freqGraph.getRightHeights(), NUM_GRAPH_SAMPLES * sizeof(float)) == 0, 
+        test, "AnalysisEngine bars differ from updateFreqValues");
+
+    //the task graph on a work-stealing pool has to give the same result as the single-threaded path
+    ThreadPool pool(3);
+    AnalysisEngine pooledEngine;
+    pooledEngine.setThreadPool(&pool);
+    pooledEngine.process(signal.samples.data(), numHops * ANALYSIS_HOP_SAMPLES / 2);
+    const FrameResult& pooled = pooledEngine.getResult();
+    check(pooled.hopIndex == numHops && pooled.leftMeter == result.leftMeter && pooled.rightMeter == result.rightMeter
+        && std::memcmp(pooled.leftFreqHeights, result.leftFreqHeights, NUM_GRAPH_SAMPLES * sizeof(float)) == 0 
+        && std::memcmp(pooled.rightFreqHeights, result.rightFreqHeights, NUM_GRAPH_SAMPLES * sizeof(float)) == 0
+        && std::memcmp(pooled.spectrum, result.spectrum, SPECTROGRAM_BINS * sizeof(float)) == 0, 
+        test, "AnalysisEngine on a thread pool differs from the single-threaded engine");
+
+    //the pipeline thread has to hand over every hop in order, whatever the frames it groups them into
+    AnalysisEngine hopEngine;
+    std::vector<float> hopLevels;
+    std::vector<float> hopSpectra;
+    for(size_t hop = 0; hop < numHops; hop++){
+        const FrameResult& hopResult = hopEngine.process(&signal.samples[hop * ANALYSIS_HOP_SAMPLES], ANALYSIS_HOP_SAMPLES / 2);
+        hopLevels.push_back(hopResult.leftLevel);
+        hopLevels.push_back(hopResult.rightLevel);
+        hopSpectra.insert(hopSpectra.end(), hopResult.spectrum, hopResult.spectrum + SPECTROGRAM_BINS);
+    }
+    RingBuffer<float> pipelineRing(numHops * ANALYSIS_HOP_SAMPLES + 1);
+    for(size_t i = 0; i < numHops * ANALYSIS_HOP_SAMPLES; i++) pipelineRing.push(signal.samples[i]);
+    AnalysisEngine pipelineEngine;
+    AnalysisPipeline pipeline(pipelineEngine, numHops);
+    pipeline.start(pipelineRing);
+    std::vector<float> pipelineLevels;
+    std::vector<float> pipelineSpectra;
+    FrameResult pipelineResult = {};
+    for(int wait = 0; wait < 5000 && pipelineLevels.size() < 2 * numHops; wait++){
+        while(const PipelineFrame* frame = pipeline.acquire()){
+            for(size_t hop = 0; hop < frame->hops; hop++){
+                pipelineLevels.push_back(frame->leftLevels[hop]);
+                pipelineLevels.push_back(frame->rightLevels[hop]);
+                pipelineSpectra.insert(pipelineSpectra.end(), frame->spectra[hop], frame->spectra[hop] + SPECTROGRAM_BINS);
+            }
+            pipelineResult = frame->result;
+            pipeline.release();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    pipeline.stop();
+    check(pipelineLevels == hopLevels, test, "AnalysisPipeline handed over " + std::to_string(pipelineLevels.size() / 2) 
+        + " hops that differ from the single-threaded engine");
+    check(pipelineSpectra == hopSpectra, test, "AnalysisPipeline spectrogram rows differ from the single-threaded engine");
+    check(pipelineResult.leftMeter == result.leftMeter && pipelineResult.rightMeter == result.rightMeter
+        && std::memcmp(pipelineResult.leftFreqHeights, result.leftFreqHeights, NUM_GRAPH_SAMPLES * sizeof(float)) == 0 
+        && std::memcmp(pipelineResult.rightFreqHeights, result.rightFreqHeights, NUM_GRAPH_SAMPLES * sizeof(float)) == 0, 
+        test, "last AnalysisPipeline frame differs from the single-threaded engine");
+
+    fftw_destroy_plan(planLeft);
+    fftw_destroy_plan(planRight);
+    fftw_free(leftIn);
+    fftw_free(rightIn);
+    fftw_free(leftOut);
+    fftw_free(rightOut);
+}
+
+//an empty ring buffer must leave the rest of the window untouched
+static void testFillArrayUnderrun(){
+    RingBuffer<float> ringBuffer(16);
+    ringBuffer.push(0.25f);
+    ringBuffer.push(-0.25f);
+    std::vector<float> samples(8, 7.0f);
+    const size_t filled = AuxComputations::fillArrayWithSamples(ringBuffer, samples, samples.size());
+    check(filled == 2, "fillArrayWithSamples/underrun", "reported " + std::to_string(filled) + " samples instead of 2");
+    check(samples[0] == 0.25f && samples[1] == -0.25f, "fillArrayWithSamples/underrun", "available samples not copied");
+    bool untouched = true;
+    for(size_t i = 2; i < samples.size(); i++) untouched = untouched && samples[i] == 7.0f;
+    check(untouched, "fillArrayWithSamples/underrun", "samples past the end of the buffer were overwritten");
+}
+
+//a full scale sine centered on a bin reads as the top of the spectrogram range, silence as the bottom
+static void testSpectrogramLevels(){
+    const std::string test = "spectrogram/levels";
+    const int bin = 170;
+    const float frequency = bin * BIN_WIDTH_FREQ_RANGE;
+    const int failures = s_Failures;
+    std::vector<float> samples(ANALYSIS_WINDOW_SAMPLES, 0.0f);
+    HopAnalyzer analyzer;
+    HopAnalysis hop;
+    analyzer.compute(samples.data(), samples.size(), hop);
+    float loudest = 0.0f;
+    for(int i = 0; i < SPECTROGRAM_BINS; i++) loudest = std::max(loudest, hop.spectrum[i]);
+    check(loudest == 0.0f, test, "silence reaches level " + std::to_string(loudest));
+
+    for(size_t i = 0; i < samples.size() / 2; i++){
+        samples[2*i] = samples[2*i + 1] = sinf(2.0f * (float)M_PI * frequency * i / AUDIO_SAMPLE_RATE);
+    }
+    analyzer.compute(samples.data(), samples.size(), hop);
+    check(std::fabs(hop.spectrum[bin] - 1.0f) < 0.02f, test, "full scale sine reaches level " + std::to_string(hop.spectrum[bin]));
+    //window leakage leaves the bins 600 away roughly 50 dB down; require at least 40 dB of the 90 dB range
+    const float farLevel = hop.spectrum[bin + 600];
+    check(farLevel < 1.0f - 40.0f / SPECTROGRAM_RANGE_DB, test, "level " + std::to_string(farLevel) + " 600 bins from the sine");
+    if(s_Failures == failures) std::cout << "[PASS] " << test << std::endl;
+}
+
+//the batch kernel must agree with the scalar conversion for every whole-degree hue, including the zero-padded tail
+static void testHSBBatch(){
+    const std::string test = "HSBtoRGBABatch/scalar";
+    std::vector<float> hues, saturations, brightnesses, alphas;
+    //-720 to 1079 degrees covers wrapping in both directions; 3 * 1801 colors is not a multiple of the lane count
+    for(int h = -720; h <= 1080; h++){
+        const float levels[3][2] = {{1.0f, 1.0f}, {0.6f, 0.7f}, {1.5f, -0.2f}};
+        for(int l = 0; l < 3; l++){
+            hues.push_back(h + 0.75f);
+            saturations.push_back(levels[l][0]);
+            brightnesses.push_back(levels[l][1]);
+            alphas.push_back(0.1f * (h & 7));
+        }
+    }
+    std::vector<AuxComputations::RGBAColor> colors(hues.size());
+    std::vector<unsigned char> bytes(4 * hues.size());
+    AuxComputations::HSBtoRGBABatch(hues.data(), saturations.data(), brightnesses.data(), alphas.data(), hues.size(), colors.data());
+    AuxComputations::HSBtoRGBA8Batch(hues.data(), saturations.data(), brightnesses.data(), alphas.data(), hues.size(), bytes.data());
+    int mismatches = 0;
+    for(size_t i = 0; i < hues.size(); i++){
+        AuxComputations::RGBAColor expected;
+        expected.a = alphas[i];
+        //the scalar version only wraps non-negative hues
+        AuxComputations::HSBtoRGBA(((int)floorf(hues[i]) % 360 + 360) % 360, saturations[i], brightnesses[i], expected);
+        const float expectedChannels[4] = {expected.r, expected.g, expected.b, expected.a};
+        const float channels[4] = {colors[i].r, colors[i].g, colors[i].b, colors[i].a};
+        for(int c = 0; c < 4; c++){
+            const int byteError = std::abs((int)bytes[4*i + c] - (int)PackColorChannel(expectedChannels[c]));
+            if(std::fabs(channels[c] - expectedChannels[c]) > 1e-5f || byteError > 1) mismatches++;
+        }
+    }
+    check(mismatches == 0, test, std::to_string(mismatches) + " channels differ from HSBtoRGBA");
+    if(mismatches == 0) std::cout << "[PASS] " << test << std::endl;
+}
+
+int main(int argc, char** argv){
+    std::string goldenDir = "src/tests/golden";
+    bool update = false;
+    for(int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if(arg == "--golden" && i + 1 < argc) goldenDir = argv[++i];
+        else if(arg == "--update") update = true;
+    }
+
+    testFillArrayUnderrun();
+    testHSBBatch();
+    testSpectrogramLevels();
+
+    std::vector<TestSignals::Signal> signals = TestSignals::all(TEST_SIGNAL_FRAMES);
+    //a signal whose output matches silence tests nothing (e.g. impulses outside every analysis window)
+    TestSignals::Signal silence = {"silence", std::vector<float>(2 * TEST_SIGNAL_FRAMES, 0.0f)};
+    GoldenFile silenceOutput;
+    runPipeline(silence, silenceOutput);
+    for(size_t s = 0; s < signals.size(); s++){
+        const std::string test = "golden/" + signals[s].name;
+        const std::string path = goldenDir + "/" + signals[s].name + ".golden";
+        GoldenFile output;
+        runPipeline(signals[s], output);
+        std::vector<std::string> silenceErrors;
+        check(!output.compare(silenceOutput, GOLDEN_ABS_TOLERANCE, GOLDEN_REL_TOLERANCE, silenceErrors), test, 
+            "output is the same as for silence");
+
+        if(update){
+            bool written = output.write(path, "analysis pipeline output for the " + signals[s].name + 
+                " test signal, regenerate with TestRunner --update");
+            check(written, test, "could not write " + path);
+            if(written) std::cout << "[UPDATED] " << path << std::endl;
+            continue;
+        }
+        GoldenFile expected;
+        if(!expected.read(path)){
+            check(false, test, "missing golden file " + path + " (run with --update to create it)");
+            continue;
+        }
+        std::vector<std::string> errors;
+        if(output.compare(expected, GOLDEN_ABS_TOLERANCE, GOLDEN_REL_TOLERANCE, errors)){
+            std::cout << "[PASS] " << test << std::endl;
+        }
+        for(size_t e = 0; e < errors.size(); e++) check(false, test, errors[e]);
+    }
+
+    if(s_Failures > 0){
+        std::cout << s_Failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "TestSignals.h"
+
+#include <cmath>
+
+#include "../VisualizerConfig.h"
+
+//LCG instead of <random> so the noise does not depend on the standard library implementation
+static float whiteNoise(unsigned int& seed){
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 8388608.0f - 1.0f;
+}
+
+TestSignals::Signal TestSignals::sine(size_t frames){
+    Signal signal = {"sine", std::vector<float>(2 * frames)};
+    for(size_t i = 0; i < frames; i++){
+        const double t = (double)i / AUDIO_SAMPLE_RATE;
+        signal.samples[2*i] = (float)(0.5 * sin(2 * M_PI * 1000.0 * t));
+        signal.samples[2*i + 1] = (float)(0.25 * sin(2 * M_PI * 440.0 * t));
+    }
+    return signal;
+}
+
+TestSignals::Signal TestSignals::sweep(size_t frames){
+    Signal signal = {"sweep", std::vector<float>(2 * frames)};
+    const double startFreq = 20.0;
+    const double endFreq = 20000.0;
+    const double duration = (double)frames / AUDIO_SAMPLE_RATE;
+    const double k = log(endFreq / startFreq) / duration;
+    for(size_t i = 0; i < frames; i++){
+        const double t = (double)i / AUDIO_SAMPLE_RATE;
+        //phase of an exponential chirp: 2*pi*f0*(e^(kt) - 1)/k
+        const float value = (float)(0.7 * sin(2 * M_PI * startFreq * (exp(k * t) - 1.0) / k));
+        signal.samples[2*i] = value;
+        signal.samples[2*i + 1] = -value;
+    }
+    return signal;
+}
+
+TestSignals::Signal TestSignals::impulses(size_t frames){
+    Signal signal = {"impulses", std::vector<float>(2 * frames, 0.0f)};
+    //only the last ANALYSIS_WINDOW_SAMPLES of each hop are analyzed, an impulse anywhere else is never seen;
+    //the hops in between record the decay
+    const size_t hopFrames = ANALYSIS_HOP_SAMPLES / 2;
+    const size_t windowStart = (ANALYSIS_HOP_SAMPLES - ANALYSIS_WINDOW_SAMPLES) / 2;
+    for(size_t i = windowStart; i < frames; i += 3 * hopFrames){
+        signal.samples[2*i] = 1.0f;
+        signal.samples[2*i + 1] = 0.5f;
+    }
+    return signal;
+}
+
+TestSignals::Signal TestSignals::pinkNoise(size_t frames){
+    Signal signal = {"pink_noise", std::vector<float>(2 * frames)};
+    for(int channel = 0; channel < 2; channel++){
+        unsigned int seed = 2024 + channel;
+        float b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0;
+        for(size_t i = 0; i < frames; i++){
+            const float white = whiteNoise(seed);
+            b0 = 0.99886f * b0 + white * 0.0555179f;
+            b1 = 0.99332f * b1 + white * 0.0750759f;
+            b2 = 0.96900f * b2 + white * 0.1538520f;
+            b3 = 0.86650f * b3 + white * 0.3104856f;
+            b4 = 0.55000f * b4 + white * 0.5329522f;
+            b5 = -0.7616f * b5 - white * 0.0168980f;
+            const float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
+            b6 = white * 0.115926f;
+            signal.samples[2*i + channel] = 0.05f * pink;
+        }
+    }
+    return signal;
+}
+
+std::vector<TestSignals::Signal> TestSignals::all(size_t frames){
+    std::vector<Signal> signals;
+    signals.push_back(sine(frames));
+    signals.push_back(sweep(frames));
+    signals.push_back(impulses(frames));
+    signals.push_back(pinkNoise(frames));
+    return signals;
+}
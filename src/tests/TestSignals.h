@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//deterministic stereo test signals (interleaved, AUDIO_SAMPLE_RATE), identical on every run and platform
+namespace TestSignals{
+    typedef struct{
+        std::string name;
+        std::vector<float> samples;
+    } Signal;
+
+    //left: 0.5 * 1 kHz, right: 0.25 * 440 Hz
+    Signal sine(size_t frames);
+    //logarithmic sweep from 20 Hz to 20 kHz, right channel inverted
+    Signal sweep(size_t frames);
+    //unit impulses every third hop (left 1.0, right 0.5), on the first frame of the hop's analysis window
+    Signal impulses(size_t frames);
+    //pink noise (Paul Kellet's filter over a fixed-seed LCG), independent channels
+    Signal pinkNoise(size_t frames);
+
+    std::vector<Signal> all(size_t frames);
+}